@@ -24,19 +24,39 @@
 #include <bitcoin/blockchain/settings.hpp>
 #include <bitcoin/blockchain/version.hpp>
 #include <bitcoin/blockchain/interface/block_chain.hpp>
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
+#include <bitcoin/blockchain/interface/histogram.hpp>
+#include <bitcoin/blockchain/interface/memory_advisor.hpp>
+#include <bitcoin/blockchain/interface/publication.hpp>
+#include <bitcoin/blockchain/interface/relay_cache.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
+#include <bitcoin/blockchain/interface/stealth_index.hpp>
+#include <bitcoin/blockchain/pools/arena.hpp>
 #include <bitcoin/blockchain/pools/block_entry.hpp>
 #include <bitcoin/blockchain/pools/block_organizer.hpp>
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/notification_queue.hpp>
+#include <bitcoin/blockchain/pools/orphan_block_pool.hpp>
+#include <bitcoin/blockchain/pools/orphan_pool.hpp>
+#include <bitcoin/blockchain/pools/prioritized_mutex.hpp>
+#include <bitcoin/blockchain/pools/rolling_filter.hpp>
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
 #include <bitcoin/blockchain/pools/transaction_entry.hpp>
 #include <bitcoin/blockchain/pools/transaction_organizer.hpp>
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/populate/chain_snapshot.hpp>
+#include <bitcoin/blockchain/populate/header_cache.hpp>
+#include <bitcoin/blockchain/populate/header_index.hpp>
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
 #include <bitcoin/blockchain/populate/populate_base.hpp>
 #include <bitcoin/blockchain/populate/populate_block.hpp>
 #include <bitcoin/blockchain/populate/populate_chain_state.hpp>
 #include <bitcoin/blockchain/populate/populate_transaction.hpp>
+#include <bitcoin/blockchain/populate/unspent_filter.hpp>
+#include <bitcoin/blockchain/populate/utxo_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_block.hpp>
 #include <bitcoin/blockchain/validate/validate_input.hpp>
 #include <bitcoin/blockchain/validate/validate_transaction.hpp>
@@ -20,18 +20,35 @@
 #define LIBBITCOIN_BLOCKCHAIN_BLOCK_CHAIN_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include <bitcoin/database.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
+#include <bitcoin/blockchain/interface/memory_advisor.hpp>
+#include <bitcoin/blockchain/interface/publication.hpp>
+#include <bitcoin/blockchain/interface/relay_cache.hpp>
+#include <bitcoin/blockchain/interface/stealth_index.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
 #include <bitcoin/blockchain/pools/block_organizer.hpp>
+#include <bitcoin/blockchain/pools/prioritized_mutex.hpp>
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
 #include <bitcoin/blockchain/pools/transaction_organizer.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/populate/chain_snapshot.hpp>
+#include <bitcoin/blockchain/populate/header_cache.hpp>
+#include <bitcoin/blockchain/populate/header_index.hpp>
+#include <bitcoin/blockchain/populate/unspent_filter.hpp>
+#include <bitcoin/blockchain/populate/utxo_cache.hpp>
 #include <bitcoin/blockchain/populate/populate_chain_state.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 
 #if WITH_BLOCKCHAIN_REQUESTER
 #include <bitcoin/protocol/requester.hpp>
@@ -45,9 +62,9 @@ class BCB_API block_chain
   : public safe_chain, public fast_chain, noncopyable
 {
 public:
-    /// Relay transactions is network setting that is passed through to block
-    /// population as an optimization. This can be removed once there is an
-    /// in-memory cache of tx pool metadata, as the costly query will go away.
+    /// Relay transactions is a network setting that was passed through to
+    /// block population as an optimization. Population now uses the in-memory
+    /// tx pool index, so this is retained only for interface compatibility.
     block_chain(threadpool& pool,
         const blockchain::settings& chain_settings,
         const database::settings& database_settings,
@@ -100,6 +117,10 @@ public:
         bool& out_coinbase, const chain::output_point& outpoint,
         size_t branch_height, bool require_confirmed) const;
 
+    /// Get the outputs referenced by the outpoints of the batch.
+    void get_outputs(output_queries& queries, size_t branch_height,
+        bool require_confirmed) const;
+
     bool get_output_is_confirmed(chain::output& out_output, size_t& out_height,
         bool& out_coinbase, bool& out_is_confirmed, const chain::output_point& outpoint,
         size_t branch_height, bool require_confirmed) const;
@@ -121,13 +142,17 @@ public:
     // Thread safe, insert does not set sequential lock.
 
     /// Create flush lock if flush_writes is true, and set sequential lock.
+    /// Defers the work index and header cache until end_insert (bulk sync).
     bool begin_insert() const;
 
     /// Clear flush lock if flush_writes is true, and clear sequential lock.
+    /// Rebuilds the work index and header cache in one pass from the store.
     bool end_insert() const;
 
     /// Insert a block to the blockchain, height is checked for existence.
     /// Reads and reorgs are undefined when chain is gapped.
+    /// Between begin_insert and end_insert blocks may be inserted out of
+    /// order and concurrently, as only the store is written.
     bool insert(block_const_ptr block, size_t height);
 
     /// Push an unconfirmed transaction to the tx table and index outputs.
@@ -158,6 +183,12 @@ public:
     // Thread safe except start.
 
     /// Start the block pool and the transaction pool.
+    /// A read-only chain (settings) starts no pools and serves the store up
+    /// to the top published by its writer, each read sequenced by the
+    /// publication. The store is opened by the database as for a writer, so
+    /// it takes the store lock and flushes on close. A read-only chain
+    /// therefore cannot share the files of a running writer until the
+    /// database provides a read-only open.
     bool start();
 
     /// Signal pool work stop, speeds shutdown with multiple threads.
@@ -179,6 +210,14 @@ public:
     void fetch_block(const hash_digest& hash,
         block_fetch_handler handler) const;
 
+    /// fetch a serialized block by height.
+    void fetch_block_data(size_t height,
+        block_data_fetch_handler handler) const;
+
+    /// fetch a serialized block by hash.
+    void fetch_block_data(const hash_digest& hash,
+        block_data_fetch_handler handler) const;
+
     /// fetch block header by height.
     // virtual      // OLD previo a merge de Feb2017 
     void fetch_block_header(size_t height, block_header_fetch_handler handler) const;
@@ -217,6 +256,10 @@ public:
     void fetch_transaction(const hash_digest& hash, bool require_confirmed,
         transaction_fetch_handler handler) const;
 
+    /// fetch serialized transaction by hash.
+    void fetch_transaction_data(const hash_digest& hash,
+        bool require_confirmed, transaction_data_fetch_handler handler) const;
+
     /// Generate fees for mining
     std::pair<bool, uint64_t> total_input_value(libbitcoin::chain::transaction const& tx) const;
     std::pair<bool, uint64_t> fees(libbitcoin::chain::transaction const& tx) const;
@@ -230,7 +273,9 @@ public:
     std::vector<tx_mempool> fetch_mempool_all(size_t max_bytes) const;
     std::pair<bool, size_t> is_double_spent_and_sigops(chain::transaction const& tx, bool bip16_active) const;
     std::tuple<bool, size_t, uint64_t> is_double_spent_sigops_and_fees(chain::transaction const& tx, bool bip16_active) const;
-    std::tuple<bool, size_t, uint64_t> validate_tx_2(chain::transaction const& tx, size_t height) const;
+    std::tuple<bool, size_t, uint64_t, size_t> validate_tx_2(chain::transaction const& tx, size_t height) const;
+    bool is_final_standard(chain::transaction const& tx, size_t height) const;
+    bool is_confirmed_spend(chain::transaction const& tx) const;
 
     /// fetch position and height within block of transaction by hash.
     void fetch_transaction_position(const hash_digest& hash,
@@ -248,6 +293,12 @@ public:
     void fetch_history(const wallet::payment_address& address,
         size_t limit, size_t from_height, history_fetch_handler handler) const;
 
+    /// fetch the history for an address in pages, read ahead under sequence
+    /// checks, until the handler returns false or a short page.
+    void fetch_history(const wallet::payment_address& address,
+        size_t page_size, const history_cursor& cursor,
+        history_page_handler handler) const;
+
     /// fetch stealth results.
     void fetch_stealth(const binary& filter, size_t from_height,
         stealth_fetch_handler handler) const;
@@ -304,12 +355,28 @@ public:
     /// Store a transaction to the pool if valid.
     void organize(transaction_const_ptr tx, result_handler handler);
 
+    /// Validate a block without organizing it (shared, no store write).
+    void validate_only(block_const_ptr block, result_handler handler) const;
+
+    /// Validate a transaction without storing it (shared, no store write).
+    void validate_only(transaction_const_ptr tx,
+        result_handler handler) const;
+
     // Properties.
     //-------------------------------------------------------------------------
 
     /// Get a reference to the blockchain configuration settings.
     const settings& chain_settings() const;
 
+    /// The number of reads repeated due to a concurrent write.
+    size_t read_retries() const;
+
+    /// The number of read retries that blocked on write completion.
+    size_t read_waits() const;
+
+    /// Validation stage, cache and read statistics (lock free).
+    chain_metrics& metrics() const;
+
 protected:
 
     /// Determine if work should terminate early with service stopped code.
@@ -331,37 +398,132 @@ private:
     template <typename Reader>
     void read_serial(const Reader& reader) const;
 
+    handle begin_read() const;
+    bool is_write_locked(handle sequence) const;
+    bool is_read_valid(handle sequence) const;
+    handle read_publication(config::checkpoint& out_top) const;
+    bool is_published(size_t height) const;
+    bool is_published(const database::transaction_result& result) const;
+    bool get_published_height(size_t& out_height,
+        const hash_digest& block_hash) const;
+
     template <typename Handler, typename... Args>
     bool finish_read(handle sequence, Handler handler, Args... args) const;
 
+    template <typename Select, typename Exists>
+    void filter_inventories(message::inventory_vector::list& inventories,
+        const Select& select, const Exists& exists) const;
+
+    void wait_write(size_t epoch) const;
+    void notify_write() const;
+    void begin_commit() const;
+    void end_commit() const;
+    void wait_commits() const;
+
+    template <typename Key>
+    relay_cache::entry::ptr read_relay(const Key& key,
+        size_t generation) const;
+
     // Utilities.
     //-------------------------------------------------------------------------
 
     static hash_list to_hashes(const database::block_result& result);
-
+    bool to_transactions(chain::transaction::list& out_transactions,
+        const database::block_result& result) const;
+    data_const_ptr to_data(const database::block_result& result) const;
+    relay_cache::entry::ptr to_relay(
+        const database::block_result& result) const;
+    relay_cache::entry::ptr get_relay(size_t height) const;
+    relay_cache::entry::ptr get_relay(const hash_digest& hash) const;
+    code read_anchor(history_cursor& cursor) const;
+    code read_history(chain::history_compact::list& out_rows,
+        bool& out_complete, history_cursor& cursor, const short_hash& key,
+        size_t count) const;
+    bool scan_stealth(chain::stealth_compact::list& out_rows,
+        const binary& filter, size_t from_height) const;
+
+    chain::chain_state::ptr pool_state() const;
     code set_chain_state(chain::chain_state::ptr previous);
+    void populate_transaction_pool();
+    void populate_unspent_filter();
     void handle_transaction(const code& ec, transaction_const_ptr tx,
         result_handler handler) const;
     void handle_block(const code& ec, block_const_ptr block,
         result_handler handler) const;
-    void handle_reorganize(const code& ec, block_const_ptr top,
-        result_handler handler);
+    void handle_reorganize(const code& ec, size_t fork_height,
+        block_const_ptr_list_const_ptr incoming, result_handler handler);
+    void populate_header_cache() const;
+    void populate_header_index() const;
+    bool get_top(config::checkpoint& out_top) const;
+    bool restore_snapshot();
+    void save_snapshot();
+    void begin_publish() const;
+    void publish_top() const;
+    void refresh_publication() const;
+    void reindex() const;
+    void index_work() const;
+    void index_work(size_t fork_height,
+        block_const_ptr_list_const_ptr incoming);
+    void sample_memory() const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     const settings& settings_;
     asio::duration spin_lock_sleep_;
+    mutable std::atomic<size_t> write_epoch_;
+    mutable std::atomic<size_t> read_retries_;
+    mutable std::atomic<size_t> read_waits_;
+    mutable std::atomic<bool> deferred_;
+    mutable std::mutex write_mutex_;
+    mutable size_t commits_;
+    mutable std::condition_variable write_condition_;
     const populate_chain_state chain_state_populator_;
     database::data_base database_;
 
-    // This is protected by mutex.
-    chain::chain_state::ptr pool_state_;
+    // This is protected by mutex (refreshed by a read-only chain).
+    mutable chain::chain_state::ptr pool_state_;
     mutable shared_mutex pool_state_mutex_;
 
     // These are thread safe.
-    mutable shared_mutex mutex_;
-    mutable threadpool priority_pool_;
-    mutable dispatcher dispatch_;
+    mutable header_cache header_cache_;
+    mutable header_index header_index_;
+    mutable relay_cache relay_cache_;
+    mutable stealth_index stealth_index_;
+    mutable utxo_cache utxo_cache_;
+    mutable unspent_filter unspent_filter_;
+
+    // This is protected by mutex (cumulative work by height).
+    mutable std::vector<uint256_t> work_;
+    mutable shared_mutex work_mutex_;
+
+    // This is not thread safe, used only in start and close.
+    const chain_snapshot snapshot_;
+
+    // The advisor is thread safe, the sample is used only by the writer.
+    const memory_advisor memory_advisor_;
+    mutable memory_advisor::usage memory_usage_;
+
+    // The file is written by the writer and read by read-only chains.
+    const publication publication_;
+
+    // These are protected by mutex (the publication of the writer).
+    mutable config::checkpoint publication_top_;
+    mutable uint64_t publication_sequence_;
+    mutable size_t publication_writers_;
+    mutable std::mutex publication_write_mutex_;
+
+    // These are protected by mutex (the top followed by a read-only chain).
+    mutable config::checkpoint published_;
+    mutable asio::time_point published_time_;
+    mutable std::atomic<size_t> published_height_;
+    mutable shared_mutex publication_mutex_;
+
+    // These are thread safe.
+    mutable prioritized_mutex mutex_;
+    mutable stage_pools pools_;
+    transaction_pool transaction_pool_;
+    script_cache script_cache_;
+    mutable chain_metrics metrics_;
     transaction_organizer transaction_organizer_;
     block_organizer block_organizer_;
 #endif
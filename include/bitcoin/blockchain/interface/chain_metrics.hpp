@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_CHAIN_METRICS_HPP
+#define LIBBITCOIN_BLOCKCHAIN_CHAIN_METRICS_HPP
+
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/interface/histogram.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe (lock free).
+/// Aggregate statistics of block validation, store reads and process memory,
+/// so that they can be polled for monitoring without parsing the debug log.
+class BCB_API chain_metrics
+{
+public:
+    /// Block stage latencies (microseconds).
+    histogram check;
+    histogram populate;
+    histogram accept;
+    histogram connect;
+    histogram store;
+    histogram notify;
+
+    /// Input count of each validated block.
+    histogram inputs;
+
+    /// Script cache hit rate of each connected block (percent).
+    histogram cache_hits;
+
+    /// Attempts of each serialized store read (one unless write collision).
+    histogram read_attempts;
+
+    /// Organizer lock acquisition latency by class (microseconds).
+    histogram block_lock;
+    histogram transaction_lock;
+
+    /// Resident size of the process after each block write (megabytes).
+    histogram resident;
+
+    /// Page faults of the process since the previous block write.
+    histogram minor_faults;
+    histogram major_faults;
+
+    /// Zeroize all histograms.
+    void reset();
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
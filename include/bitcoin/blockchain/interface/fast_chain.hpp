@@ -20,6 +20,7 @@
 #define LIBBITCOIN_BLOCKCHAIN_FAST_CHAIN_HPP
 
 #include <cstddef>
+#include <vector>
 #include <bitcoin/database.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
@@ -37,6 +38,18 @@ public:
     // This avoids conflict with the result_handler in safe_chain.
     typedef handle0 complete_handler;
 
+    /// A prevout query of a batch, the outpoint is owned by the caller.
+    struct output_query
+    {
+        const chain::output_point* outpoint;
+        chain::output output;
+        size_t height;
+        bool coinbase;
+        bool found;
+    };
+
+    typedef std::vector<output_query> output_queries;
+
     // Readers.
     // ------------------------------------------------------------------------
 
@@ -82,6 +95,11 @@ public:
         bool& out_coinbase, const chain::output_point& outpoint,
         size_t branch_height, bool require_confirmed) const = 0;
 
+    /// Get the outputs referenced by the outpoints of the batch (as above).
+    /// A remote store resolves the batch in one request, not one per query.
+    virtual void get_outputs(output_queries& queries, size_t branch_height,
+        bool require_confirmed) const = 0;
+
     /// Determine if an unspent transaction exists with the given hash.
     virtual bool get_is_unspent_transaction(const hash_digest& hash,
         size_t branch_height, bool require_confirmed) const = 0;
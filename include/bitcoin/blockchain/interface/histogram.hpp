@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_HISTOGRAM_HPP
+#define LIBBITCOIN_BLOCKCHAIN_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe (lock free).
+/// A histogram of power of two buckets, where bucket n counts the values in
+/// [2^(n-1), 2^n), bucket zero counts zero, and the last bucket is unbounded.
+class BCB_API histogram
+{
+public:
+    static const size_t buckets = 32;
+    typedef std::array<uint64_t, buckets> counts;
+
+    /// A copy of the histogram, not atomic across its members.
+    struct values
+    {
+        uint64_t count;
+        uint64_t sum;
+        uint64_t maximum;
+        counts distribution;
+
+        /// The upper bound of the bucket containing the ratio (0..1) rank.
+        uint64_t percentile(double ratio) const;
+    };
+
+    histogram();
+
+    /// Record a value.
+    void record(uint64_t value);
+
+    /// Record the microseconds elapsed from start to end (zero if negative).
+    void record(const asio::time_point& start, const asio::time_point& end);
+
+    /// Get a copy of the current values.
+    values get() const;
+
+    /// Zeroize all values.
+    void reset();
+
+private:
+    static size_t bucket(uint64_t value);
+
+    std::array<std::atomic<uint64_t>, buckets> counts_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> maximum_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_MEMORY_ADVISOR_HPP
+#define LIBBITCOIN_BLOCKCHAIN_MEMORY_ADVISOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/settings.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Memory controls over the memory-mapped store of this process. The store
+/// mappings are found by file path, so that the kernel can be advised of the
+/// access pattern, the recent region of the transaction table can be read
+/// ahead at start, and the store can be paged out when its own resident size
+/// exceeds a budget. Memory advice is supported on Linux only.
+class BCB_API memory_advisor
+  : noncopyable
+{
+public:
+    /// The expected pattern of store access.
+    enum class access
+    {
+        /// The kernel default read-ahead.
+        normal,
+
+        /// Prevout lookup (validation), read-ahead is wasted.
+        random,
+
+        /// Block serving (initial sync of peers), read-ahead is aggressive.
+        sequential
+    };
+
+    /// A sample of the memory usage of this process.
+    struct usage
+    {
+        uint64_t resident_bytes;
+        uint64_t minor_faults;
+        uint64_t major_faults;
+    };
+
+    /// Parse "normal", "random" or "sequential", false if invalid.
+    static bool to_access(access& out, const std::string& text);
+
+    /// Sample the memory usage of this process, false if not supported.
+    static bool sample(usage& out);
+
+    /// Construct the advisor, log and ignore an invalid access setting.
+    memory_advisor(const boost::filesystem::path& directory,
+        const settings& settings);
+
+    /// Apply the access advice to the store mappings.
+    bool advise() const;
+
+    /// Read ahead the recent region of the transaction table.
+    bool prefault() const;
+
+    /// The resident size of the store mappings, false if not supported.
+    bool resident(uint64_t& out_bytes) const;
+
+    /// If the resident size of the store mappings exceeds the budget, page
+    /// out the largest until within three quarters of it. This is checked at
+    /// most once per interval. Returns false if nothing is paged out, else
+    /// the resident size of the store before the page out.
+    bool enforce(uint64_t& out_resident_bytes) const;
+
+private:
+    struct region
+    {
+        uint8_t* begin;
+        size_t size;
+        uint64_t resident;
+    };
+
+    typedef std::vector<region> regions;
+
+    bool read_regions(regions& out) const;
+
+    // These are thread safe.
+    const boost::filesystem::path directory_;
+    const uint64_t budget_;
+    const uint64_t prefault_;
+    access access_;
+
+    // This is protected by mutex (enforcement is rate limited).
+    mutable asio::time_point checked_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
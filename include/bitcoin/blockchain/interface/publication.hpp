@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_PUBLICATION_HPP
+#define LIBBITCOIN_BLOCKCHAIN_PUBLICATION_HPP
+
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is not thread safe.
+/// A file that stamps the top block committed by the writer of a store, so
+/// that read-only chains over the same store serve only committed blocks.
+/// The sequence is odd while the store is written above the published top
+/// and even once the new top is published. A read of the store is valid if
+/// the sequence is even and unchanged across the read (sequence lock).
+class BCB_API publication
+{
+public:
+    /// An empty path disables the publication.
+    publication(const boost::filesystem::path& file);
+
+    /// Replace the published top and sequence, false if not written.
+    bool publish(const config::checkpoint& top, uint64_t sequence) const;
+
+    /// Read the published top and sequence, false if not published.
+    bool read(config::checkpoint& out_top, uint64_t& out_sequence) const;
+
+private:
+    const boost::filesystem::path file_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_RELAY_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_RELAY_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded LRU of the relay artifacts of recently requested confirmed
+/// blocks, so that merkle and compact block responses to many peers do not
+/// rederive the tx hashes and short ids of the same block for each peer.
+class BCB_API relay_cache
+{
+public:
+    struct entry
+    {
+        typedef std::shared_ptr<const entry> ptr;
+
+        chain::header header;
+        hash_digest hash;
+        size_t height;
+        hash_list hashes;
+
+        /// BIP152 short ids of the non-coinbase txs, keyed by the nonce.
+        uint64_t nonce;
+        message::compact_block::short_id_list short_ids;
+
+        /// The coinbase, prefilled as the peer cannot have it.
+        message::prefilled_transaction::list prefilled;
+    };
+
+    /// Derive the BIP152 short ids of the hashes for the header and nonce.
+    static message::compact_block::short_id_list to_short_ids(
+        const chain::header& header, uint64_t nonce,
+        hash_list::const_iterator begin, hash_list::const_iterator end);
+
+    /// A limit of zero disables the cache.
+    relay_cache(size_t limit);
+
+    /// The number of cached blocks.
+    size_t size() const;
+
+    /// The invalidation generation, capture before reading the store.
+    size_t generation() const;
+
+    /// Cache the artifacts unless invalidated since the generation.
+    void add(entry::ptr value, size_t generation);
+
+    /// Get the artifacts of the block hash (promoted), null if not cached.
+    entry::ptr find(const hash_digest& hash);
+
+    /// Discard the blocks above the height and invalidate the generation.
+    /// Call before and again after a reorganization is written.
+    void pop_above(size_t height);
+
+protected:
+    typedef std::list<entry::ptr> order;
+    typedef std::unordered_map<hash_digest, order::iterator> entries;
+
+    // This is thread safe.
+    const size_t limit_;
+
+    // These are guarded by the mutex, order is most recent first.
+    order order_;
+    entries entries_;
+    size_t generation_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -38,6 +38,23 @@ class BCB_API safe_chain
 public:
     typedef handle0 result_handler;
 
+    /// A resumable position in the (newest first) history of an address.
+    /// Rows confirmed above the anchor after the first page are skipped.
+    struct history_cursor
+    {
+        /// The lower height bound of the query.
+        size_t from_height = 0;
+
+        /// The number of rows at or below the anchor already delivered.
+        size_t delivered = 0;
+
+        /// The number of rows above the anchor as of the last read.
+        size_t newer = 0;
+
+        /// The chain top as of the first page (null to begin).
+        config::checkpoint anchor;
+    };
+
     /// Object fetch handlers.
     typedef handle1<size_t> last_height_fetch_handler;
     typedef handle1<size_t> block_height_fetch_handler;
@@ -47,6 +64,14 @@ public:
     typedef handle1<chain::stealth_compact::list> stealth_fetch_handler;
     typedef handle2<size_t, size_t> transaction_index_fetch_handler;
 
+    /// Serialized (wire) object fetch handlers, for relay without building
+    /// messages. The store holds no wire image, so each is reserialized.
+    typedef std::shared_ptr<const data_chunk> data_const_ptr;
+    typedef std::function<void(const code&, data_const_ptr, size_t)>
+        block_data_fetch_handler;
+    typedef std::function<void(const code&, data_const_ptr, size_t, size_t)>
+        transaction_data_fetch_handler;
+
     // Smart pointer parameters must not be passed by reference.
     typedef std::function<void(const code&, block_ptr, size_t)>
         block_fetch_handler;
@@ -71,6 +96,11 @@ public:
     typedef std::function<bool(code, transaction_const_ptr)>
         transaction_handler;
 
+    /// Page handler, return false to stop (resumable from the cursor).
+    typedef std::function<bool(const code&,
+        const chain::history_compact::list&, const history_cursor&)>
+        history_page_handler;
+
     // Startup and shutdown.
     // ------------------------------------------------------------------------
 
@@ -87,6 +117,12 @@ public:
     virtual void fetch_block(const hash_digest& hash,
         block_fetch_handler handler) const = 0;
 
+    virtual void fetch_block_data(size_t height,
+        block_data_fetch_handler handler) const = 0;
+
+    virtual void fetch_block_data(const hash_digest& hash,
+        block_data_fetch_handler handler) const = 0;
+
     virtual void fetch_block_header(size_t height,
         block_header_fetch_handler handler) const = 0;
 
@@ -117,6 +153,10 @@ public:
     virtual void fetch_transaction(const hash_digest& hash,
         bool require_confirmed, transaction_fetch_handler handler) const = 0;
 
+    virtual void fetch_transaction_data(const hash_digest& hash,
+        bool require_confirmed,
+        transaction_data_fetch_handler handler) const = 0;
+
     virtual void fetch_transaction_position(const hash_digest& hash,
         bool require_confirmed,
         transaction_index_fetch_handler handler) const = 0;
@@ -131,6 +171,10 @@ public:
         size_t limit, size_t from_height,
         history_fetch_handler handler) const = 0;
 
+    virtual void fetch_history(const wallet::payment_address& address,
+        size_t page_size, const history_cursor& cursor,
+        history_page_handler handler) const = 0;
+
     virtual void fetch_stealth(const binary& filter, size_t from_height,
         stealth_fetch_handler handler) const = 0;
 
@@ -172,6 +216,11 @@ public:
 
     virtual void organize(block_const_ptr block, result_handler handler) = 0;
     virtual void organize(transaction_const_ptr tx, result_handler handler) = 0;
+
+    virtual void validate_only(block_const_ptr block,
+        result_handler handler) const = 0;
+    virtual void validate_only(transaction_const_ptr tx,
+        result_handler handler) const = 0;
 };
 
 } // namespace blockchain
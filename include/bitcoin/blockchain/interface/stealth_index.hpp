@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_STEALTH_INDEX_HPP
+#define LIBBITCOIN_BLOCKCHAIN_STEALTH_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// An in-memory index of the stealth rows of the most recent blocks, bucketed
+/// by the leading bits of the stealth prefix. A filter of at least the bucket
+/// bits is answered from one bucket, a shorter filter spans a bucket range
+/// which may be scanned in chunks. Heights from the floor to the top of the
+/// indexed blocks are covered, other queries must be answered by the store.
+class BCB_API stealth_index
+{
+public:
+    typedef std::pair<size_t, size_t> range;
+
+    /// The number of leading prefix bits that select a bucket.
+    static const size_t bucket_bits = 12;
+
+    /// The bucket range [first, last) that may contain matches of the filter.
+    static range buckets(const binary& filter);
+
+    /// A depth of zero disables the index.
+    stealth_index(size_t depth);
+
+    /// The number of indexed rows.
+    size_t size() const;
+
+    /// Index the rows of the block, a gap in height restarts the index.
+    void push(const chain::block& block, size_t height);
+
+    /// Discard the rows above the height (reorganization).
+    void pop_above(size_t height);
+
+    /// Discard all rows, no height is covered until the next push.
+    void clear();
+
+    /// Append the rows of the bucket range that match the filter at or above
+    /// the height, in bucket order. False if the height is not covered.
+    bool scan(chain::stealth_compact::list& out, const binary& filter,
+        size_t from_height, const range& buckets) const;
+
+    /// As above, with the range scanned in chunks on the dispatcher under one
+    /// read of the index. The calling thread scans any chunk not yet taken,
+    /// so this may be called from a thread of the dispatcher.
+    bool scan(chain::stealth_compact::list& out, const binary& filter,
+        size_t from_height, const range& buckets, dispatcher& dispatch,
+        size_t chunks) const;
+
+protected:
+    struct row
+    {
+        uint32_t prefix;
+        size_t height;
+        chain::stealth_compact value;
+    };
+
+    typedef std::vector<row> bucket;
+
+    static size_t to_bucket(uint32_t prefix);
+    void append(chain::stealth_compact::list& out, const binary& filter,
+        size_t from_height, const range& buckets) const;
+    void reset();
+
+    // This is thread safe.
+    const size_t depth_;
+
+    // These are guarded by the mutex, each bucket is in height order.
+    std::vector<bucket> buckets_;
+    size_t floor_;
+    size_t top_;
+    size_t size_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
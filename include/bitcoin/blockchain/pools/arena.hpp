@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_ARENA_HPP
+#define LIBBITCOIN_BLOCKCHAIN_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is not thread safe.
+/// A monotonic allocator for validation-scoped data. Allocations are carved
+/// from large chunks and are never individually freed, all memory is released
+/// in one step when the arena is released or destroyed.
+class BCB_API arena
+  : noncopyable
+{
+public:
+    /// Allocations larger than the chunk size are given their own chunk.
+    arena(size_t chunk_size=64 * 1024);
+
+    /// Allocate size bytes aligned to alignment (a power of two).
+    void* allocate(size_t size, size_t alignment);
+
+    /// The number of bytes reserved from the heap.
+    size_t reserved() const;
+
+    /// Release all allocations.
+    void release();
+
+private:
+    typedef std::unique_ptr<uint8_t[]> chunk;
+
+    const size_t chunk_size_;
+    std::vector<chunk> chunks_;
+    size_t reserved_;
+    uint8_t* position_;
+    size_t remaining_;
+};
+
+/// A standard allocator over an arena, deallocation is deferred to the arena.
+template <typename Type>
+class arena_allocator
+{
+public:
+    typedef Type value_type;
+
+    template <typename Other>
+    struct rebind
+    {
+        typedef arena_allocator<Other> other;
+    };
+
+    arena_allocator(arena& source)
+      : arena_(&source)
+    {
+    }
+
+    template <typename Other>
+    arena_allocator(const arena_allocator<Other>& other)
+      : arena_(other.arena_)
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        return static_cast<Type*>(arena_->allocate(count * sizeof(Type),
+            alignof(Type)));
+    }
+
+    void deallocate(Type*, size_t)
+    {
+    }
+
+    template <typename Other>
+    bool operator==(const arena_allocator<Other>& other) const
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <typename Other>
+    bool operator!=(const arena_allocator<Other>& other) const
+    {
+        return arena_ != other.arena_;
+    }
+
+private:
+    template <typename Other>
+    friend class arena_allocator;
+
+    arena* arena_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -25,11 +25,18 @@
 #include <memory>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/notification_queue.hpp>
+#include <bitcoin/blockchain/pools/orphan_block_pool.hpp>
+#include <bitcoin/blockchain/pools/prioritized_mutex.hpp>
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_block.hpp>
 
 namespace libbitcoin {
@@ -47,9 +54,10 @@ public:
         block_const_ptr_list_const_ptr> reorganize_subscriber;
 
     /// Construct an instance.
-    block_organizer(shared_mutex& mutex, dispatcher& dispatch,
-        threadpool& thread_pool, fast_chain& chain, const settings& settings,
-        bool relay_transactions);
+    block_organizer(prioritized_mutex& mutex, stage_pools& pools,
+        threadpool& thread_pool, fast_chain& chain, transaction_pool& pool,
+        script_cache& cache, chain_metrics& metrics,
+        const settings& settings);
 
     bool start();
     bool stop();
@@ -57,15 +65,54 @@ public:
     void organize(block_const_ptr block, result_handler handler);
     void subscribe_reorganize(reorganize_handler&& handler);
 
-    /// Remove all message vectors that match block hashes.
+    /// Validate the block on the chain or pool in the shared critical section.
+    /// The block is not pooled or stored, concurrent with tx validation.
+    void validate_only(block_const_ptr block, result_handler handler) const;
+
+    /// Remove all message vectors that match pooled or orphan block hashes.
     void filter(get_data_ptr message) const;
 
 protected:
     bool stopped() const;
 
 private:
+    // A store write that has been started but not yet settled into the pools.
+    struct commit
+    {
+        typedef std::shared_ptr<commit> ptr;
+
+        branch::const_ptr branch;
+        block_const_ptr_list_ptr outgoing;
+        std::shared_future<code> result;
+        bool settled;
+    };
+
+    // A reorganization that has been committed but not yet notified.
+    struct reorganization
+    {
+        size_t fork_height;
+        block_const_ptr_list_const_ptr incoming;
+        block_const_ptr_list_const_ptr outgoing;
+    };
+
+    typedef notification_queue<reorganization> reorganize_queue;
+
+    // Organize sequence.
+    code organize_buffered(block_const_ptr block);
+    void buffer_orphan(block_const_ptr block);
+    void organize_block(block_const_ptr block, result_handler handler);
+    void resubmit(block_const_ptr parent);
+
     // Utility.
-    bool set_branch_height(branch::ptr branch);
+    static bool is_parent(const code& ec, block_const_ptr block);
+    bool set_branch_height(branch::ptr branch) const;
+    bool extends_pending(block_const_ptr block) const;
+    void prefix_pending(branch::ptr branch) const;
+
+    // Pipelined commit sequence.
+    void commit_branch(result_handler handler);
+    code settle_pending();
+    void settle(commit::ptr pending, const code& ec);
 
     // Verify sub-sequence.
     void handle_accept(const code& ec, branch::ptr branch, result_handler handler);
@@ -79,18 +126,29 @@ private:
     void notify_reorganize(size_t branch_height,
         block_const_ptr_list_const_ptr branch,
         block_const_ptr_list_const_ptr original);
+    void deliver_reorganize(reorganization& event);
+    static bool coalesce_reorganize(reorganization& last,
+        const reorganization& next);
 
-    // This must be protected by the implementation.
+    // These must be protected by the implementation.
     fast_chain& fast_chain_;
+    commit::ptr pending_;
+    branch::ptr connected_;
+    bool speculative_;
 
     // These are thread safe.
-    shared_mutex& mutex_;
+    prioritized_mutex& mutex_;
     std::atomic<bool> stopped_;
+    const bool pipelined_;
     std::promise<code> resume_;
-    dispatcher& dispatch_;
+    dispatcher& store_dispatch_;
     block_pool block_pool_;
+    orphan_block_pool orphans_;
+    transaction_pool& transaction_pool_;
+    chain_metrics& metrics_;
     validate_block validator_;
     reorganize_subscriber::ptr subscriber_;
+    reorganize_queue::ptr notifications_;
 };
 
 } // namespace blockchain
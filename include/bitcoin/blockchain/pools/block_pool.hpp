@@ -20,12 +20,12 @@
 #define LIBBITCOIN_BLOCKCHAIN_BLOCK_POOL_HPP
 
 #include <cstddef>
-#include <boost/bimap.hpp>
-#include <boost/bimap/multiset_of.hpp>
-#include <boost/bimap/unordered_set_of.hpp>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
-#include <bitcoin/blockchain/pools/block_entry.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
 
 namespace libbitcoin {
@@ -63,22 +63,39 @@ public:
     branch::ptr get_path(block_const_ptr candidate_block) const;
 
 protected:
-    // A bidirectional map is used for efficient block and position retrieval.
-    // This produces the effect of a circular buffer hash table of blocks.
-    typedef boost::bimaps::bimap<
-        boost::bimaps::unordered_set_of<block_entry>,
-        boost::bimaps::multiset_of<size_t>> block_entries;
-
-    void prune(const hash_list& hashes, size_t minimum_height);
+    struct node;
+    typedef std::vector<node*> node_list;
+
+    // A pool entry links directly to its parent (nullptr for a root) and to
+    // its children, so the tree is walked without hash table lookups.
+    struct node
+    {
+        block_const_ptr block;
+        node* parent;
+        node_list children;
+    };
+
+    // Node addresses are stable across rehashing, so links remain valid until
+    // the linked node is erased.
+    typedef std::unordered_map<hash_digest, node> nodes;
+
+    // Roots are bucketed by height, so expired trees are found at the front.
+    typedef std::unordered_set<node*> root_bucket;
+    typedef std::map<size_t, root_bucket> roots;
+
+    static size_t height(const node& entry);
+    void plant(node& entry);
+    void unplant(node& entry);
+    void erase(nodes::iterator it);
     bool exists(block_const_ptr candidate_block) const;
     block_const_ptr parent(block_const_ptr block) const;
-    ////void log_content() const;
 
     // This is thread safe.
     const size_t maximum_depth_;
 
-    // This is guarded against filtering concurrent to writing.
-    block_entries blocks_;
+    // These are guarded against filtering concurrent to writing.
+    nodes blocks_;
+    roots roots_;
     mutable upgrade_mutex mutex_;
 };
 
@@ -21,15 +21,19 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/pools/arena.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is not thread safe.
+/// This class is not thread safe, except for concurrent population.
 class BCB_API branch
 {
 public:
@@ -94,14 +98,35 @@ public:
     bool get_block_hash(hash_digest& out_hash, size_t height) const;
 
 protected:
+    // Spend count by outpoint.
+    typedef std::unordered_map<chain::point, size_t, std::hash<chain::point>,
+        std::equal_to<chain::point>,
+        arena_allocator<std::pair<const chain::point, size_t>>> spend_index;
+
+    // Tx location by hash, as block offset from the top and tx position.
+    typedef std::pair<size_t, size_t> location;
+    typedef std::unordered_map<hash_digest, location, std::hash<hash_digest>,
+        std::equal_to<hash_digest>,
+        arena_allocator<std::pair<const hash_digest, location>>> tx_index;
+
     size_t index_of(size_t height) const;
     size_t height_at(size_t index) const;
+    void index_block(block_const_ptr block, size_t offset) const;
+    void ensure_index() const;
 
 private:
     size_t height_;
 
     /// The chain of blocks in the branch.
     block_const_ptr_list_ptr blocks_;
+
+    /// Lazily created on first population and extended by push_front.
+    /// The index nodes are released with the branch, in one step.
+    mutable bool indexed_;
+    mutable arena arena_;
+    mutable spend_index spends_;
+    mutable tx_index transactions_;
+    mutable upgrade_mutex mutex_;
 };
 
 } // namespace blockchain
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_NOTIFICATION_QUEUE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_NOTIFICATION_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded queue of notifications, delivered in order by one worker on the
+/// thread pool, so that organizers do not invoke subscribers synchronously.
+/// Each pass of the worker delivers all events queued since the last pass.
+/// An event may be merged into the last undelivered event (coalesced).
+/// A full queue blocks the producer until the worker has drained it, except
+/// when the producer is the worker (a subscriber that organizes).
+template <typename Event>
+class notification_queue
+  : public std::enable_shared_from_this<notification_queue<Event>>,
+    noncopyable
+{
+public:
+    typedef std::shared_ptr<notification_queue<Event>> ptr;
+    typedef std::function<void(Event&)> deliverer;
+
+    /// Merge the next event into the last, false if not mergeable.
+    typedef std::function<bool(Event& last, const Event& next)> coalescer;
+
+    notification_queue(threadpool& pool, size_t limit, deliverer&& deliver,
+        coalescer&& coalesce=nullptr)
+      : pool_(pool),
+        limit_(limit),
+        deliver_(std::move(deliver)),
+        coalesce_(std::move(coalesce)),
+        stopped_(true),
+        draining_(false)
+    {
+    }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = false;
+    }
+
+    /// Undelivered events are discarded and blocked producers released.
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+            queue_.clear();
+        }
+
+        space_.notify_all();
+    }
+
+    /// Queue the event for delivery, false if stopped.
+    bool push(Event&& event)
+    {
+        const auto available = [this]()
+        {
+            return stopped_ || queue_.size() < limit_;
+        };
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (stopped_)
+            return false;
+
+        if (queue_.empty() || !coalesce_ || !coalesce_(queue_.back(), event))
+        {
+            // The worker cannot drain while waiting on itself.
+            if (std::this_thread::get_id() != worker_)
+                space_.wait(lock, available);
+
+            if (stopped_)
+                return false;
+
+            queue_.push_back(std::move(event));
+        }
+
+        if (draining_)
+            return true;
+
+        draining_ = true;
+        lock.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        const auto self = this->shared_from_this();
+        pool_.service().post([self]() { self->drain(); });
+        return true;
+    }
+
+private:
+    void drain()
+    {
+        std::vector<Event> batch;
+
+        while (true)
+        {
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            std::unique_lock<std::mutex> lock(mutex_);
+            batch.clear();
+
+            if (stopped_ || queue_.empty())
+            {
+                draining_ = false;
+                worker_ = std::thread::id();
+                return;
+            }
+
+            batch.swap(queue_);
+            worker_ = std::this_thread::get_id();
+            lock.unlock();
+            ///////////////////////////////////////////////////////////////////
+
+            space_.notify_all();
+
+            for (auto& event: batch)
+                deliver_(event);
+        }
+    }
+
+    // These are thread safe.
+    threadpool& pool_;
+    const size_t limit_;
+    const deliverer deliver_;
+    const coalescer coalesce_;
+
+    // These are protected by mutex.
+    bool stopped_;
+    bool draining_;
+    std::thread::id worker_;
+    std::vector<Event> queue_;
+    std::mutex mutex_;
+    std::condition_variable space_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_ORPHAN_BLOCK_POOL_HPP
+#define LIBBITCOIN_BLOCKCHAIN_ORPHAN_BLOCK_POOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded buffer of checked blocks whose parent is neither in the chain
+/// nor in the block pool, indexed by previous block hash. Once a parent is
+/// organized its buffered children are removed for organization. The buffer
+/// is bounded by block count and by serialized bytes, and the oldest blocks
+/// are evicted first.
+class BCB_API orphan_block_pool
+{
+public:
+    /// A limit of zero disables the buffer, a byte limit of zero is unbounded.
+    orphan_block_pool(size_t limit, size_t byte_limit);
+
+    /// The number of buffered blocks.
+    size_t size() const;
+
+    /// The serialized size of the buffered blocks.
+    size_t bytes() const;
+
+    /// Buffer the block under its previous block hash.
+    /// Returns false if the buffer is disabled, the block is buffered or the
+    /// block alone exceeds the byte limit.
+    bool add(block_const_ptr block);
+
+    /// Determine if the block is buffered.
+    bool exists(const hash_digest& hash) const;
+
+    /// Determine if the block is the ancestor of the hash at the distance,
+    /// through buffered blocks only (a distance of zero is the hash itself).
+    bool is_ancestor(const hash_digest& ancestor, const hash_digest& hash,
+        size_t distance) const;
+
+    /// Remove and return the buffered blocks with the given parent.
+    block_const_ptr_list remove(const hash_digest& parent);
+
+    /// Remove all message vectors that match buffered block hashes.
+    void filter(get_data_ptr message) const;
+
+protected:
+    typedef std::unordered_map<hash_digest, block_const_ptr> orphans;
+    typedef std::unordered_multimap<hash_digest, hash_digest> children;
+    typedef std::deque<hash_digest> order;
+
+    static size_t to_bytes(block_const_ptr block);
+    void erase(const hash_digest& hash);
+
+    // These are thread safe.
+    const size_t limit_;
+    const size_t byte_limit_;
+
+    // These are guarded by the mutex, order is oldest first for eviction.
+    orphans orphans_;
+    children children_;
+    order order_;
+    size_t bytes_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
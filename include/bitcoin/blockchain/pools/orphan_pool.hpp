@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_ORPHAN_POOL_HPP
+#define LIBBITCOIN_BLOCKCHAIN_ORPHAN_POOL_HPP
+
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded pool of txs that failed validation for want of prevouts, indexed
+/// by each missing outpoint. Once a parent is stored the txs waiting on its
+/// outputs are removed for resubmission. The pool is bounded by tx count and
+/// by serialized bytes, and the oldest txs are evicted first.
+class BCB_API orphan_pool
+{
+public:
+    typedef std::vector<transaction_const_ptr> list;
+
+    /// A limit of zero disables the pool, a byte limit of zero is unbounded.
+    orphan_pool(size_t limit, size_t byte_limit);
+
+    /// The number of pooled txs.
+    size_t size() const;
+
+    /// The serialized size of the pooled txs.
+    size_t bytes() const;
+
+    /// Pool the tx under each prevout that validation failed to populate.
+    /// Returns false if the pool is disabled, the tx is already pooled or the
+    /// tx alone exceeds the byte limit.
+    bool add(transaction_const_ptr tx);
+
+    /// Determine if the tx is pooled.
+    bool exists(const hash_digest& hash) const;
+
+    /// Remove and return the pooled txs that spend an output of the parent.
+    list remove(transaction_const_ptr parent);
+
+protected:
+    typedef std::unordered_map<hash_digest, transaction_const_ptr> orphans;
+    typedef std::unordered_multimap<chain::point, hash_digest> waiting;
+    typedef std::deque<hash_digest> order;
+
+    static size_t to_bytes(transaction_const_ptr tx);
+    void erase(const hash_digest& hash);
+
+    // These are thread safe.
+    const size_t limit_;
+    const size_t byte_limit_;
+
+    // These are guarded by the mutex, order is oldest first for eviction.
+    orphans orphans_;
+    waiting waiting_;
+    order order_;
+    size_t bytes_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_PRIORITIZED_MUTEX_HPP
+#define LIBBITCOIN_BLOCKCHAIN_PRIORITIZED_MUTEX_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The organizer critical section, admitting block organization ahead of
+/// queued tx organization. A low priority lock is not granted while a high
+/// priority lock is held or requested, so txs yield between each tx.
+class BCB_API prioritized_mutex
+  : noncopyable
+{
+public:
+    prioritized_mutex();
+
+    /// Exclusive, preempts queued low priority requests (blocks, stop).
+    void lock_high_priority();
+    void unlock_high_priority();
+
+    /// Exclusive, waits on high priority requests (tx push).
+    void lock_low_priority();
+    void unlock_low_priority();
+
+    /// Shared, waits on high priority requests (tx validation).
+    void lock_low_priority_shared();
+    void unlock_low_priority_shared();
+
+private:
+    void admit_low_priority();
+
+    // This is thread safe.
+    shared_mutex mutex_;
+
+    // This is protected by the gate mutex.
+    size_t high_;
+    std::mutex gate_mutex_;
+    std::condition_variable gate_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
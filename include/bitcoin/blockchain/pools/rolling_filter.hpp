@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_ROLLING_FILTER_HPP
+#define LIBBITCOIN_BLOCKCHAIN_ROLLING_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bloom filter of hashes with bounded memory over two generations. Once
+/// the current generation holds the limit the previous is discarded, so at
+/// least the most recent limit hashes are always matched. False positives
+/// are possible (a few per million), false negatives are not.
+class BCB_API rolling_filter
+{
+public:
+    /// A limit of zero disables the filter.
+    rolling_filter(size_t limit);
+
+    /// Record the hash.
+    void add(const hash_digest& hash);
+
+    /// Determine if the hash has (probably) been recorded.
+    bool contains(const hash_digest& hash) const;
+
+    /// Discard all recorded hashes.
+    void clear();
+
+protected:
+    typedef std::vector<uint64_t> bits;
+
+    void set(bits& generation, const hash_digest& hash) const;
+    bool test(const bits& generation, const hash_digest& hash) const;
+
+    // These are thread safe.
+    const size_t limit_;
+    const uint64_t size_;
+    const uint64_t salt_;
+
+    // These are guarded by the mutex.
+    size_t count_;
+    bits current_;
+    bits previous_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_STAGE_POOLS_HPP
+#define LIBBITCOIN_BLOCKCHAIN_STAGE_POOLS_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/settings.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// The priority threadpools of the validation stages. The populate pool also
+/// serves check, accept and pool maintenance, the script pool serves input
+/// connection and the store pool serves store writes. A stage configured
+/// without cores shares the populate pool. The threads of each pool may be
+/// pinned to a cpu list (e.g. "0-7,16-23") or to the cpus of a numa node
+/// (e.g. "node1"), which is supported on Linux only.
+class BCB_API stage_pools
+  : noncopyable
+{
+public:
+    typedef std::vector<size_t> cpus;
+    typedef std::vector<std::function<void()>> batches;
+
+    /// Parse a cpu list or numa node reference, false if invalid or if a
+    /// number is beyond the cpus that can be pinned.
+    static bool to_cpus(cpus& out, const std::string& text);
+
+    /// Run the batches concurrently on the dispatcher, return once all have
+    /// run. The calling thread runs any batch not yet taken by the pool, so
+    /// this may be called from a thread of the pool, or a stopped pool.
+    static void concurrent(dispatcher& dispatch, const batches& batches);
+
+    /// Construct the pools, log and ignore any pinning failure.
+    stage_pools(const settings& settings);
+
+    dispatcher& populate();
+    dispatcher& script();
+    dispatcher& store();
+
+    /// Stop all pools (handlers may remain queued).
+    void shutdown();
+
+    /// Join the threads of all pools.
+    void join();
+
+private:
+    static bool pin(threadpool& pool, size_t threads, const cpus& cpus);
+    static void pin(threadpool& pool, size_t threads, const std::string& text,
+        const std::string& stage);
+    static void ignore(const std::string& text, const std::string& stage);
+
+    // These are thread safe.
+    threadpool populate_pool_;
+    threadpool script_pool_;
+    threadpool store_pool_;
+    dispatcher populate_;
+    dispatcher script_;
+    dispatcher store_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -43,6 +43,10 @@ public:
     /// double spend and input invalid due to forks change (sentinel forks).
     transaction_entry(transaction_const_ptr tx);
 
+    /// Construct an entry for a stored transaction of unknown validity.
+    /// Prevouts are not populated, so fees are zero and sigops exclude p2sh.
+    transaction_entry(const chain::transaction& tx, uint32_t forks);
+
     /// Use this construction only as a search key.
     transaction_entry(const hash_digest& hash);
 
@@ -63,6 +67,9 @@ public:
     /// The size for the purpose of block limit computation.
     size_t size() const;
 
+    /// The validated transaction, or nullptr if not validated by the pool.
+    transaction_const_ptr transaction() const;
+
     /// The hash table entry identity.
     const hash_digest& hash() const;
 
@@ -84,7 +91,9 @@ public:
     /// Add transaction to the list of children of this transaction.
     void add_child(ptr child);
 
-    /// Parents are never removed, as this invalidates the child.
+    /// Parents are removed only when confirmed, as this validates the child.
+    void remove_parent(ptr parent);
+
     /// Removal of a child causing the subgraph connected to it to be pruned.
     void remove_child(ptr child);
 
@@ -99,6 +108,7 @@ private:
     uint32_t sigops_;
     uint32_t size_;
     hash_digest hash_;
+    transaction_const_ptr transaction_;
 
     // Used in DAG search.
     bool marked_;
@@ -20,16 +20,26 @@
 #define LIBBITCOIN_BLOCKCHAIN_TRANSACTION_ORGANIZER_HPP
 
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
+#include <bitcoin/blockchain/pools/notification_queue.hpp>
+#include <bitcoin/blockchain/pools/orphan_pool.hpp>
+#include <bitcoin/blockchain/pools/prioritized_mutex.hpp>
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
+#include <bitcoin/blockchain/pools/rolling_filter.hpp>
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_transaction.hpp>
 
 namespace libbitcoin {
@@ -48,8 +58,10 @@ public:
     typedef resubscriber<code, transaction_const_ptr> transaction_subscriber;
 
     /// Construct an instance.
-    transaction_organizer(shared_mutex& mutex, dispatcher& dispatch,
-        threadpool& thread_pool, fast_chain& chain, const settings& settings);
+    transaction_organizer(prioritized_mutex& mutex, stage_pools& pools,
+        threadpool& thread_pool, fast_chain& chain, transaction_pool& pool,
+        script_cache& cache, chain_metrics& metrics,
+        const settings& settings);
 
     bool start();
     bool stop();
@@ -57,13 +69,38 @@ public:
     void organize(transaction_const_ptr tx, result_handler handler);
     void subscribe_transaction(transaction_handler&& handler);
 
+    /// Validate the tx on the chain and pool in the shared critical section.
+    /// The tx is not pooled or stored, concurrent with tx validation.
+    void validate_only(transaction_const_ptr tx,
+        result_handler handler) const;
+
     void fetch_template(merkle_block_fetch_handler) const;
-    void fetch_mempool(size_t maximum, inventory_fetch_handler) const;
+    void fetch_mempool(size_t maximum, uint64_t minimum_fee,
+        inventory_fetch_handler) const;
+
+    /// Remove all message vectors of recently seen, rejected or orphan txs.
+    void filter(get_data_ptr message) const;
+
+    /// Record confirmed txs as seen and expire rejections (new chain state).
+    void confirm(block_const_ptr_list_const_ptr blocks);
 
 protected:
     bool stopped() const;
 
 private:
+    // Organize sequence.
+    code organize_one(transaction_const_ptr tx);
+    code organize_sequential(transaction_const_ptr tx);
+    void pool_orphan(transaction_const_ptr tx);
+    void resubmit(transaction_const_ptr parent);
+
+    // Concurrent organize sequence.
+    code organize_concurrent(transaction_const_ptr tx);
+    code validate(transaction_const_ptr tx);
+    code push(transaction_const_ptr tx);
+    void claim(transaction_const_ptr tx);
+    void release(transaction_const_ptr tx);
+
     // Verify sub-sequence.
     void handle_accept(const code& ec, transaction_const_ptr tx,
         result_handler handler);
@@ -74,20 +111,36 @@ private:
     void signal_completion(const code& ec);
 
     // Subscription.
+    typedef notification_queue<transaction_const_ptr> transaction_queue;
     void notify_transaction(transaction_const_ptr tx);
+    void deliver_transaction(transaction_const_ptr& tx);
+
+    // Utility.
+    static bool is_rejection(const code& ec);
 
     // This must be protected by the implementation.
     fast_chain& fast_chain_;
 
     // These are thread safe.
-    shared_mutex& mutex_;
+    prioritized_mutex& mutex_;
     std::atomic<bool> stopped_;
     std::promise<code> resume_;
+    const bool concurrent_;
     const float minimum_byte_fee_;
     dispatcher& dispatch_;
-    transaction_pool transaction_pool_;
+    transaction_pool& transaction_pool_;
+    chain_metrics& metrics_;
     validate_transaction validator_;
     transaction_subscriber::ptr subscriber_;
+    transaction_queue::ptr notifications_;
+    rolling_filter seen_;
+    rolling_filter rejected_;
+    orphan_pool orphans_;
+
+    // These are protected by the claims mutex (concurrent outpoint spends).
+    std::unordered_set<chain::point> claims_;
+    std::mutex claims_mutex_;
+    std::condition_variable claims_condition_;
 };
 
 } // namespace blockchain
@@ -21,25 +21,119 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
+#include <bitcoin/blockchain/pools/transaction_entry.hpp>
 #include <bitcoin/blockchain/settings.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
-/// TODO: this class is not implemented or utilized.
+/// This class is thread safe.
+/// An in-memory index of the metadata of unconfirmed (stored) transactions.
+/// This allows block population to determine pool membership and validation
+/// currency without querying the store for each block transaction.
+/// Validated entries are ranked by ancestor fee rate (child pays for parent)
+/// so that the block template is maintained incrementally.
 class BCB_API transaction_pool
 {
 public:
     typedef safe_chain::inventory_fetch_handler inventory_fetch_handler;
     typedef safe_chain::merkle_block_fetch_handler merkle_block_fetch_handler;
 
+    /// Forks value of entries that must be revalidated before use.
+    static const uint32_t sentinel_forks;
+
     transaction_pool(const settings& settings);
 
+    /// The number of indexed transactions.
+    size_t size() const;
+
+    /// Index a newly-validated and stored transaction.
+    void add(transaction_const_ptr valid_tx);
+
+    /// Index a stored transaction of unknown validity (start and reorg).
+    void add(const chain::transaction& tx, uint32_t forks);
+
+    /// Remove the transactions of newly-confirmed blocks and any conflicting
+    /// transactions (with their descendants).
+    void remove(block_const_ptr_list_const_ptr confirmed_blocks);
+
+    /// Restore the non-coinbase transactions of reorganized-out blocks.
+    void restore(block_const_ptr_list_const_ptr outgoing_blocks);
+
+    /// Get the entry for the transaction hash, or nullptr if not indexed.
+    transaction_entry::ptr find(const hash_digest& tx_hash) const;
+
+    /// Get the entries validated by the pool and current as of the last
+    /// block, with cached fees, sigops and size.
+    transaction_entry::list get_validated() const;
+
+    /// Get the entry of the pooled spender of the outpoint, or nullptr.
+    transaction_entry::ptr find_spender(
+        const chain::output_point& outpoint) const;
+
+    /// Remove all entries.
+    void clear();
+
+    /// Get the block template, cached until the pool changes.
     void fetch_template(merkle_block_fetch_handler) const;
-    void fetch_mempool(size_t maximum, inventory_fetch_handler) const;
+
+    /// Get up to maximum pooled tx hashes in package fee rate order, where
+    /// each package rate is at least minimum_fee (satoshis per kilobyte).
+    void fetch_mempool(size_t maximum, uint64_t minimum_fee,
+        inventory_fetch_handler) const;
+
+protected:
+    // The aggregate of an entry and all of its pooled ancestors.
+    struct package
+    {
+        uint64_t fees;
+        size_t size;
+        size_t sigops;
+        bool eligible;
+    };
+
+    // Ordered by descending package fee rate, ties broken by hash.
+    struct rank
+    {
+        double rate;
+        transaction_entry::ptr entry;
+        bool operator<(const rank& other) const;
+    };
+
+    typedef std::unordered_map<hash_digest, transaction_entry::ptr> entries;
+    typedef std::unordered_map<hash_digest, double> rates;
+    typedef std::set<rank> ranking;
+    typedef std::unordered_set<transaction_entry::ptr> entry_set;
+    typedef std::unordered_map<chain::point, transaction_entry::ptr> spends;
+    typedef std::unordered_map<hash_digest, chain::point::list> prevouts;
+
+    void add(transaction_entry::ptr entry, const chain::transaction& tx);
+    void erase(transaction_entry::ptr entry);
+    void update(transaction_entry::ptr entry);
+    package get_package(transaction_entry::ptr entry) const;
+    merkle_block_ptr create_template() const;
+
+    static void get_ancestors(transaction_entry::ptr entry,
+        const entry_set& excluded, entry_set& visited,
+        transaction_entry::list& out_ancestors);
+    static void get_descendants(transaction_entry::ptr entry,
+        entry_set& out_descendants);
+
+    // These are guarded against concurrent population and organization.
+    entries entries_;
+    rates rates_;
+    ranking ranking_;
+    spends spends_;
+    prevouts prevouts_;
+    size_t template_height_;
+    mutable merkle_block_ptr template_;
+    mutable shared_mutex mutex_;
 
 ////private:
 ////    const bool reject_conflicts_;
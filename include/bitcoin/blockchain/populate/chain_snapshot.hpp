@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_CHAIN_SNAPSHOT_HPP
+#define LIBBITCOIN_BLOCKCHAIN_CHAIN_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/populate/header_cache.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is not thread safe.
+/// A file snapshot of the cumulative work index and the header cache, so that
+/// a restart at the same top does not page the store to rebuild them (which
+/// also makes chain state population a memory-only operation).
+class BCB_API chain_snapshot
+{
+public:
+    typedef std::vector<uint256_t> work_list;
+
+    /// An empty path disables the snapshot.
+    chain_snapshot(const boost::filesystem::path& file);
+
+    /// Write the snapshot of the top block, false if not written.
+    bool save(const config::checkpoint& top, const work_list& work,
+        const header_cache& headers) const;
+
+    /// Restore the snapshot if written at the top block, false otherwise.
+    /// The file is removed once read, so it cannot survive an unclean stop.
+    bool load(const config::checkpoint& top, work_list& out_work,
+        header_cache& out_headers) const;
+
+private:
+    const boost::filesystem::path file_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
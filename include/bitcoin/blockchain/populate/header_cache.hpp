@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_HEADER_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_HEADER_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A ring of the header fields of the most recent contiguous chain heights,
+/// so that chain state population does not read the store for each height.
+class BCB_API header_cache
+{
+public:
+    struct record
+    {
+        hash_digest hash;
+        uint32_t bits;
+        uint32_t version;
+        uint32_t timestamp;
+    };
+
+    /// A capacity of zero disables the cache.
+    header_cache(size_t capacity);
+
+    /// The number of cached heights.
+    size_t size() const;
+
+    /// Cache the header at the height, a non-contiguous height resets.
+    void push(const chain::header& header, size_t height);
+
+    /// Cache the record at the height, a non-contiguous height resets.
+    void push(const record& value, size_t height);
+
+    /// Discard the cached headers above the height (reorganization).
+    void pop_above(size_t height);
+
+    /// Discard all cached headers.
+    void clear();
+
+    /// Get the cached header fields at the height, false if not cached.
+    bool get(record& out_record, size_t height) const;
+
+    /// Get the highest cached height, false if empty.
+    bool top(size_t& out_height) const;
+
+protected:
+    // This is thread safe.
+    const size_t capacity_;
+
+    // These are guarded by the mutex, count_ heights end at top_.
+    std::vector<record> ring_;
+    size_t top_;
+    size_t count_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
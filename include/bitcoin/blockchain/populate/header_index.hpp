@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_HEADER_INDEX_HPP
+#define LIBBITCOIN_BLOCKCHAIN_HEADER_INDEX_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A ring of the serialized headers of the most recent contiguous chain
+/// heights with a hash to height map, so that locator queries are resolved
+/// from one array instead of a store read for each hash and height.
+class BCB_API header_index
+{
+public:
+    /// A capacity of zero disables the index.
+    header_index(size_t capacity);
+
+    /// The number of indexed heights.
+    size_t size() const;
+
+    /// Index the header at the height, a non-contiguous height resets.
+    void push(const chain::header& header, size_t height);
+
+    /// Discard the indexed headers above the height (reorganization).
+    void pop_above(size_t height);
+
+    /// Discard all indexed headers.
+    void clear();
+
+    /// Get the height of the indexed header hash, false if not indexed.
+    bool find(size_t& out_height, const hash_digest& hash) const;
+
+    /// Append up to count indexed headers from the height, return the count
+    /// appended (zero if the height is not indexed).
+    size_t get(message::header::list& out_headers, size_t from,
+        size_t count) const;
+
+    /// Append up to count indexed header hashes from the height, return the
+    /// count appended (zero if the height is not indexed).
+    size_t get(hash_list& out_hashes, size_t from, size_t count) const;
+
+protected:
+    size_t available(size_t from, size_t count) const;
+
+    // This is thread safe.
+    const size_t capacity_;
+
+    // These are guarded by the mutex, count_ heights end at top_.
+    data_chunk headers_;
+    hash_list hashes_;
+    std::unordered_map<hash_digest, size_t> heights_;
+    size_t top_;
+    size_t count_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
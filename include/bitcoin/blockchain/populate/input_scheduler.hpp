@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_INPUT_SCHEDULER_HPP
+#define LIBBITCOIN_BLOCKCHAIN_INPUT_SCHEDULER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// Hands out contiguous ranges of the non-coinbase inputs of a block to the
+/// priority threads. Each thread claims the next chunk when it completes the
+/// last, so threads with cheap inputs take work from those with costly ones.
+/// The scheduler is shared by all buckets of a block, so it is also the
+/// cancellation token of the block: the first failing bucket cancels it.
+class BCB_API input_scheduler
+{
+public:
+    typedef std::shared_ptr<input_scheduler> ptr;
+
+    /// Index the non-coinbase inputs of the block for the number of threads.
+    input_scheduler(block_const_ptr block, size_t threads);
+
+    /// The number of non-coinbase inputs in the block.
+    size_t size() const;
+
+    /// Claim the next range [begin, end) of block input positions.
+    /// Returns false when all inputs have been claimed.
+    bool next(size_t& out_begin, size_t& out_end);
+
+    /// Get the tx position and input index of the block input position.
+    void locate(size_t& out_tx, size_t& out_input, size_t position) const;
+
+    /// Stop handing out ranges, claimed ranges should be abandoned.
+    void cancel();
+
+    /// True if the scheduler has been cancelled.
+    bool cancelled() const;
+
+private:
+    // Block input position of the first input of each non-coinbase tx.
+    std::vector<size_t> offsets_;
+    size_t size_;
+    size_t chunk_;
+    std::atomic<size_t> cursor_;
+    std::atomic<bool> cancelled_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -29,7 +29,9 @@
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe, population state is kept on the populated object.
+/// The store is read unguarded, so population must be invoked within the
+/// organizer critical section (shared or unique), which excludes writes.
 class BCB_API populate_base
 {
 protected:
@@ -37,6 +39,10 @@ protected:
 
     populate_base(dispatcher& dispatch, const fast_chain& chain);
 
+    static void reset_prevout(const chain::output_point& outpoint);
+    static void apply_prevout(size_t maximum_height,
+        const fast_chain::output_query& query);
+
     void populate_duplicate(size_t maximum_height,
         const chain::transaction& tx, bool require_confirmed) const;
 
@@ -45,6 +51,10 @@ protected:
     void populate_prevout(size_t maximum_height,
         const chain::output_point& outpoint, bool require_confirmed) const;
 
+    /// Populate the prevouts of the queries with one batched store read.
+    void populate_prevouts(size_t maximum_height,
+        fast_chain::output_queries& queries, bool require_confirmed) const;
+
     // This is thread safe.
     dispatcher& dispatch_;
 
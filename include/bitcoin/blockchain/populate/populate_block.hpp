@@ -19,23 +19,32 @@
 #ifndef LIBBITCOIN_BLOCKCHAIN_POPULATE_BLOCK_HPP
 #define LIBBITCOIN_BLOCKCHAIN_POPULATE_BLOCK_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
 #include <bitcoin/blockchain/populate/populate_base.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe, population state is kept on the block.
+/// The store is read unguarded, so population must be invoked within the
+/// organizer critical section (shared or unique), which excludes writes.
 class BCB_API populate_block
   : public populate_base
 {
 public:
     populate_block(dispatcher& dispatch, const fast_chain& chain,
-        bool relay_transactions);
+        const transaction_pool& pool);
+
+    /// Buckets abandon population once stopped, the join is then stopped.
+    void start();
+    void stop();
 
     /// Populate validation state for the top block.
     void populate(branch::const_ptr branch, result_handler&& handler) const;
@@ -43,6 +52,11 @@ public:
 protected:
     typedef branch::const_ptr branch_ptr;
 
+    inline bool stopped() const
+    {
+        return stopped_;
+    }
+
     void populate_coinbase(branch::const_ptr branch,
         block_const_ptr block) const;
 
@@ -50,13 +64,18 @@ protected:
     ////    const chain::transaction& tx) const;
 
     void populate_transactions(branch::const_ptr branch, size_t bucket,
-        size_t buckets, result_handler handler) const;
+        size_t buckets, input_scheduler::ptr scheduler,
+        result_handler handler) const;
+
+    void populate_pooled(const chain::transaction& tx, uint32_t forks) const;
 
     void populate_prevout(branch_ptr branch,
         const chain::output_point& outpoint) const;
 
 private:
-    const bool relay_transactions_;
+    // These are thread safe.
+    std::atomic<bool> stopped_;
+    const transaction_pool& transaction_pool_;
 };
 
 } // namespace blockchain
@@ -30,7 +30,7 @@
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe.
 class BCB_API populate_chain_state
 {
 public:
@@ -69,10 +69,9 @@ private:
     const uint32_t configured_forks_;
     const config::checkpoint::list checkpoints_;
 
-    // Populate is guarded against concurrent callers but because it uses the fast
-    // chain it must not be invoked during chain writes.
+    // Populate may be called concurrently but because it uses the fast chain
+    // it must not be invoked during writes to the heights that it reads.
     const fast_chain& fast_chain_;
-    mutable shared_mutex mutex_;
 };
 
 } // namespace blockchain
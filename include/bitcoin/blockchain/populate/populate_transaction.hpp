@@ -28,7 +28,9 @@
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe, population state is kept on the tx.
+/// The store is read unguarded, so population must be invoked within the
+/// organizer critical section (shared or unique), which excludes writes.
 class BCB_API populate_transaction
   : public populate_base
 {
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_UNSPENT_FILTER_HPP
+#define LIBBITCOIN_BLOCKCHAIN_UNSPENT_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bloom filter of the hashes of stored transactions, so that the duplicate
+/// (BIP30) check reads the store only on a filter hit. Hashes are added before
+/// their transactions are written and are never removed, so the filter remains
+/// a superset of the unspent transactions across spends and reorganizations.
+/// Until activated, and once saturated, every hash is reported as a hit.
+class BCB_API unspent_filter
+{
+public:
+    /// A limit of zero disables the filter.
+    unspent_filter(size_t limit);
+
+    /// The number of hashes added since the last clear.
+    size_t size() const;
+
+    /// True if activated and the limit has not been exceeded.
+    bool authoritative() const;
+
+    /// True if the limit has been exceeded, every hash is then a hit.
+    bool saturated() const;
+
+    /// False only if the transaction is certainly not in the store.
+    bool contains(const hash_digest& hash) const;
+
+    /// Add a transaction hash, before the transaction is written.
+    void add(const hash_digest& hash);
+
+    /// Add the transaction hashes of the block, before the block is written.
+    void add(const chain::block& block);
+
+    /// Empty the filter, reporting every hash as a hit until activated.
+    void clear();
+
+    /// Answer queries from the filter, once all stored hashes are added.
+    void activate();
+
+protected:
+    typedef std::vector<uint64_t> bits;
+
+    // These are thread safe.
+    const size_t limit_;
+    const uint64_t size_;
+    const uint64_t salt_;
+
+    // These are guarded by the mutex.
+    size_t count_;
+    bool active_;
+    bits bits_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_UTXO_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_UTXO_CACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded, sharded subset of the unspent outputs of the chain, warmed by
+/// the outputs of connected blocks (most spends are of young coins), so that
+/// prevout population avoids the store for recent outputs. An output is
+/// discarded when spent by a connected block, and outputs above a fork point
+/// are discarded before a reorganization is written.
+class BCB_API utxo_cache
+{
+public:
+    /// A limit of zero disables the cache.
+    utxo_cache(size_t limit);
+
+    /// The number of cached outputs.
+    size_t size() const;
+
+    /// Get the cached output if confirmed at or below the branch height.
+    bool get(chain::output& out_output, size_t& out_height,
+        bool& out_coinbase, const chain::output_point& outpoint,
+        size_t branch_height) const;
+
+    /// Discard the prevouts spent by the block and cache its outputs.
+    void add(const chain::block& block, size_t height);
+
+    /// Discard the prevouts spent by the block.
+    void remove_spent(const chain::block& block);
+
+    /// Discard the outputs confirmed above the height (reorganization).
+    void pop_above(size_t height);
+
+    /// Discard all cached outputs.
+    void clear();
+
+protected:
+    struct value
+    {
+        chain::output output;
+        size_t height;
+        bool coinbase;
+    };
+
+    typedef std::list<chain::point> order;
+    typedef std::pair<value, order::iterator> entry;
+
+    struct shard
+    {
+        // These are guarded by the mutex, recent is most recent first.
+        order recent;
+        std::unordered_map<chain::point, entry> entries;
+        size_t top = 0;
+        std::mutex mutex;
+    };
+
+    shard& to_shard(const chain::point& point) const;
+    void remove(const chain::point& point);
+
+    // This is thread safe.
+    const size_t shard_limit_;
+
+    // Each shard is independently guarded.
+    mutable std::vector<shard> shards_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
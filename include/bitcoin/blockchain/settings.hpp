@@ -20,6 +20,7 @@
 #define LIBBITCOIN_BLOCKCHAIN_SETTINGS_HPP
 
 #include <cstdint>
+#include <string>
 #include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/bitcoin/config/endpoint.hpp>
@@ -40,13 +41,44 @@ public:
 
     /// Properties.
     uint32_t cores;
+    uint32_t script_cores;
+    uint32_t store_cores;
+    std::string populate_cpus;
+    std::string script_cpus;
+    std::string store_cpus;
     bool priority;
     bool use_libconsensus;
     bool reject_conflicts;
     float minimum_byte_fee_satoshis;
     uint32_t reorganization_limit;
+    uint32_t script_cache_limit;
+    bool pipeline_blocks;
+    uint32_t seen_transaction_limit;
+    uint32_t rejected_transaction_limit;
+    uint32_t orphan_transaction_limit;
+    uint32_t orphan_transaction_bytes;
+    uint32_t orphan_block_limit;
+    uint32_t orphan_block_bytes;
+    bool concurrent_transactions;
+    uint32_t header_index_limit;
+    uint32_t relay_cache_limit;
+    uint32_t stealth_index_depth;
+    uint32_t utxo_cache_limit;
+    uint32_t unspent_filter_limit;
+    uint32_t memory_budget_megabytes;
+    std::string store_access;
+    uint32_t prefault_megabytes;
+    boost::filesystem::path snapshot_file;
+    bool read_only;
+    boost::filesystem::path publication_file;
+    uint32_t notification_limit;
     uint32_t block_version;
     config::checkpoint::list checkpoints;
+
+    /// Trusts only blocks whose descendants up to this block are buffered as
+    /// orphans. Blocks arrive in order until headers-first sync exists, so
+    /// this is then effectively a no-op (every block is fully validated).
+    config::checkpoint assume_valid;
     bool easy_blocks;
     bool bip16;
     bool bip30;
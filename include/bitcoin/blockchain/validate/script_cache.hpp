@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_SCRIPT_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_SCRIPT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded set of successful input script verifications, shared by tx pool
+/// validation (fill) and block connection (reuse). An entry is identified by
+/// tx hash, input index and the forks under which the script was verified.
+class BCB_API script_cache
+{
+public:
+    /// A limit of zero disables the cache.
+    script_cache(size_t limit);
+
+    /// The number of cached verifications.
+    size_t size() const;
+
+    /// Record the successful verification of the input.
+    void add(const hash_digest& tx_hash, uint32_t input_index,
+        uint32_t forks);
+
+    /// Determine if the input has been successfully verified.
+    bool exists(const hash_digest& tx_hash, uint32_t input_index,
+        uint32_t forks) const;
+
+protected:
+    struct key
+    {
+        hash_digest hash;
+        uint32_t index;
+        uint32_t forks;
+        bool operator==(const key& other) const;
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::unordered_set<key, key_hash> keys;
+    typedef std::deque<key> order;
+
+    // This is thread safe.
+    const size_t limit_;
+
+    // These are guarded by the mutex, order is oldest first for eviction.
+    keys keys_;
+    order order_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -23,24 +23,34 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/orphan_block_pool.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
 #include <bitcoin/blockchain/populate/populate_block.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
+#include <bitcoin/blockchain/validate/validate_input.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe.
+/// Accept and connect must be invoked within the organizer critical section.
 class BCB_API validate_block
 {
 public:
     typedef handle0 result_handler;
 
-    validate_block(dispatcher& dispatch, const fast_chain& chain,
-        const settings& settings, bool relay_transactions);
+    validate_block(dispatcher& priority_dispatch,
+        dispatcher& script_dispatch, const fast_chain& chain,
+        const settings& settings, const transaction_pool& pool,
+        script_cache& cache, const orphan_block_pool& orphans);
 
     void start();
     void stop();
@@ -55,37 +65,70 @@ protected:
         return stopped_;
     }
 
-    float hit_rate() const;
-
 private:
     typedef std::atomic<size_t> atomic_counter;
     typedef std::shared_ptr<atomic_counter> atomic_counter_ptr;
 
+    // Script cache statistics of one block, shared across its buckets.
+    struct statistics
+    {
+        atomic_counter hits;
+        atomic_counter queries;
+    };
+
+    typedef std::shared_ptr<statistics> statistics_ptr;
+
+    // Wire serializations of block txs, each created at most once.
+    struct serialization
+    {
+        serialization(size_t count);
+        const data_chunk& get(const chain::transaction& tx, size_t position);
+
+        std::vector<data_chunk> data;
+        std::vector<std::once_flag> flags;
+    };
+
+    typedef std::shared_ptr<serialization> serialization_ptr;
+
+    static float hit_rate(const statistics& stats);
     static void dump(const code& ec, const chain::transaction& tx,
         uint32_t input_index, uint32_t branches, size_t height,
         bool use_libconsensus);
 
+    bool is_assumed_valid(block_const_ptr block) const;
+    code check_transactions(block_const_ptr block) const;
+    void check_bucket(block_const_ptr block, size_t bucket,
+        atomic_counter_ptr failures, result_handler handler) const;
     void handle_populated(const code& ec, block_const_ptr block,
         result_handler handler) const;
     void accept_transactions(block_const_ptr block, size_t bucket,
-        atomic_counter_ptr sigops, bool bip16, result_handler handler) const;
+        atomic_counter_ptr sigops, atomic_counter_ptr failures, bool bip16,
+        result_handler handler) const;
     void handle_accepted(const code& ec, block_const_ptr block,
         atomic_counter_ptr sigops,
         result_handler handler) const;
-    void connect_inputs(block_const_ptr block, size_t bucket,
-        size_t buckets, result_handler handler) const;
-    void handle_connected(const code& ec, block_const_ptr block,
+    void connect_inputs(block_const_ptr block,
+        input_scheduler::ptr scheduler, serialization_ptr serialized,
+        validate_input::verifier verify, statistics_ptr stats,
         result_handler handler) const;
+    code connect_input(const chain::transaction& tx, size_t position,
+        uint32_t input_index, uint32_t forks, serialization_ptr serialized,
+        const validate_input::verifier& verify, statistics& stats) const;
+    void handle_connected(const code& ec, block_const_ptr block,
+        statistics_ptr stats, result_handler handler) const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     const bool use_libconsensus_;
+    const config::checkpoint assume_valid_;
     const fast_chain& fast_chain_;
     dispatcher& priority_dispatch_;
-    mutable atomic_counter hits_;
-    mutable atomic_counter queries_;
+    dispatcher& script_dispatch_;
+    script_cache& script_cache_;
+    const orphan_block_pool& orphans_;
 
-    // Caller must not invoke accept/connect concurrently.
+    // Population is stateless, so accept/connect may be invoked concurrently
+    // for distinct blocks within the shared critical section.
     populate_block block_populator_;
 };
 
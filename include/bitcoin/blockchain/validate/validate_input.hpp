@@ -34,6 +34,32 @@ namespace blockchain {
 class BCB_API validate_input
 {
 public:
+    /// A script verifier resolved once for a fork set (e.g. per block), so
+    /// the verifier selection and the fork to libconsensus flag conversion
+    /// are not repeated for each input.
+    class BCB_API verifier
+    {
+    public:
+        /// The tx data is as for verify_script.
+        code operator()(const chain::transaction& tx,
+            const data_chunk& tx_data, uint32_t input_index) const;
+
+    private:
+        friend class validate_input;
+
+        typedef code(*kernel)(const chain::transaction& tx,
+            const data_chunk& tx_data, uint32_t input_index, uint32_t forks,
+            uint32_t flags);
+
+        verifier(kernel verify, uint32_t forks, uint32_t flags);
+
+        kernel verify_;
+        uint32_t forks_;
+        uint32_t flags_;
+    };
+
+    /// Resolve the verifier of the forks, libconsensus if configured.
+    static verifier to_verifier(uint32_t forks, bool use_libconsensus);
 
 #ifdef WITH_CONSENSUS
     static uint32_t convert_flags(uint32_t native_flags);
@@ -42,6 +68,26 @@ public:
 
     static code verify_script(const chain::transaction& tx,
         uint32_t input_index, uint32_t branches, bool use_libconsensus);
+
+    /// The tx data must be the wire serialization of the tx, which allows it
+    /// to be shared across inputs. It is used only by libconsensus.
+    static code verify_script(const chain::transaction& tx,
+        const data_chunk& tx_data, uint32_t input_index, uint32_t branches,
+        bool use_libconsensus);
+
+private:
+    static code verify_native(const chain::transaction& tx,
+        const data_chunk& tx_data, uint32_t input_index, uint32_t forks,
+        uint32_t flags);
+    static code verify_unavailable(const chain::transaction& tx,
+        const data_chunk& tx_data, uint32_t input_index, uint32_t forks,
+        uint32_t flags);
+
+#ifdef WITH_CONSENSUS
+    static code verify_consensus(const chain::transaction& tx,
+        const data_chunk& tx_data, uint32_t input_index, uint32_t forks,
+        uint32_t flags);
+#endif
 };
 
 } // namespace blockchain
@@ -21,24 +21,30 @@
 
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/populate/populate_transaction.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
+#include <bitcoin/blockchain/validate/validate_input.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
-/// This class is NOT thread safe.
+/// This class is thread safe.
 class BCB_API validate_transaction
 {
 public:
     typedef handle0 result_handler;
 
-    validate_transaction(dispatcher& dispatch, const fast_chain& chain,
-        const settings& settings);
+    validate_transaction(dispatcher& priority_dispatch,
+        dispatcher& script_dispatch, const fast_chain& chain,
+        const transaction_pool& pool, const settings& settings,
+        script_cache& cache);
 
     void start();
     void stop();
@@ -56,16 +62,25 @@ protected:
 private:
     void handle_populated(const code& ec, transaction_const_ptr tx,
         result_handler handler) const;
+    void populate_pool_spends(transaction_const_ptr tx) const;
+    typedef std::shared_ptr<const data_chunk> data_ptr;
+    typedef std::atomic<size_t> atomic_counter;
+    typedef std::shared_ptr<atomic_counter> atomic_counter_ptr;
+
     void connect_inputs(transaction_const_ptr tx, size_t bucket,
-        size_t buckets, result_handler handler) const;
+        size_t buckets, data_ptr tx_data, validate_input::verifier verify,
+        atomic_counter_ptr failures, result_handler handler) const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     const bool use_libconsensus_;
     const fast_chain& fast_chain_;
-    dispatcher& dispatch_;
+    const transaction_pool& transaction_pool_;
+    dispatcher& script_dispatch_;
+    script_cache& script_cache_;
 
-    // Caller must not invoke accept/connect concurrently.
+    // Population is stateless, so accept/connect may be invoked concurrently
+    // for distinct txs within the shared critical section.
     populate_transaction transaction_populator_;
 };
 
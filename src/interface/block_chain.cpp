@@ -19,13 +19,19 @@
 #include <bitcoin/blockchain/interface/block_chain.hpp>
 
 #include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <unordered_set>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/database.hpp>
 #include <bitcoin/blockchain/settings.hpp>
@@ -64,20 +70,56 @@ using namespace std::placeholders;
 
 #define NAME "block_chain"
 
+// Torn reads are retried by yielding this many times before blocking.
+static constexpr size_t read_spin_limit = 16;
+
+// Recent headers cached for chain state, two retarget intervals (reorgs).
+static constexpr size_t header_cache_capacity = 2u * 2016u;
+
+// A read-only chain reads the publication at most once per interval.
+static const auto publication_interval = asio::milliseconds(100);
+
+// A stealth filter shorter than the bucket bits is scanned in chunks of at
+// least this number of buckets.
+static constexpr size_t minimum_stealth_chunk_buckets = 256;
+
+// A paged history query reads ahead of the cursor, doubling each read from
+// one page up to the greater of this number of rows and the page size.
+static constexpr size_t maximum_history_read_ahead = 65536;
+
 block_chain::block_chain(threadpool& pool,
     const blockchain::settings& chain_settings,
-    const database::settings& database_settings, bool relay_transactions)
+    const database::settings& database_settings, bool)
   : stopped_(true),
     settings_(chain_settings),
     spin_lock_sleep_(asio::milliseconds(1)),
+    write_epoch_(0),
+    read_retries_(0),
+    read_waits_(0),
+    deferred_(false),
+    commits_(0),
     chain_state_populator_(*this, chain_settings),
     database_(database_settings),
-    priority_pool_(thread_ceiling(chain_settings.cores),
-        priority(chain_settings.priority)),
-    dispatch_(priority_pool_, NAME "_priority"),
-    transaction_organizer_(mutex_, dispatch_, pool, *this, chain_settings),
-    block_organizer_(mutex_, dispatch_, pool, *this, chain_settings,
-        relay_transactions)
+    header_cache_(header_cache_capacity),
+    header_index_(chain_settings.header_index_limit),
+    relay_cache_(chain_settings.relay_cache_limit),
+    stealth_index_(chain_settings.stealth_index_depth),
+    utxo_cache_(chain_settings.utxo_cache_limit),
+    unspent_filter_(chain_settings.unspent_filter_limit),
+    snapshot_(chain_settings.snapshot_file),
+    memory_advisor_(database_settings.directory, chain_settings),
+    memory_usage_({ 0, 0, 0 }),
+    publication_(chain_settings.publication_file),
+    publication_sequence_(0),
+    publication_writers_(0),
+    published_height_(max_size_t),
+    pools_(chain_settings),
+    transaction_pool_(chain_settings),
+    script_cache_(chain_settings.script_cache_limit),
+    transaction_organizer_(mutex_, pools_, pool, *this, transaction_pool_,
+        script_cache_, metrics_, chain_settings),
+    block_organizer_(mutex_, pools_, pool, *this, transaction_pool_,
+        script_cache_, metrics_, chain_settings)
 {
 }
 
@@ -101,6 +143,14 @@ bool block_chain::get_block_exists(const hash_digest& block_hash) const
 
 bool block_chain::get_block_hash(hash_digest& out_hash, size_t height) const
 {
+    header_cache::record record;
+
+    if (header_cache_.get(record, height))
+    {
+        out_hash = record.hash;
+        return true;
+    }
+
     const auto result = database_.blocks().get(height);
 
     if (!result)
@@ -118,6 +168,35 @@ bool block_chain::get_branch_work(uint256_t& out_work,
         return false;
 
     out_work = 0;
+
+    if (from_height > top || maximum == 0)
+        return true;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    work_mutex_.lock_shared();
+
+    // The index is complete if it covers the top (gaps end the index).
+    if (work_.size() == top + 1u)
+    {
+        // The work is cumulative so the sum of any segment is a subtraction.
+        // The first segment total at or above the maximum is the early exit.
+        const auto base = from_height == 0 ? uint256_t(0) :
+            work_[from_height - 1u];
+        const auto end = work_.begin() + top + 1u;
+        const auto it = std::lower_bound(work_.begin() + from_height, end,
+            base + maximum);
+
+        out_work = (it == end ? work_[top] : *it) - base;
+        work_mutex_.unlock_shared();
+        //---------------------------------------------------------------------
+        return true;
+    }
+
+    work_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Fall back to a walk of the store (gapped chain).
     for (auto height = from_height; height <= top && out_work < maximum;
         ++height)
     {
@@ -144,6 +223,9 @@ bool block_chain::get_header(chain::header& out_header, size_t height) const
 bool block_chain::get_height(size_t& out_height,
     const hash_digest& block_hash) const
 {
+    if (header_index_.find(out_height, block_hash))
+        return true;
+
     auto result = database_.blocks().get(block_hash);
     if (!result)
         return false;
@@ -154,6 +236,14 @@ bool block_chain::get_height(size_t& out_height,
 
 bool block_chain::get_bits(uint32_t& out_bits, const size_t& height) const
 {
+    header_cache::record record;
+
+    if (header_cache_.get(record, height))
+    {
+        out_bits = record.bits;
+        return true;
+    }
+
     auto result = database_.blocks().get(height);
     if (!result)
         return false;
@@ -165,6 +255,14 @@ bool block_chain::get_bits(uint32_t& out_bits, const size_t& height) const
 bool block_chain::get_timestamp(uint32_t& out_timestamp,
     const size_t& height) const
 {
+    header_cache::record record;
+
+    if (header_cache_.get(record, height))
+    {
+        out_timestamp = record.timestamp;
+        return true;
+    }
+
     auto result = database_.blocks().get(height);
     if (!result)
         return false;
@@ -176,6 +274,14 @@ bool block_chain::get_timestamp(uint32_t& out_timestamp,
 bool block_chain::get_version(uint32_t& out_version,
     const size_t& height) const
 {
+    header_cache::record record;
+
+    if (header_cache_.get(record, height))
+    {
+        out_version = record.version;
+        return true;
+    }
+
     auto result = database_.blocks().get(height);
     if (!result)
         return false;
@@ -186,19 +292,38 @@ bool block_chain::get_version(uint32_t& out_version,
 
 bool block_chain::get_last_height(size_t& out_height) const
 {
-    return database_.blocks().top(out_height);
+    if (!database_.blocks().top(out_height))
+        return false;
+
+    // A read-only chain does not serve blocks above the published top.
+    out_height = std::min(out_height, size_t(published_height_));
+    return true;
 }
 
 bool block_chain::get_output(chain::output& out_output, size_t& out_height,
     bool& out_coinbase, const chain::output_point& outpoint,
     size_t branch_height, bool require_confirmed) const
 {
+    // Cached outputs are confirmed and unspent at the top of the chain.
+    if (utxo_cache_.get(out_output, out_height, out_coinbase, outpoint,
+        branch_height))
+        return true;
+
     // This includes a cached value for spender height (or not_spent).
     // Get the highest tx with matching hash, at or below the branch height.
     return database_.transactions().get_output(out_output, out_height,
         out_coinbase, outpoint, branch_height, require_confirmed);
 }
 
+// The local store is memory-mapped, so the batch is resolved in place.
+void block_chain::get_outputs(output_queries& queries, size_t branch_height,
+    bool require_confirmed) const
+{
+    for (auto& query: queries)
+        query.found = get_output(query.output, query.height, query.coinbase,
+            *query.outpoint, branch_height, require_confirmed);
+}
+
 bool block_chain::get_output_is_confirmed(chain::output& out_output, size_t& out_height,
                              bool& out_coinbase, bool& out_is_confirmed, const chain::output_point& outpoint,
                              size_t branch_height, bool require_confirmed) const
@@ -212,6 +337,10 @@ bool block_chain::get_output_is_confirmed(chain::output& out_output, size_t& out
 bool block_chain::get_is_unspent_transaction(const hash_digest& hash,
     size_t branch_height, bool require_confirmed) const
 {
+    // A filter miss is certain, so the store is read only on a filter hit.
+    if (!unspent_filter_.contains(hash))
+        return false;
+
     const auto result = database_.transactions().get(hash, branch_height,
         require_confirmed);
 
@@ -251,24 +380,99 @@ transaction_ptr block_chain::get_transaction(size_t& out_block_height,
 
 bool block_chain::begin_insert() const
 {
-    return database_.begin_insert();
+    if (settings_.read_only)
+        return false;
+
+    begin_publish();
+
+    if (!database_.begin_insert())
+    {
+        publish_top();
+        return false;
+    }
+
+    // Bulk inserts are gapped, so in-memory indexing is deferred to the end.
+    // The stealth index is rebuilt only from subsequent blocks.
+    deferred_ = true;
+    stealth_index_.clear();
+    return true;
 }
 
 bool block_chain::end_insert() const
 {
-    return database_.end_insert();
+    const auto result = database_.end_insert();
+
+    // Index once from the store, ending at any remaining gap.
+    if (deferred_.exchange(false))
+    {
+        index_work();
+        header_cache_.clear();
+        populate_header_cache();
+        header_index_.clear();
+        populate_header_index();
+    }
+
+    publish_top();
+    notify_write();
+    return result;
 }
 
 bool block_chain::insert(block_const_ptr block, size_t height)
 {
-    return database_.insert(*block, height) == error::success;
+    if (settings_.read_only)
+        return false;
+
+    // Hashes precede the write, so the filter never misses a stored tx.
+    unspent_filter_.add(*block);
+
+    // A bulk insert is published once, by end_insert.
+    if (deferred_)
+    {
+        if (database_.insert(*block, height) != error::success)
+            return false;
+
+        // Spent outputs must be discarded even if indexing is deferred.
+        utxo_cache_.remove_spent(*block);
+        return true;
+    }
+
+    begin_publish();
+    const auto ec = database_.insert(*block, height);
+    publish_top();
+
+    if (ec)
+        return false;
+
+    utxo_cache_.add(*block, height);
+
+    header_cache_.push(block->header(), height);
+    header_index_.push(block->header(), height);
+    stealth_index_.push(*block, height);
+    index_work();
+    sample_memory();
+    return true;
 }
 
 void block_chain::push(transaction_const_ptr tx, dispatcher&,
     result_handler handler)
 {
-    // Transaction push is currently sequential so dispatch is not used.
-    handler(database_.push(*tx, chain_state()->enabled_forks()));
+    if (settings_.read_only)
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
+    // Transaction push is a single store write so dispatch is not used.
+    // Parallelism of table writes is a store concern (see reorganize).
+    unspent_filter_.add(tx->hash());
+    const auto forks = chain_state()->enabled_forks();
+
+    // The top is unchanged but read-only chains must not read the write.
+    begin_publish();
+    const auto ec = database_.push(*tx, forks);
+    publish_top();
+    notify_write();
+    handler(ec);
 }
 
 void block_chain::reorganize(const checkpoint& fork_point,
@@ -276,27 +480,101 @@ void block_chain::reorganize(const checkpoint& fork_point,
     block_const_ptr_list_ptr outgoing_blocks, dispatcher& dispatch,
     result_handler handler)
 {
-    if (incoming_blocks->empty())
+    if (settings_.read_only || incoming_blocks->empty())
     {
         handler(error::operation_failed);
         return;
     }
 
+    // Chain state readers wait on this until the commit completes.
+    begin_commit();
+
+    // Read-only chains over the store do not read until the new top.
+    begin_publish();
+
+    // Cached headers above the fork point may be popped by the write.
+    header_cache_.pop_above(fork_point.height());
+    header_index_.pop_above(fork_point.height());
+    relay_cache_.pop_above(fork_point.height());
+    stealth_index_.pop_above(fork_point.height());
+
+    // Outputs above the fork point and those spent by the incoming blocks
+    // are discarded before the write, as validation may read concurrently.
+    utxo_cache_.pop_above(fork_point.height());
+
+    for (const auto block: *incoming_blocks)
+    {
+        utxo_cache_.remove_spent(*block);
+        unspent_filter_.add(*block);
+    }
+
+    // The store parallelizes its table writes on the dispatcher. In-memory
+    // index maintenance follows the write, in concurrent batches.
     // The top (back) block is used to update the chain state.
     const auto complete =
         std::bind(&block_chain::handle_reorganize,
-            this, _1, incoming_blocks->back(), handler);
+            this, _1, fork_point.height(), incoming_blocks, handler);
 
     database_.reorganize(fork_point, incoming_blocks, outgoing_blocks,
         dispatch, complete);
 }
 
-void block_chain::handle_reorganize(const code& ec, block_const_ptr top,
-    result_handler handler)
+void block_chain::handle_reorganize(const code& ec, size_t fork_height,
+    block_const_ptr_list_const_ptr incoming, result_handler handler)
 {
+    // A read between the first pop and the start of the write may have cached
+    // an outgoing block, so invalidate again once the write is complete.
+    relay_cache_.pop_above(fork_height);
+
     if (!ec)
-        set_chain_state(top->validation.state);
+    {
+        // The indexes are independent, so each is a batch on the store pool.
+        // Blocks are indexed in order within a batch. All batches complete
+        // before the chain state is set (one barrier per reorganization).
+        const auto each = [&](const std::function<void(block_const_ptr,
+            size_t)>& index)
+        {
+            return [&, index]()
+            {
+                auto height = fork_height;
+
+                for (const auto block: *incoming)
+                    index(block, ++height);
+            };
+        };
+
+        stage_pools::concurrent(pools_.store(),
+        {
+            [&]() { index_work(fork_height, incoming); },
+            [&]() { transaction_organizer_.confirm(incoming); },
+            each([this](block_const_ptr block, size_t height)
+            {
+                header_cache_.push(block->header(), height);
+                header_index_.push(block->header(), height);
+            }),
+            each([this](block_const_ptr block, size_t height)
+            {
+                stealth_index_.push(*block, height);
+            }),
+            each([this](block_const_ptr block, size_t height)
+            {
+                utxo_cache_.add(*block, height);
+            })
+        });
+
+        set_chain_state(incoming->back()->validation.state);
+        sample_memory();
+    }
+    else
+    {
+        // The store state of a failed write is unknown.
+        utxo_cache_.clear();
+        stealth_index_.clear();
+    }
 
+    publish_top();
+    end_commit();
+    notify_write();
     handler(ec);
 }
 
@@ -304,15 +582,11 @@ void block_chain::handle_reorganize(const code& ec, block_const_ptr top,
 // ----------------------------------------------------------------------------
 
 // For tx validator, call only from inside validate critical section.
+// A pipelined block commit may still be writing, so wait for its state.
 chain::chain_state::ptr block_chain::chain_state() const
 {
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(pool_state_mutex_);
-
-    // Initialized on start and updated after each successful organization.
-    return pool_state_;
-    ///////////////////////////////////////////////////////////////////////////
+    wait_commits();
+    return pool_state();
 }
 
 // For block validator, call only from inside validate critical section.
@@ -322,7 +596,20 @@ chain::chain_state::ptr block_chain::chain_state(
     // Promote from cache if branch is same height as pool (most typical).
     // Generate from branch/store if the promotion is not successful.
     // If the organize is successful pool state will be updated accordingly.
-    return chain_state_populator_.populate(chain_state(), branch);
+    // The branch may be based on a block that is still being committed.
+    return chain_state_populator_.populate(pool_state(), branch);
+}
+
+// private.
+chain::chain_state::ptr block_chain::pool_state() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(pool_state_mutex_);
+
+    // Initialized on start and updated after each successful organization.
+    return pool_state_;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // private.
@@ -337,6 +624,360 @@ code block_chain::set_chain_state(chain::chain_state::ptr previous)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// private.
+// Cache the most recent headers of the store for chain state population.
+void block_chain::populate_header_cache() const
+{
+    size_t top;
+    if (!database_.blocks().top(top))
+        return;
+
+    const auto first = floor_subtract(top + 1u, header_cache_capacity);
+
+    for (auto height = first; height <= top; ++height)
+    {
+        const auto result = database_.blocks().get(height);
+
+        // A gap resets the cache, so continue to the top.
+        if (result)
+            header_cache_.push(result.header(), height);
+    }
+}
+
+// private.
+// Index the most recent headers of the store for locator queries.
+void block_chain::populate_header_index() const
+{
+    size_t top;
+    if (!database_.blocks().top(top))
+        return;
+
+    const auto first = floor_subtract(top + 1u,
+        size_t(settings_.header_index_limit));
+
+    for (auto height = first; height <= top; ++height)
+    {
+        const auto result = database_.blocks().get(height);
+
+        // A gap resets the index, so continue to the top.
+        if (result)
+            header_index_.push(result.header(), height);
+    }
+}
+
+// private.
+bool block_chain::get_top(checkpoint& out_top) const
+{
+    size_t height;
+    if (!get_last_height(height))
+        return false;
+
+    const auto result = database_.blocks().get(height);
+    if (!result)
+        return false;
+
+    out_top = { result.header().hash(), height };
+    return true;
+}
+
+// private.
+// Called before organizers start, so the indexes are not guarded here.
+bool block_chain::restore_snapshot()
+{
+    checkpoint top;
+    return get_top(top) && snapshot_.load(top, work_, header_cache_);
+}
+
+// private.
+// Close is idempotent, so the work index is cleared once it is written.
+void block_chain::save_snapshot()
+{
+    checkpoint top;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(work_mutex_);
+
+    if (work_.empty() || !get_top(top))
+        return;
+
+    snapshot_.save(top, work_, header_cache_);
+    work_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// Read-only chains over the store do not read while it is written. Writes
+// may overlap (tx push and block commit), the first marks the sequence odd.
+void block_chain::begin_publish() const
+{
+    if (settings_.read_only || settings_.publication_file.empty())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(publication_write_mutex_);
+
+    if (publication_writers_++ == 0)
+    {
+        publication_sequence_ |= 1u;
+        publication_.publish(publication_top_, publication_sequence_);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// Read-only chains over the store serve blocks up to the published top.
+// The last overlapping write publishes the top with the next even sequence.
+void block_chain::publish_top() const
+{
+    if (settings_.read_only || settings_.publication_file.empty())
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(publication_write_mutex_);
+
+    if (publication_writers_ > 0 && --publication_writers_ > 0)
+        return;
+
+    get_top(publication_top_);
+    publication_sequence_ = (publication_sequence_ | 1u) + 1u;
+    publication_.publish(publication_top_, publication_sequence_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// A read-only chain follows the top published by the writer of the store.
+// The indexes are extended from the store when the published top advances,
+// and rebuilt if the previous top is no longer in the store (reorganized).
+// The refresh is sequenced by the publication as any other read, and the
+// chain state is repopulated at the new top.
+void block_chain::refresh_publication() const
+{
+    const auto now = asio::steady_clock::now();
+    checkpoint top;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    // Concurrent readers do not wait on a refresh in progress.
+    unique_lock lock(publication_mutex_, boost::try_to_lock);
+
+    if (!lock.owns_lock() || now < published_time_ + publication_interval)
+        return;
+
+    published_time_ = now;
+    const auto sequence = read_publication(top);
+
+    if (is_write_locked(sequence) || top == published_)
+        return;
+
+    const auto previous = published_;
+    const auto result = database_.blocks().get(previous.height());
+    const auto extends = previous.height() <= top.height() && result &&
+        result.hash() == previous.hash();
+
+    std::vector<chain::header> headers;
+
+    if (extends)
+    {
+        for (auto height = previous.height() + 1u; height <= top.height();
+            ++height)
+        {
+            const auto block = database_.blocks().get(height);
+
+            if (!block)
+                break;
+
+            headers.push_back(block.header());
+        }
+    }
+
+    // A write has begun since the sequence was read, retry on next read.
+    if (!is_read_valid(sequence))
+    {
+        published_time_ = {};
+        return;
+    }
+
+    if (extends)
+    {
+        auto height = previous.height();
+
+        for (const auto& header: headers)
+        {
+            header_cache_.push(header, ++height);
+            header_index_.push(header, height);
+        }
+
+        // Stealth rows are not derived from the store (full blocks).
+        stealth_index_.clear();
+        index_work();
+    }
+    else
+    {
+        reindex();
+    }
+
+    // A write during a rebuild leaves the indexes unknown, rebuild again.
+    if (!is_read_valid(sequence))
+    {
+        published_ = {};
+        published_time_ = {};
+        return;
+    }
+
+    published_ = top;
+    published_height_ = top.height();
+
+    // The chain state follows the bounded top (get_last_height).
+    unique_lock state_lock(pool_state_mutex_);
+    pool_state_ = chain_state_populator_.populate();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// Rebuild the in-memory indexes from the store.
+void block_chain::reindex() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    work_mutex_.lock();
+    work_.clear();
+    work_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    index_work();
+    header_cache_.clear();
+    populate_header_cache();
+    header_index_.clear();
+    populate_header_index();
+    relay_cache_.pop_above(0);
+    stealth_index_.clear();
+}
+
+// private.
+// Extend the cumulative work index with contiguous blocks from the store.
+void block_chain::index_work() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(work_mutex_);
+
+    for (auto height = work_.size(); true; ++height)
+    {
+        const auto result = database_.blocks().get(height);
+
+        if (!result)
+            break;
+
+        const auto previous = work_.empty() ? uint256_t(0) : work_.back();
+        work_.push_back(previous + chain::block::proof(result.bits()));
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// Unwind the cumulative work index to the fork point and add the incoming.
+void block_chain::index_work(size_t fork_height,
+    block_const_ptr_list_const_ptr incoming)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(work_mutex_);
+
+    // The index is rebuilt on the next insert if it did not reach the fork.
+    if (work_.size() <= fork_height)
+        return;
+
+    work_.resize(fork_height + 1u);
+    work_.reserve(work_.size() + incoming->size());
+
+    for (const auto block: *incoming)
+        work_.push_back(work_.back() + block->proof());
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private.
+// Record process memory after a block write and enforce the memory budget.
+void block_chain::sample_memory() const
+{
+    memory_advisor::usage usage;
+
+    if (!memory_advisor::sample(usage))
+        return;
+
+    metrics_.resident.record(usage.resident_bytes / (1024u * 1024u));
+    metrics_.minor_faults.record(floor_subtract(usage.minor_faults,
+        memory_usage_.minor_faults));
+    metrics_.major_faults.record(floor_subtract(usage.major_faults,
+        memory_usage_.major_faults));
+    memory_usage_ = usage;
+    uint64_t store_bytes;
+
+    if (memory_advisor_.enforce(store_bytes))
+        LOG_DEBUG(LOG_BLOCKCHAIN)
+            << "Paged out the store at store resident size ("
+            << store_bytes / (1024u * 1024u) << "MB).";
+}
+
+// private.
+// Index the stored unconfirmed txs, stored height is the validation forks.
+void block_chain::populate_transaction_pool()
+{
+    const auto& transactions = database_.transactions();
+
+    database_.transactions_unconfirmed().for_each(
+        [&](const chain::transaction& tx)
+        {
+            unspent_filter_.add(tx.hash());
+            const auto result = transactions.get(tx.hash(), max_size_t,
+                false);
+            const auto unconfirmed = transaction_database::unconfirmed;
+
+            if (result && result.position() == unconfirmed)
+                transaction_pool_.add(tx,
+                    static_cast<uint32_t>(result.height()));
+
+            return true;
+        });
+}
+
+// private.
+// Seed the duplicate filter with the confirmed txs, after the pool txs.
+void block_chain::populate_unspent_filter()
+{
+    // The block duplicate check ends once collisions are allowed, so a scan
+    // of the store is not warranted and the filter remains inactive.
+    if (pool_state_->is_enabled(machine::rule_fork::allow_collisions))
+        return;
+
+    size_t top;
+
+    if (!get_last_height(top))
+        return;
+
+    for (size_t height = 0; height <= top; ++height)
+    {
+        const auto result = database_.blocks().get(height);
+
+        // The txs of blocks above a gap are not added, so remain inactive.
+        if (!result)
+            return;
+
+        const auto count = result.transaction_count();
+
+        for (size_t position = 0; position < count; ++position)
+            unspent_filter_.add(result.transaction_hash(position));
+
+        // A saturated filter reports every hash as a hit, so stop seeding.
+        if (unspent_filter_.saturated())
+            return;
+    }
+
+    unspent_filter_.activate();
+}
+
 // ============================================================================
 // SAFE CHAIN
 // ============================================================================
@@ -351,9 +992,54 @@ bool block_chain::start()
     if (!database_.open())
         return false;
 
+    // Advice applies to the mappings of the opened store.
+    memory_advisor_.advise();
+    memory_advisor_.prefault();
+    memory_advisor::sample(memory_usage_);
+
+    // A read-only chain has no organizers and does not own the snapshot.
+    // Without a publication reads are bounded by the store top at start,
+    // otherwise the first refresh rebuilds the indexes at the published top.
+    if (settings_.read_only)
+    {
+        checkpoint top;
+        reindex();
+        get_top(top);
+        published_height_ = top.height();
+        pool_state_ = chain_state_populator_.populate();
+        refresh_publication();
+        return static_cast<bool>(pool_state());
+    }
+
+    // Continue the sequence of any previous writer of the publication.
+    publication_sequence_ = read_publication(publication_top_);
+
+    // Restore the work index and header cache if snapshot at the same top.
+    const auto restored = restore_snapshot();
+
+    // Initialize cumulative work from the store, ending at any gap.
+    index_work();
+
+    // Initialize the header cache from the top of the store.
+    if (!restored)
+        populate_header_cache();
+
+    // Initialize the locator header index from the top of the store.
+    populate_header_index();
+
     // Initialize chain state after database start but before organizers.
     pool_state_ = chain_state_populator_.populate();
 
+    // Initialize the tx pool index before block population can use it.
+    populate_transaction_pool();
+
+    // Initialize the duplicate filter before organizers can query it.
+    if (pool_state_)
+        populate_unspent_filter();
+
+    // Read-only chains over the store may serve up to the current top.
+    publish_top();
+
     return pool_state_ && transaction_organizer_.start() &&
         block_organizer_.start();
 }
@@ -364,13 +1050,15 @@ bool block_chain::stop()
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
+    // Stop is admitted ahead of queued tx organization.
+    mutex_.lock_high_priority();
 
     // This cannot call organize or stop (lock safe).
     auto result = transaction_organizer_.stop() && block_organizer_.stop();
 
-    // The priority pool must not be stopped while organizing.
-    priority_pool_.shutdown();
+    // The priority pools must not be stopped while organizing.
+    pools_.shutdown();
+    mutex_.unlock_high_priority();
     return result;
     ///////////////////////////////////////////////////////////////////////////
 }
@@ -380,7 +1068,11 @@ bool block_chain::stop()
 bool block_chain::close()
 {
     const auto result = stop();
-    priority_pool_.join();
+    pools_.join();
+
+    if (!settings_.read_only)
+        save_snapshot();
+
     return result && database_.close();
 }
 
@@ -404,28 +1096,16 @@ void block_chain::fetch_block(size_t height, block_fetch_handler handler) const
     {
         const auto block_result = database_.blocks().get(height);
 
-        if (!block_result)
+        if (!block_result || !is_published(block_result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
         const auto high = block_result.height();
-        const auto count = block_result.transaction_count();
         transaction::list transactions;
-        transactions.reserve(count);
-
-        for (size_t position = 0; position < count; ++position)
-        {
-            const auto tx_result = database_.transactions().get(
-                block_result.transaction_hash(position), max_size_t, true);
 
-            if (!tx_result)
-                return finish_read(slock, handler, error::operation_failed,
+        if (!to_transactions(transactions, block_result))
+            return finish_read(slock, handler, error::operation_failed,
                 nullptr, 0);
 
-            BITCOIN_ASSERT(tx_result.height() == high);
-            BITCOIN_ASSERT(tx_result.position() == position);
-            transactions.emplace_back(tx_result.transaction());
-        }
-
         const auto block = std::make_shared<message::block>(
             block_result.header(), std::move(transactions));
         return finish_read(slock, handler, error::success, block, high);
@@ -446,27 +1126,15 @@ void block_chain::fetch_block(const hash_digest& hash,
     {
         const auto block_result = database_.blocks().get(hash);
 
-        if (!block_result)
+        if (!block_result || !is_published(block_result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
         const auto high = block_result.height();
-        const auto count = block_result.transaction_count();
         transaction::list transactions;
-        transactions.reserve(count);
-
-        for (size_t position = 0; position < count; ++position)
-        {
-            const auto tx_result = database_.transactions().get(
-                block_result.transaction_hash(position), max_size_t, true);
 
-            if (!tx_result)
-                return finish_read(slock, handler, error::operation_failed,
-                    nullptr, 0);
-
-            BITCOIN_ASSERT(tx_result.height() == high);
-            BITCOIN_ASSERT(tx_result.position() == position);
-            transactions.emplace_back(tx_result.transaction());
-        }
+        if (!to_transactions(transactions, block_result))
+            return finish_read(slock, handler, error::operation_failed,
+                nullptr, 0);
 
         const auto block = std::make_shared<message::block>(
             block_result.header(), std::move(transactions));
@@ -475,8 +1143,8 @@ void block_chain::fetch_block(const hash_digest& hash,
     read_serial(do_fetch);
 }
 
-void block_chain::fetch_block_header(size_t height,
-    block_header_fetch_handler handler) const
+void block_chain::fetch_block_data(size_t height,
+    block_data_fetch_handler handler) const
 {
     if (stopped())
     {
@@ -488,19 +1156,18 @@ void block_chain::fetch_block_header(size_t height,
     {
         const auto result = database_.blocks().get(height);
 
-        if (!result)
+        if (!result || !is_published(result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
-        const auto header = std::make_shared<message::header>(result.header());
-
-        return finish_read(slock, handler, error::success, header,
-            result.height());
+        const auto data = to_data(result);
+        const auto ec = data ? error::success : error::operation_failed;
+        return finish_read(slock, handler, ec, data, result.height());
     };
     read_serial(do_fetch);
 }
 
-void block_chain::fetch_block_header(const hash_digest& hash,
-    block_header_fetch_handler handler) const
+void block_chain::fetch_block_data(const hash_digest& hash,
+    block_data_fetch_handler handler) const
 {
     if (stopped())
     {
@@ -512,19 +1179,18 @@ void block_chain::fetch_block_header(const hash_digest& hash,
     {
         const auto result = database_.blocks().get(hash);
 
-        if (!result)
+        if (!result || !is_published(result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
-        const auto header = std::make_shared<message::header>(result.header());
-
-        return finish_read(slock, handler, error::success, header,
-            result.height());
+        const auto data = to_data(result);
+        const auto ec = data ? error::success : error::operation_failed;
+        return finish_read(slock, handler, ec, data, result.height());
     };
     read_serial(do_fetch);
 }
 
-// void block_chain::fetch_merkle_block(size_t height, transaction_hashes_fetch_handler handler) const
-void block_chain::fetch_merkle_block(size_t height, merkle_block_fetch_handler handler) const
+void block_chain::fetch_block_header(size_t height,
+    block_header_fetch_handler handler) const
 {
     if (stopped())
     {
@@ -536,20 +1202,19 @@ void block_chain::fetch_merkle_block(size_t height, merkle_block_fetch_handler h
     {
         const auto result = database_.blocks().get(height);
 
-        if (!result)
+        if (!result || !is_published(result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
-        const auto merkle = std::make_shared<merkle_block>(result.header(),
-            result.transaction_count(), to_hashes(result), data_chunk{});
+        const auto header = std::make_shared<message::header>(result.header());
 
-        return finish_read(slock, handler, error::success, merkle,
+        return finish_read(slock, handler, error::success, header,
             result.height());
     };
     read_serial(do_fetch);
 }
 
-void block_chain::fetch_merkle_block(const hash_digest& hash,
-    merkle_block_fetch_handler handler) const
+void block_chain::fetch_block_header(const hash_digest& hash,
+    block_header_fetch_handler handler) const
 {
     if (stopped())
     {
@@ -561,30 +1226,108 @@ void block_chain::fetch_merkle_block(const hash_digest& hash,
     {
         const auto result = database_.blocks().get(hash);
 
-        if (!result)
+        if (!result || !is_published(result.height()))
             return finish_read(slock, handler, error::not_found, nullptr, 0);
 
-        const auto merkle = std::make_shared<merkle_block>(result.header(),
-            result.transaction_count(), to_hashes(result), data_chunk{});
+        const auto header = std::make_shared<message::header>(result.header());
 
-        return finish_read(slock, handler, error::success, merkle,
+        return finish_read(slock, handler, error::success, header,
             result.height());
     };
     read_serial(do_fetch);
 }
 
+// Merkle and compact blocks are built from cached relay artifacts.
+void block_chain::fetch_merkle_block(size_t height,
+    merkle_block_fetch_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr, 0);
+        return;
+    }
+
+    const auto relay = get_relay(height);
+
+    if (!relay)
+    {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
+
+    const auto merkle = std::make_shared<merkle_block>(relay->header,
+        relay->hashes.size(), relay->hashes, data_chunk{});
+
+    handler(error::success, merkle, relay->height);
+}
+
+void block_chain::fetch_merkle_block(const hash_digest& hash,
+    merkle_block_fetch_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr, 0);
+        return;
+    }
+
+    const auto relay = get_relay(hash);
+
+    if (!relay)
+    {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
+
+    const auto merkle = std::make_shared<merkle_block>(relay->header,
+        relay->hashes.size(), relay->hashes, data_chunk{});
+
+    handler(error::success, merkle, relay->height);
+}
+
 void block_chain::fetch_compact_block(size_t height,
     compact_block_fetch_handler handler) const
 {
-    // TODO: implement compact blocks.
-    handler(error::not_implemented, {}, 0);
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr, 0);
+        return;
+    }
+
+    const auto relay = get_relay(height);
+
+    if (!relay)
+    {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
+
+    const auto compact = std::make_shared<compact_block>(relay->header,
+        relay->nonce, relay->short_ids, relay->prefilled);
+
+    handler(error::success, compact, relay->height);
 }
 
 void block_chain::fetch_compact_block(const hash_digest& hash,
     compact_block_fetch_handler handler) const
 {
-    // TODO: implement compact blocks.
-    handler(error::not_implemented, {}, 0);
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr, 0);
+        return;
+    }
+
+    const auto relay = get_relay(hash);
+
+    if (!relay)
+    {
+        handler(error::not_found, nullptr, 0);
+        return;
+    }
+
+    const auto compact = std::make_shared<compact_block>(relay->header,
+        relay->nonce, relay->short_ids, relay->prefilled);
+
+    handler(error::success, compact, relay->height);
 }
 
 void block_chain::fetch_block_height(const hash_digest& hash,
@@ -599,7 +1342,7 @@ void block_chain::fetch_block_height(const hash_digest& hash,
     const auto do_fetch = [&](size_t slock)
     {
         const auto result = database_.blocks().get(hash);
-        return result ?
+        return result && is_published(result.height()) ?
             finish_read(slock, handler, error::success, result.height()) :
             finish_read(slock, handler, error::not_found, 0);
     };
@@ -617,7 +1360,7 @@ void block_chain::fetch_last_height(last_height_fetch_handler handler) const
     const auto do_fetch = [&](size_t slock)
     {
         size_t last_height;
-        return database_.blocks().top(last_height) ?
+        return get_last_height(last_height) ?
             finish_read(slock, handler, error::success, last_height) :
             finish_read(slock, handler, error::not_found, 0);
     };
@@ -638,7 +1381,7 @@ void block_chain::fetch_transaction(const hash_digest& hash,
         const auto result = database_.transactions().get(hash, max_size_t,
             require_confirmed);
 
-        if (!result)
+        if (!result || !is_published(result))
             return finish_read(slock, handler, error::not_found, nullptr, 0, 0);
 
         const auto tx = std::make_shared<transaction>(result.transaction());
@@ -648,6 +1391,34 @@ void block_chain::fetch_transaction(const hash_digest& hash,
     read_serial(do_fetch);
 }
 
+void block_chain::fetch_transaction_data(const hash_digest& hash,
+    bool require_confirmed, transaction_data_fetch_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, nullptr, 0, 0);
+        return;
+    }
+
+    const auto do_fetch = [&](size_t slock)
+    {
+        const auto result = database_.transactions().get(hash, max_size_t,
+            require_confirmed);
+
+        if (!result || !is_published(result))
+            return finish_read(slock, handler, error::not_found, nullptr, 0, 0);
+
+        // The store record interleaves spender heights with the outputs, so
+        // the tx is deserialized and reserialized, not copied from the map.
+        // The buffer is written once and shared read-only with the caller.
+        const auto data = std::make_shared<const data_chunk>(
+            result.transaction().to_data());
+        return finish_read(slock, handler, error::success, data,
+            result.height(), result.position());
+    };
+    read_serial(do_fetch);
+}
+
 
 hash_digest generate_merkle_root(std::vector<chain::transaction> transactions) {
     if (transactions.empty())
@@ -769,141 +1540,126 @@ std::pair<bool, size_t> block_chain::validate_tx(chain::transaction const& tx) c
     auto tx_result = database_.transactions().get(tx.hash(),libbitcoin::max_size_t,false);
     if (!tx_result) {
         //TX NOT FOUND
-        //std::cout << "TX RESULT NOT FOUND \n";
         return std::make_pair(false, 0);
     }
 
-    auto tx_generated = tx_result.transaction();
-//        if (tx_generated.is_missing_previous_outputs() ||
-//                tx_generated.is_double_spend(true) ||
-//                tx_generated.signature_operations(true) > max_block_sigops) {
-
     size_t height;
-    if (database_.blocks().top(height)){
-        //TODO: create a new function to get current time
-        auto const now = std::chrono::high_resolution_clock::now();
-        auto time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
-        if (!tx_generated.is_final(height+1, time)){
-            return std::make_pair(false, 0);
+    if (!database_.blocks().top(height)) {
+        return std::make_pair(false, 0);
+    }
+
+    auto const res = validate_tx_2(tx_result.transaction(), height);
+    return std::make_pair(std::get<0>(res), std::get<1>(res));
+}
+
+// Each prevout is resolved once (into its validation cache), and the double
+// spend, sigops and fees are all evaluated from that cache in the same pass.
+// The result is (double spent or invalid, sigops, fees).
+std::tuple<bool, size_t, uint64_t> block_chain::is_double_spent_sigops_and_fees(chain::transaction const& tx, bool bip16_active) const {
+
+    size_t inputs_sigops = 0;
+    uint64_t total = 0;
+
+    for (auto const& input : tx.inputs()) {
+        auto const& outpoint = input.previous_output();
+        auto& prevout = outpoint.validation;
+        prevout.cache = chain::output{};
+
+        // A coinbase input is invalid outside of its block.
+        if (outpoint.is_null()) {
+            return std::make_tuple(true, 0, 0);
+        }
+
+        size_t output_height;
+        bool output_coinbase;
+
+        if (!get_output(prevout.cache, output_height, output_coinbase, outpoint, max_size_t, true)) {
+            return std::make_tuple(true, 0, 0);
+        }
+
+        // The genesis block coinbase may not be spent.
+        if (output_height == 0) {
+            return std::make_tuple(true, 0, 0);
+        }
+
+        if (prevout.cache.validation.spender_height != chain::output::validation::not_spent) {
+            return std::make_tuple(true, 0, 0);
         }
+
+        inputs_sigops += input.script().sigops(false);
+
+        if (bip16_active) {
+            // This cannot overflow because each total is limited by max ops.
+            inputs_sigops += input.script().embedded_sigops(prevout.cache.script());
+        }
+
+        total = ceiling_add(total, prevout.cache.value());
+    }
+
+    auto const out = [](size_t total, const chain::output& output) {
+        return ceiling_add(total, output.signature_operations());
+    };
+
+    auto const sigops_total = inputs_sigops + std::accumulate(tx.outputs().begin(), tx.outputs().end(), size_t{0}, out);
+    return std::make_tuple(false, sigops_total, floor_subtract(total, tx.total_output_value()));
+}
+
+// Single-pass evaluation of a stored unconfirmed tx for the next block.
+// The result is (valid, sigops, fees, serialized size).
+std::tuple<bool, size_t, uint64_t, size_t> block_chain::validate_tx_2(chain::transaction const& tx, size_t height) const {
+
+    if (!is_final_standard(tx, height)) {
+        return std::make_tuple(false, 0, 0, 0);
     }
 
-    auto res = is_double_spent_and_sigops(tx_generated, true);
-    if (res.first || res.second > max_block_sigops) {
+    auto const res = is_double_spent_sigops_and_fees(tx, true);
+    if (std::get<0>(res) || std::get<1>(res) > max_block_sigops) {
+        return std::make_tuple(false, 0, 0, 0);
+    }
 
-        //TX ERROR, TODO DELETE THIS TX
-//            std::cout << "TX ERROR IS DOUBLE SPEND OR TOTAL SIGNATURE OPERATIONS ERROR\n";
+    return std::make_tuple(true, std::get<1>(res), std::get<2>(res), tx.serialized_size(true));
+}
 
-//            is_missing_previous_outputs(tx_generated);
+// The template filters common to the pool and store entries: the tx must be
+// final in the next block and all of its scripts must be standard.
+bool block_chain::is_final_standard(chain::transaction const& tx, size_t height) const {
 
-        return std::make_pair(false, 0);
+    //TODO: create a new function to get current time
+    auto const now = std::chrono::high_resolution_clock::now();
+    auto const time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
+    if (!tx.is_final(height + 1, time)) {
+        return false;
     }
-    for (auto const& in : tx_generated.inputs()) {
-        if ( in.script().pattern() == libbitcoin::machine::script_pattern::non_standard){
-            return std::make_pair(false, 0);
+
+    for (auto const& in : tx.inputs()) {
+        if (in.script().pattern() == libbitcoin::machine::script_pattern::non_standard) {
+            return false;
         }
     }
 
-    for (auto const& out : tx_generated.outputs()) {
-        if ( out.script().pattern() == libbitcoin::machine::script_pattern::non_standard){
-            return std::make_pair(false, 0);
+    for (auto const& out : tx.outputs()) {
+        if (out.script().pattern() == libbitcoin::machine::script_pattern::non_standard) {
+            return false;
         }
     }
 
-    return std::make_pair(true,res.second);
+    return true;
 }
 
-////TODO: verify if it's ok. this fuction reduce the get_outputs call to 1
-//std::tuple<bool, size_t, uint64_t> block_chain::is_double_spent_sigops_and_fees(chain::transaction const& tx, bool bip16_active) const {
-//
-//    size_t inputs_sigops = 0;
-//    uint64_t total = 0;
-//
-//    for (auto const& input : tx.inputs()) {
-//
-//        if (input.script().pattern() == libbitcoin::machine::script_pattern::non_standard) {
-//            return std::make_tuple(true, 0, 0);
-//        }
-//
-//        auto const& outpoint = input.previous_output();
-//        auto& prevout = outpoint.validation;
-//        prevout.cache = chain::output{};
-//
-//        // If the input is a coinbase there is no prevout to populate.
-//        if (outpoint.is_null()) return std::make_tuple(true, 0, 0);
-//
-//
-//        size_t output_height;
-//        bool output_coinbase;
-//
-//        if (!get_output(prevout.cache, output_height, output_coinbase, outpoint, max_size_t, true)) {
-//            return std::make_tuple(true, 0, 0);
-//        }
-//
-//        if ( output_height == 0)  return std::make_tuple(true, 0, 0);
-//
-//        const auto spend_height = prevout.cache.validation.spender_height;
-//
-//        if (
-//            //(spend_height <= branch_height) &&
-//                (spend_height != chain::output::validation::not_spent))
-//        {
-//            return std::make_tuple(true, 0, 0);
-//        }
-//
-//        inputs_sigops += input.script().sigops(false);
-//
-//        if (bip16_active) {
-//            // This cannot overflow because each total is limited by max ops.
-//            const auto& cache = prevout.cache.script();
-//            inputs_sigops += input.script().embedded_sigops(cache);
-//        }
-//
-//        const bool missing = !prevout.cache.is_valid();
-//        total = ceiling_add(total, missing ? 0 : prevout.cache.value());
-//    }
-//
-//    for (auto const& out : tx.outputs()) {
-//        if (out.script().pattern() == libbitcoin::machine::script_pattern::non_standard) {
-//            std::make_tuple(true, 0, 0);
-//        }
-//    }
-//
-//    const auto out = [](size_t total, const chain::output& output) {
-//        return ceiling_add(total, output.signature_operations());
-//    };
-//
-//    return std::make_tuple(false,
-//           inputs_sigops + std::accumulate(tx.outputs().begin(), tx.outputs().end(), size_t{0}, out),
-//           floor_subtract(total, tx.total_output_value()));
-//
-//}
-//
-//std::tuple<bool, size_t, uint64_t> block_chain::validate_tx_2(chain::transaction const& tx, size_t height) const {
-//
-//
-//    auto tx_result = database_.transactions().get(tx.hash(),libbitcoin::max_size_t, false);
-//
-//    if (!tx_result) {
-//        std::make_tuple(false, 0, 0);
-//    }
-//
-//    //TODO: create a new function to get current time
-//    auto const now = std::chrono::high_resolution_clock::now();
-//    auto time = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count());
-//    if (!tx_result.transaction().is_final(height+1, time)){
-//        std::make_tuple(false, 0, 0);
-//    }
-//
-//    auto tx_generated = tx_result.transaction();
-//    auto res = is_double_spent_sigops_and_fees(tx_generated, true);
-//    if (std::get<0>(res) || std::get<1>(res) > max_block_sigops) {
-//
-//        std::make_tuple(false, 0, 0);
-//    }
-//
-//    std::make_tuple(true, std::get<1>(res), std::get<2>(res));
-//}
+// The template is filled by fee rate without dependency order, so as with
+// store entries (require_confirmed) a tx that spends a pooled parent is
+// excluded, otherwise a child could precede or lack its parent.
+bool block_chain::is_confirmed_spend(chain::transaction const& tx) const {
+    auto const& transactions = database_.transactions();
+
+    for (auto const& input : tx.inputs()) {
+        if (!transactions.get(input.previous_output().hash(), max_size_t, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
 
 void append_spend(chain::transaction const& tx, spent_container & result) {
     for (auto const& input : tx.inputs()) {
@@ -916,7 +1672,9 @@ bool is_double_spend_mempool(chain::transaction const& tx, spent_container const
     for (auto const& input : tx.inputs()) {
         auto const& output_point = input.previous_output();
         auto res = result.find(std::make_pair(output_point.hash(), output_point.index()));
-        return res != result.end();
+        if (res != result.end()) {
+            return true;
+        }
     }
     return false;
 }
@@ -936,22 +1694,44 @@ std::vector<block_chain::tx_mempool> block_chain::fetch_mempool_all(size_t max_b
     spent_container spent;
     mempool.reserve(7000);
 
+    // Pool validated entries are maintained on reorganization (confirmed and
+    // conflicting entries are removed), so fees and sigops are cached.
+    auto const validated = transaction_pool_.get_validated();
+    std::unordered_set<hash_digest> cached;
+    cached.reserve(validated.size());
+
+    for (auto const& entry : validated) {
+        if (mempool.size() > 7000) {
+            break;
+        }
+        auto const& tx = *entry->transaction();
+        cached.insert(entry->hash());
+
+        if (!is_final_standard(tx, height) || !is_confirmed_spend(tx)) {
+            continue;
+        }
+
+        append_spend(tx, spent);
+        std::string dependencies = ""; //TODO: see what to do with the final algorithm
+        mempool.emplace_back(tx, entry->fees(), entry->sigops(), dependencies, entry->size());
+    }
+
+    // Only the remainder (restored or indexed at startup) is revalidated.
     database_.transactions_unconfirmed().for_each([&](chain::transaction const& tx) {
         if (mempool.size() > 7000){
             return false;
         }
-        auto res_validate = validate_tx(tx);
-        auto res_ds = is_double_spend_mempool(tx, spent);
-        if (res_validate.first && !res_ds) {
+        if (cached.find(tx.hash()) != cached.end()) {
+            return true;
+        }
+        if (is_double_spend_mempool(tx, spent)) {
+            return true;
+        }
+        auto const res_validate = validate_tx_2(tx, height);
+        if (std::get<0>(res_validate)) {
             append_spend(tx, spent);
-            auto fee_result = block_chain::fees(tx);
-            if (fee_result.first) {
-                auto fee = fee_result.second;
-                uint64_t sigops = res_validate.second;
-                std::string dependencies = ""; //TODO: see what to do with the final algorithm
-                size_t tx_weight = tx.to_data(true).size();
-                mempool.emplace_back(tx, fee, sigops, dependencies, tx_weight);
-            }
+            std::string dependencies = ""; //TODO: see what to do with the final algorithm
+            mempool.emplace_back(tx, std::get<2>(res_validate), std::get<1>(res_validate), dependencies, std::get<3>(res_validate));
         }
         return true;
     });
@@ -1018,7 +1798,7 @@ void block_chain::fetch_transaction_position(const hash_digest& hash,
         auto result = database_.transactions().get(hash, max_size_t,
             require_confirmed);
 
-        return result ?
+        return result && is_published(result) ?
             finish_read(slock, handler, error::success, result.position(),
                 result.height()) :
             finish_read(slock, handler, error::not_found, 0, 0);
@@ -1040,7 +1820,7 @@ void block_chain::fetch_output(const chain::output_point& outpoint,
         const auto result = database_.transactions().get(outpoint.hash(),
             max_size_t, require_confirmed);
 
-        if (!result)
+        if (!result || !is_published(result))
             return finish_read(slock, handler, error::not_found,
                 chain::output{});
 
@@ -1062,7 +1842,18 @@ void block_chain::fetch_spend(const chain::output_point& outpoint,
 
     const auto do_fetch = [&](size_t slock)
     {
-        const auto point = database_.spends().get(outpoint);
+        auto point = database_.spends().get(outpoint);
+
+        // A spend confirmed above the published top is not served.
+        if (settings_.read_only && point.hash() != null_hash)
+        {
+            const auto spender = database_.transactions().get(point.hash(),
+                max_size_t, false);
+
+            if (!spender || !is_published(spender))
+                point = {};
+        }
+
         return point.hash() != null_hash ?
             finish_read(slock, handler, error::success, point) :
             finish_read(slock, handler, error::not_found, point);
@@ -1075,18 +1866,109 @@ void block_chain::fetch_history(const wallet::payment_address& address,
 {
     if (stopped())
     {
-        handler(error::service_stopped, {});
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    const auto do_fetch = [&](size_t slock)
+    {
+        auto rows = database_.history().get(address.hash(), limit,
+            from_height);
+
+        // Rows confirmed above the published top are not served.
+        const auto unpublished = [this](const chain::history_compact& row)
+        {
+            return !is_published(row.height);
+        };
+
+        rows.erase(std::remove_if(rows.begin(), rows.end(), unpublished),
+            rows.end());
+        return finish_read(slock, handler, error::success, rows);
+    };
+    read_serial(do_fetch);
+}
+
+// A writer interrupts only the read being made, so a large query is not
+// restarted by each write. Rows at or below the anchor do not change while the
+// anchor is in the chain, so rows read ahead are delivered over later pages
+// and the store is rescanned only once per read ahead rather than per page.
+// A page smaller than the page size is the last.
+void block_chain::fetch_history(const wallet::payment_address& address,
+    size_t page_size, const history_cursor& cursor,
+    history_page_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped, {}, cursor);
         return;
     }
 
-    const auto do_fetch = [&](size_t slock)
+    if (page_size == 0)
     {
-        return finish_read(slock, handler, error::success,
-            database_.history().get(address.hash(), limit, from_height));
-    };
-    read_serial(do_fetch);
+        handler(error::operation_failed, {}, cursor);
+        return;
+    }
+
+    const auto key = address.hash();
+    const auto read_limit = std::max(page_size, maximum_history_read_ahead);
+    auto read_ahead = page_size;
+    auto complete = false;
+    size_t offset = 0;
+    chain::history_compact::list ahead;
+    auto next = cursor;
+
+    while (!stopped())
+    {
+        code ec;
+        auto read_cursor = next;
+        auto read_complete = complete;
+        chain::history_compact::list rows;
+        const auto refill = !complete && ahead.size() - offset < page_size;
+
+        // The anchor is verified for each page, including buffered pages.
+        const auto do_fetch = [&](size_t slock)
+        {
+            read_cursor = next;
+            ec = refill ?
+                read_history(rows, read_complete, read_cursor, key,
+                    read_ahead) :
+                read_anchor(read_cursor);
+            return is_read_valid(slock);
+        };
+        read_serial(do_fetch);
+
+        if (ec)
+        {
+            handler(ec, {}, next);
+            return;
+        }
+
+        if (refill)
+        {
+            ahead = std::move(rows);
+            offset = 0;
+            complete = read_complete;
+            read_ahead = std::min(2u * read_ahead, read_limit);
+        }
+
+        const auto end = std::min(ahead.size(), offset + page_size);
+        const chain::history_compact::list page(ahead.begin() + offset,
+            ahead.begin() + end);
+
+        offset = end;
+        next = read_cursor;
+        next.delivered += page.size();
+        const auto last = page.size() < page_size;
+
+        if (!handler(error::success, page, next) || last)
+            return;
+    }
+
+    handler(error::service_stopped, {}, next);
 }
 
+// Heights covered by the stealth index are not read from the store, so the
+// query is not restarted by writes. Others fall back to the store scan.
 void block_chain::fetch_stealth(const binary& filter, size_t from_height,
     stealth_fetch_handler handler) const
 {
@@ -1096,10 +1978,31 @@ void block_chain::fetch_stealth(const binary& filter, size_t from_height,
         return;
     }
 
+    chain::stealth_compact::list rows;
+
+    if (scan_stealth(rows, filter, from_height))
+    {
+        handler(error::success, rows);
+        return;
+    }
+
     const auto do_fetch = [&](size_t slock)
     {
-        return finish_read(slock, handler, error::success,
-            database_.stealth().scan(filter, from_height));
+        rows = database_.stealth().scan(filter, from_height);
+
+        // Rows are not of a height, so a read-only chain reads each tx.
+        const auto unpublished = [this](const chain::stealth_compact& row)
+        {
+            const auto result = database_.transactions().get(
+                row.transaction_hash, max_size_t, true);
+            return !result || !is_published(result);
+        };
+
+        if (settings_.read_only)
+            rows.erase(std::remove_if(rows.begin(), rows.end(), unpublished),
+                rows.end());
+
+        return finish_read(slock, handler, error::success, rows);
     };
     read_serial(do_fetch);
 }
@@ -1132,7 +2035,7 @@ void block_chain::fetch_block_locator(const block::indexes& heights,
         {
             const auto result = database_.blocks().get(height);
 
-            if (!result)
+            if (!result || !is_published(height))
             {
                 ec = error::not_found;
                 hashes.clear();
@@ -1167,14 +2070,8 @@ void block_chain::fetch_locator_block_hashes(get_blocks_const_ptr locator,
         // If no start block is on our chain we start with block 0.
         size_t start = 0;
         for (const auto& hash: locator->start_hashes())
-        {
-            const auto result = database_.blocks().get(hash);
-            if (result)
-            {
-                start = result.height();
+            if (get_published_height(start, hash))
                 break;
-            }
-        }
 
         // Find the stop block height.
         // The maximum stop block is 501 blocks after start (to return 500).
@@ -1184,26 +2081,38 @@ void block_chain::fetch_locator_block_hashes(get_blocks_const_ptr locator,
         if (locator->stop_hash() != null_hash)
         {
             // If the stop block is not on chain we treat it as a null stop.
-            const auto stop_result = database_.blocks().get(locator->stop_hash());
-            if (stop_result)
-                stop = std::min(stop_result.height(), stop);
+            size_t stop_height;
+            if (get_height(stop_height, locator->stop_hash()))
+                stop = std::min(stop_height, stop);
         }
 
+        // Blocks above the published top are not served.
+        const size_t published = published_height_;
+        stop = std::min(stop, ceiling_add(published, size_t(1)));
+
         // Find the threshold block height.
         // If the threshold is above the start it becomes the new start.
         if (threshold != null_hash)
         {
-            const auto start_result = database_.blocks().get(threshold);
-            if (start_result)
-                start = std::max(start_result.height(), start);
+            size_t threshold_height;
+            if (get_published_height(threshold_height, threshold))
+                start = std::max(threshold_height, start);
         }
 
         auto hashes = std::make_shared<inventory>();
         const auto size = floor_subtract(stop, begin);
         hashes->inventories().reserve(size);
 
+        // Copy the indexed heights in one pass, then read any from the store.
+        hash_list indexed;
+        auto index = begin + header_index_.get(indexed, begin, size);
+        static const auto id = inventory::type_id::block;
+
+        for (const auto& hash: indexed)
+            hashes->inventories().push_back({ id, hash });
+
         // Build the hash list until we hit last or the blockchain top.
-        for (auto index = begin; index < stop; ++index)
+        for (; index < stop; ++index)
         {
             const auto result = database_.blocks().get(index);
 
@@ -1212,7 +2121,6 @@ void block_chain::fetch_locator_block_hashes(get_blocks_const_ptr locator,
                 break;
 
             const auto& header = result.header();
-            static const auto id = inventory::type_id::block;
             hashes->inventories().push_back({ id, header.hash() });
         }
 
@@ -1243,14 +2151,8 @@ void block_chain::fetch_locator_block_headers(get_headers_const_ptr locator,
         // If no start block is on our chain we start with block 0.
         size_t start = 0;
         for (const auto& hash: locator->start_hashes())
-        {
-            const auto result = database_.blocks().get(hash);
-            if (result)
-            {
-                start = result.height();
+            if (get_published_height(start, hash))
                 break;
-            }
-        }
 
         // Find the stop block height.
         // The maximum stop block is 501 blocks after start (to return 500).
@@ -1260,20 +2162,22 @@ void block_chain::fetch_locator_block_headers(get_headers_const_ptr locator,
         if (locator->stop_hash() != null_hash)
         {
             // If the stop block is not on chain we treat it as a null stop.
-            const auto stop_result = database_.blocks().get(
-                locator->stop_hash());
-
-            if (stop_result)
-                stop = std::min(stop_result.height(), stop);
+            size_t stop_height;
+            if (get_height(stop_height, locator->stop_hash()))
+                stop = std::min(stop_height, stop);
         }
 
+        // Blocks above the published top are not served.
+        const size_t published = published_height_;
+        stop = std::min(stop, ceiling_add(published, size_t(1)));
+
         // Find the threshold block height.
         // If the threshold is above the start it becomes the new start.
         if (threshold != null_hash)
         {
-            const auto start_result = database_.blocks().get(threshold);
-            if (start_result)
-                start = std::max(start_result.height(), start);
+            size_t threshold_height;
+            if (get_published_height(threshold_height, threshold))
+                start = std::max(threshold_height, start);
         }
 
         //---------------------------------------------------------------------
@@ -1282,8 +2186,12 @@ void block_chain::fetch_locator_block_headers(get_headers_const_ptr locator,
         const auto size = floor_subtract(stop, begin);
         headers->elements().reserve(size);
 
+        // Copy the indexed heights in one pass, then read any from the store.
+        auto index = begin + header_index_.get(headers->elements(), begin,
+            size);
+
         // Build the hash list until we hit last or the blockchain top.
-        for (auto index = begin; index < stop; ++index)
+        for (; index < stop; ++index)
         {
             const auto result = database_.blocks().get(index);
 
@@ -1312,12 +2220,19 @@ void block_chain::fetch_template(merkle_block_fetch_handler handler) const
 
 // Fetch a set of currently-valid unconfirmed txs in dependency order.
 // All txs satisfy the fee minimum and are valid at the next chain state.
-// The set of blocks is limited in count to size. The set may have internal
+// The set of txs is limited in count to count_limit. The set may have internal
 // dependencies but all inputs must be satisfied at the current height.
+// The fee minimum is a package fee rate in satoshis per kilobyte.
 void block_chain::fetch_mempool(size_t count_limit, uint64_t minimum_fee,
     inventory_fetch_handler handler) const
 {
-    transaction_organizer_.fetch_mempool(count_limit, handler);
+    if (stopped())
+    {
+        handler(error::service_stopped, {});
+        return;
+    }
+
+    transaction_organizer_.fetch_mempool(count_limit, minimum_fee, handler);
 }
 
 // Filters.
@@ -1338,16 +2253,20 @@ void block_chain::filter_blocks(get_data_ptr message,
     {
         block_organizer_.filter(message);
 
-        auto& inventories = message->inventories();
         const auto& blocks = database_.blocks();
 
-        for (auto it = inventories.begin(); it != inventories.end();)
-            if (it->is_block_type() && blocks.get(it->hash()))
-                it = inventories.erase(it);
-            else
-                ++it;
+        const auto select = [](const inventory_vector& inventory)
+        {
+            return inventory.is_block_type();
+        };
 
+        const auto exists = [this, &blocks](const hash_digest& hash)
+        {
+            const auto result = blocks.get(hash);
+            return result && is_published(result.height());
+        };
 
+        filter_inventories(message->inventories(), select, exists);
         return finish_read(slock, handler, error::success);
     };
     read_serial(do_fetch);
@@ -1365,18 +2284,21 @@ void block_chain::filter_transactions(get_data_ptr message,
 
     const auto do_fetch = [this, message, handler](size_t slock)
     {
-        auto& inventories = message->inventories();
-        const auto& transactions = database_.transactions();
+        transaction_organizer_.filter(message);
 
-        for (auto it = inventories.begin(); it != inventories.end();)
+        const auto select = [](const inventory_vector& inventory)
         {
-            if (it->is_transaction_type() &&
-                get_is_unspent_transaction(it->hash(), max_size_t, false))
-                it = inventories.erase(it);
-            else
-                ++it;
-        }
+            return inventory.is_transaction_type();
+        };
+
+        // The pool is screened in memory before the store is probed.
+        const auto exists = [this](const hash_digest& hash)
+        {
+            return transaction_pool_.find(hash) ||
+                get_is_unspent_transaction(hash, published_height_, false);
+        };
 
+        filter_inventories(message->inventories(), select, exists);
         return finish_read(slock, handler, error::success);
     };
     read_serial(do_fetch);
@@ -1402,16 +2324,60 @@ void block_chain::subscribe_transaction(transaction_handler&& handler)
 
 void block_chain::organize(block_const_ptr block, result_handler handler)
 {
+    // A read-only chain has no organizers.
+    if (settings_.read_only)
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
     // This cannot call organize or stop (lock safe).
     block_organizer_.organize(block, handler);
 }
 
 void block_chain::organize(transaction_const_ptr tx, result_handler handler)
 {
+    // A read-only chain has no organizers.
+    if (settings_.read_only)
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
     // This cannot call organize or stop (lock safe).
     transaction_organizer_.organize(tx, handler);
 }
 
+void block_chain::validate_only(block_const_ptr block,
+    result_handler handler) const
+{
+    // A read-only chain has no organizers.
+    if (settings_.read_only)
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
+    // This takes the shared organizer critical section, so it cannot be called
+    // from an unqueued subscription handler (lock safe).
+    block_organizer_.validate_only(block, handler);
+}
+
+void block_chain::validate_only(transaction_const_ptr tx,
+    result_handler handler) const
+{
+    // A read-only chain has no organizers.
+    if (settings_.read_only)
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
+    // This takes the shared organizer critical section, so it cannot be called
+    // from an unqueued subscription handler (lock safe).
+    transaction_organizer_.validate_only(tx, handler);
+}
+
 // Properties (thread safe).
 // ----------------------------------------------------------------------------
 
@@ -1420,6 +2386,21 @@ const settings& block_chain::chain_settings() const
     return settings_;
 }
 
+size_t block_chain::read_retries() const
+{
+    return read_retries_;
+}
+
+size_t block_chain::read_waits() const
+{
+    return read_waits_;
+}
+
+chain_metrics& block_chain::metrics() const
+{
+    return metrics_;
+}
+
 // protected
 bool block_chain::stopped() const
 {
@@ -1433,18 +2414,198 @@ bool block_chain::stopped() const
 template <typename Reader>
 void block_chain::read_serial(const Reader& reader) const
 {
-    while (true)
+    // The writer of the store is not this instance, follow its publication.
+    if (settings_.read_only)
+        refresh_publication();
+
+    for (size_t attempt = 0; true; ++attempt)
     {
+        // Capture the write epoch before the read so no signal is missed.
+        const size_t epoch = write_epoch_;
+
         // Get a read handle.
-        const auto sequence = database_.begin_read();
+        const auto sequence = begin_read();
 
         // If read handle indicates write or reader finishes false, wait.
-        if (!database_.is_write_locked(sequence) && reader(sequence))
+        if (!is_write_locked(sequence) && reader(sequence))
+        {
+            metrics_.read_attempts.record(attempt + 1u);
             break;
+        }
+
+        ++read_retries_;
+
+        // Spin briefly as most writes are short, then wait for completion.
+        if (attempt < read_spin_limit)
+            std::this_thread::yield();
+        else
+            wait_write(epoch);
+    }
+}
+
+// The writer of a read-only chain is another process, so reads are sequenced
+// by its publication rather than by the (unwritten) local store.
+block_chain::handle block_chain::begin_read() const
+{
+    checkpoint top;
+    return settings_.read_only ? read_publication(top) :
+        database_.begin_read();
+}
+
+bool block_chain::is_write_locked(handle sequence) const
+{
+    return settings_.read_only ? (sequence % 2u) != 0 :
+        database_.is_write_locked(sequence);
+}
+
+bool block_chain::is_read_valid(handle sequence) const
+{
+    checkpoint top;
+    return settings_.read_only ? read_publication(top) == sequence :
+        database_.is_read_valid(sequence);
+}
+
+// An unpublished store is sequence zero (never written).
+block_chain::handle block_chain::read_publication(checkpoint& out_top) const
+{
+    uint64_t sequence;
+    return publication_.read(out_top, sequence) ?
+        static_cast<handle>(sequence) : 0;
+}
+
+// A read-only chain does not serve blocks above the published top, the top
+// of a writer's own chain is not bounded (max_size_t).
+bool block_chain::is_published(size_t height) const
+{
+    return height <= published_height_;
+}
+
+// Unconfirmed stored txs are of the pool, which is not bounded.
+bool block_chain::is_published(const transaction_result& result) const
+{
+    return result.position() == transaction_database::unconfirmed ||
+        is_published(result.height());
+}
+
+bool block_chain::get_published_height(size_t& out_height,
+    const hash_digest& block_hash) const
+{
+    size_t height;
+
+    if (!get_height(height, block_hash) || !is_published(height))
+        return false;
+
+    out_height = height;
+    return true;
+}
 
-        // Sleep while waiting for write to complete.
-        std::this_thread::sleep_for(spin_lock_sleep_);
+// Block until a write completes after the epoch (or the sleep interval).
+// The timeout covers store writes that are not signaled by this class.
+void block_chain::wait_write(size_t epoch) const
+{
+    ++read_waits_;
+
+    const auto written = [this, epoch]()
+    {
+        return write_epoch_ != epoch;
+    };
+
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    write_condition_.wait_for(lock, spin_lock_sleep_, written);
+}
+
+// Signal completion of a write to readers blocked in wait_write.
+void block_chain::notify_write() const
+{
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        ++write_epoch_;
     }
+
+    write_condition_.notify_all();
+}
+
+// Register a block commit in progress (see chain_state).
+void block_chain::begin_commit() const
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    ++commits_;
+}
+
+// Release a block commit, readers are signaled by the following notify.
+void block_chain::end_commit() const
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    BITCOIN_ASSERT(commits_ > 0);
+    --commits_;
+}
+
+// Block until no block commit is in progress.
+void block_chain::wait_commits() const
+{
+    const auto idle = [this]()
+    {
+        return commits_ == 0;
+    };
+
+    std::unique_lock<std::mutex> lock(write_mutex_);
+    write_condition_.wait(lock, idle);
+}
+
+// Read and cache the relay artifacts of the block, null if not found.
+// The cache rejects the artifacts if invalidated since the generation.
+template <typename Key>
+relay_cache::entry::ptr block_chain::read_relay(const Key& key,
+    size_t generation) const
+{
+    relay_cache::entry::ptr relay;
+
+    const auto do_fetch = [&](size_t slock)
+    {
+        const auto result = database_.blocks().get(key);
+        relay = result ? to_relay(result) : nullptr;
+        return is_read_valid(slock);
+    };
+    read_serial(do_fetch);
+
+    if (relay)
+        relay_cache_.add(relay, generation);
+
+    return relay;
+}
+
+// Remove selected inventories for which exists is true. Each distinct hash
+// is probed once, in sorted order, and the vector is compacted in one pass.
+template <typename Select, typename Exists>
+void block_chain::filter_inventories(inventory_vector::list& inventories,
+    const Select& select, const Exists& exists) const
+{
+    hash_list hashes;
+    hashes.reserve(inventories.size());
+
+    for (const auto& inventory: inventories)
+        if (select(inventory))
+            hashes.push_back(inventory.hash());
+
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    std::unordered_set<hash_digest> found;
+
+    for (const auto& hash: hashes)
+        if (exists(hash))
+            found.insert(hash);
+
+    if (found.empty())
+        return;
+
+    const auto matched = [&](const inventory_vector& inventory)
+    {
+        return select(inventory) && found.find(inventory.hash()) != found.end();
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        matched), inventories.end());
 }
 
 template <typename Handler, typename... Args>
@@ -1452,7 +2613,7 @@ bool block_chain::finish_read(handle sequence, Handler handler,
     Args... args) const
 {
     // If the read sequence was interrupted by a write, return false (wait).
-    if (!database_.is_read_valid(sequence))
+    if (!is_read_valid(sequence))
         return false;
 
     // Handle the read (done).
@@ -1478,5 +2639,209 @@ hash_list block_chain::to_hashes(const block_result& result)
     return hashes;
 }
 
+// Derive the relay artifacts of a block, null if the coinbase is missing.
+// The nonce is chosen once per cached block, so short ids are shared by all
+// peers served from the cache.
+relay_cache::entry::ptr block_chain::to_relay(const block_result& result) const
+{
+    const auto height = result.height();
+
+    if (result.transaction_count() == 0)
+        return nullptr;
+
+    // A duplicated coinbase (BIP30) has identical bytes under either entry.
+    const auto coinbase = database_.transactions().get(
+        result.transaction_hash(0), max_size_t, true);
+
+    if (!coinbase)
+        return nullptr;
+
+    const auto header = result.header();
+    const auto nonce = pseudo_random();
+    auto hashes = to_hashes(result);
+    auto short_ids = relay_cache::to_short_ids(header, nonce,
+        hashes.begin() + 1, hashes.end());
+
+    prefilled_transaction::list prefilled;
+    prefilled.emplace_back(0, coinbase.transaction());
+
+    return std::make_shared<const relay_cache::entry>(relay_cache::entry
+    {
+        header, result.hash(), height, std::move(hashes), nonce,
+        std::move(short_ids), std::move(prefilled)
+    });
+}
+
+// Cached artifacts are of the chain, as the cache is invalidated above the
+// fork point before each reorganization is written.
+relay_cache::entry::ptr block_chain::get_relay(size_t height) const
+{
+    hash_digest hash;
+    const auto generation = relay_cache_.generation();
+
+    if (!is_published(height))
+        return nullptr;
+
+    if (get_block_hash(hash, height))
+    {
+        const auto relay = relay_cache_.find(hash);
+
+        if (relay && relay->height == height)
+            return relay;
+    }
+
+    return read_relay(height, generation);
+}
+
+relay_cache::entry::ptr block_chain::get_relay(const hash_digest& hash) const
+{
+    const auto generation = relay_cache_.generation();
+    auto relay = relay_cache_.find(hash);
+
+    if (!relay)
+        relay = read_relay(hash, generation);
+
+    return relay && is_published(relay->height) ? relay : nullptr;
+}
+
+// Anchor a new cursor at the chain top, or verify the anchor of a resumed one.
+code block_chain::read_anchor(history_cursor& cursor) const
+{
+    if (cursor.anchor.hash() == null_hash)
+    {
+        checkpoint top;
+        if (!get_top(top))
+            return error::not_found;
+
+        cursor.anchor = top;
+    }
+
+    // A reorganization below the anchor invalidates the delivered rows.
+    const auto anchor = database_.blocks().get(cursor.anchor.height());
+    if (!anchor || anchor.header().hash() != cursor.anchor.hash())
+        return error::operation_failed;
+
+    return error::success;
+}
+
+// Read up to count rows following the cursor, without advancing it.
+// The store iterates rows newest first from the address head and cannot seek,
+// so the rows above the cursor are rescanned (but not returned) each read.
+code block_chain::read_history(chain::history_compact::list& out_rows,
+    bool& out_complete, history_cursor& cursor, const short_hash& key,
+    size_t count) const
+{
+    out_rows.clear();
+    out_complete = false;
+
+    const auto ec = read_anchor(cursor);
+    if (ec)
+        return ec;
+
+    const auto& history = database_.history();
+    const auto above = [&cursor](const chain::history_compact& row)
+    {
+        return row.height > cursor.anchor.height();
+    };
+
+    chain::history_compact::list rows;
+
+    // Rows confirmed above the anchor are the newest, so lead the scan.
+    while (true)
+    {
+        const auto limit = cursor.newer + cursor.delivered + count;
+        rows = history.get(key, limit, cursor.from_height);
+        out_complete = rows.size() < limit;
+
+        const auto newer = static_cast<size_t>(std::distance(rows.begin(),
+            std::find_if_not(rows.begin(), rows.end(), above)));
+
+        // Rescan if more rows were confirmed above the anchor than expected.
+        if (newer <= cursor.newer || out_complete)
+        {
+            cursor.newer = newer;
+            break;
+        }
+
+        cursor.newer = newer;
+    }
+
+    const auto skip = std::min(rows.size(), cursor.newer + cursor.delivered);
+    out_rows.assign(rows.begin() + skip, rows.end());
+    return error::success;
+}
+
+// private.
+// A short filter spans many buckets, which are scanned in concurrent chunks.
+bool block_chain::scan_stealth(chain::stealth_compact::list& out_rows,
+    const binary& filter, size_t from_height) const
+{
+    const auto buckets = stealth_index::buckets(filter);
+    const auto span = buckets.second - buckets.first;
+    const auto chunks = std::min(pools_.populate().size(),
+        span / minimum_stealth_chunk_buckets);
+
+    return stealth_index_.scan(out_rows, filter, from_height, buckets,
+        pools_.populate(), chunks);
+}
+
+// Read the block's transactions, false if any is missing. Each is one hash
+// probe and one deserialization (moved into the list). The block record holds
+// tx hashes rather than tx offsets, so a read by offset is a store change.
+// The store returns the newest entry of a hash, which may be a later
+// duplicate (BIP30) at another height and position, so the probe is not
+// bounded by the block height. The duplicate's tx bytes are identical.
+bool block_chain::to_transactions(transaction::list& out_transactions,
+    const block_result& result) const
+{
+    const auto count = result.transaction_count();
+    const auto& transactions = database_.transactions();
+    out_transactions.clear();
+    out_transactions.reserve(count);
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto tx_result = transactions.get(
+            result.transaction_hash(position), max_size_t, true);
+
+        if (!tx_result)
+            return false;
+
+        out_transactions.emplace_back(tx_result.transaction());
+    }
+
+    return true;
+}
+
+// Reserialize the block in wire format from its store records, null if any
+// transaction is missing. The buffer is shared read-only with the caller.
+// Transactions are probed as in to_transactions (BIP30 duplicates).
+safe_chain::data_const_ptr block_chain::to_data(
+    const block_result& result) const
+{
+    const auto count = result.transaction_count();
+    const auto& transactions = database_.transactions();
+    const auto data = std::make_shared<data_chunk>();
+
+    data_sink ostream(*data);
+    ostream_writer sink(ostream);
+    result.header().to_data(sink);
+    sink.write_variable_little_endian(count);
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        const auto tx_result = transactions.get(
+            result.transaction_hash(position), max_size_t, true);
+
+        if (!tx_result)
+            return nullptr;
+
+        tx_result.transaction().to_data(sink);
+    }
+
+    ostream.flush();
+    return data;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
+
+#include <bitcoin/blockchain/interface/histogram.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+void chain_metrics::reset()
+{
+    check.reset();
+    populate.reset();
+    accept.reset();
+    connect.reset();
+    store.reset();
+    notify.reset();
+    inputs.reset();
+    cache_hits.reset();
+    read_attempts.reset();
+    block_lock.reset();
+    transaction_lock.reset();
+    resident.reset();
+    minor_faults.reset();
+    major_faults.reset();
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
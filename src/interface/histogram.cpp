@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/histogram.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// Relaxed ordering is sufficient, values are independent statistics.
+static const auto relaxed = std::memory_order_relaxed;
+
+histogram::histogram()
+{
+    reset();
+}
+
+// static, private
+size_t histogram::bucket(uint64_t value)
+{
+    size_t bits = 0;
+
+    for (; value != 0 && bits < buckets - 1u; value >>= 1)
+        ++bits;
+
+    return bits;
+}
+
+void histogram::record(uint64_t value)
+{
+    counts_[bucket(value)].fetch_add(1, relaxed);
+    count_.fetch_add(1, relaxed);
+    sum_.fetch_add(value, relaxed);
+
+    // Retry only while the recorded maximum is smaller than the value.
+    auto maximum = maximum_.load(relaxed);
+    while (maximum < value &&
+        !maximum_.compare_exchange_weak(maximum, value, relaxed))
+    {
+    }
+}
+
+void histogram::record(const asio::time_point& start,
+    const asio::time_point& end)
+{
+    using namespace std::chrono;
+    const auto elapsed = duration_cast<microseconds>(end - start).count();
+    record(elapsed < 0 ? 0 : static_cast<uint64_t>(elapsed));
+}
+
+histogram::values histogram::get() const
+{
+    values out;
+    out.count = count_.load(relaxed);
+    out.sum = sum_.load(relaxed);
+    out.maximum = maximum_.load(relaxed);
+
+    for (size_t index = 0; index < buckets; ++index)
+        out.distribution[index] = counts_[index].load(relaxed);
+
+    return out;
+}
+
+void histogram::reset()
+{
+    for (auto& count: counts_)
+        count.store(0, relaxed);
+
+    count_.store(0, relaxed);
+    sum_.store(0, relaxed);
+    maximum_.store(0, relaxed);
+}
+
+uint64_t histogram::values::percentile(double ratio) const
+{
+    uint64_t total = 0;
+
+    for (const auto count: distribution)
+        total += count;
+
+    if (total == 0)
+        return 0;
+
+    const auto rank = static_cast<uint64_t>(ratio * total);
+    uint64_t seen = 0;
+
+    for (size_t index = 0; index < buckets; ++index)
+    {
+        seen += distribution[index];
+
+        // The upper bound of the last bucket is the recorded maximum.
+        if (seen > rank || seen == total)
+            return index == 0 ? 0 : (index == buckets - 1u ?
+                maximum : (uint64_t(1) << index) - 1u);
+    }
+
+    return maximum;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
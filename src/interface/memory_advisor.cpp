@@ -0,0 +1,307 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/memory_advisor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/settings.hpp>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace blockchain {
+
+// The store table holding the outputs, appended in block order, so that its
+// most recently written region holds the outputs most likely to be spent.
+static const std::string transaction_table = "transaction_table";
+
+static constexpr uint64_t megabyte = 1024u * 1024u;
+static constexpr uint64_t kilobyte = 1024u;
+
+// The resident size is read from smaps, which walks the page tables of the
+// store mappings, so the budget is checked at most once per interval.
+static const auto enforce_interval = asio::seconds(10);
+
+bool memory_advisor::to_access(access& out, const std::string& text)
+{
+    const auto value = boost::algorithm::trim_copy(text);
+
+    if (value == "normal")
+        out = access::normal;
+    else if (value == "random")
+        out = access::random;
+    else if (value == "sequential")
+        out = access::sequential;
+    else
+        return false;
+
+    return true;
+}
+
+bool memory_advisor::sample(usage& out)
+{
+#ifdef __linux__
+    rusage faults;
+
+    if (getrusage(RUSAGE_SELF, &faults) != 0)
+        return false;
+
+    // The second field of statm is the resident page count.
+    uint64_t total;
+    uint64_t resident;
+    std::ifstream statm("/proc/self/statm");
+
+    if (!(statm >> total >> resident))
+        return false;
+
+    out.resident_bytes = resident * static_cast<uint64_t>(
+        sysconf(_SC_PAGESIZE));
+    out.minor_faults = static_cast<uint64_t>(faults.ru_minflt);
+    out.major_faults = static_cast<uint64_t>(faults.ru_majflt);
+    return true;
+#else
+    return false;
+#endif
+}
+
+memory_advisor::memory_advisor(const boost::filesystem::path& directory,
+    const settings& settings)
+  : directory_(directory),
+    budget_(uint64_t(settings.memory_budget_megabytes) * megabyte),
+    prefault_(uint64_t(settings.prefault_megabytes) * megabyte),
+    access_(access::normal)
+{
+    if (!to_access(access_, settings.store_access))
+    {
+        access_ = access::normal;
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Invalid store access (" << settings.store_access
+            << "), not advised.";
+    }
+}
+
+// Advice is attached to a mapping, so it is lost when the store remaps a
+// growing file, and is reapplied on each enforcement of the budget.
+bool memory_advisor::advise() const
+{
+#ifdef __linux__
+    regions mapped;
+
+    if (access_ == access::normal || !read_regions(mapped))
+        return false;
+
+    const auto advice = access_ == access::random ? MADV_RANDOM :
+        MADV_SEQUENTIAL;
+
+    for (const auto& region: mapped)
+        madvise(region.begin, region.size, advice);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Writes fill the table from the front and the file is extended sparsely, so
+// the end of its data is the first hole. The read populates the page cache,
+// so that subsequent faults on the mapping do not block on the disk.
+bool memory_advisor::prefault() const
+{
+#ifdef __linux__
+    if (prefault_ == 0)
+        return false;
+
+    const auto path = (directory_ / transaction_table).string();
+    const auto file = open(path.c_str(), O_RDONLY);
+
+    if (file == -1)
+        return false;
+
+    const auto end = lseek(file, 0, SEEK_HOLE);
+    const auto length = static_cast<off_t>(prefault_);
+    const auto start = end < length ? off_t(0) : end - length;
+    const auto result = end > 0 &&
+        posix_fadvise(file, start, end - start, POSIX_FADV_WILLNEED) == 0;
+
+    close(file);
+    return result;
+#else
+    return false;
+#endif
+}
+
+bool memory_advisor::resident(uint64_t& out_bytes) const
+{
+#ifdef __linux__
+    regions mapped;
+
+    if (!read_regions(mapped))
+        return false;
+
+    out_bytes = 0;
+
+    for (const auto& region: mapped)
+        out_bytes += region.resident;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+// The pages of a shared file mapping are written back before reclaim, so a
+// page out costs only the subsequent faults. The advice is not destructive,
+// so it is safe against a mapping that the store has concurrently replaced.
+// Paging out below the budget (hysteresis) keeps the store from thrashing at
+// its limit, and the largest mappings are the least likely to be all hot.
+bool memory_advisor::enforce(uint64_t& out_resident_bytes) const
+{
+#if defined(__linux__) && defined(MADV_PAGEOUT)
+    if (budget_ == 0)
+        return false;
+
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    // A concurrent caller does not wait on an enforcement in progress.
+    unique_lock lock(mutex_, boost::try_to_lock);
+
+    if (!lock.owns_lock() || now < checked_ + enforce_interval)
+        return false;
+
+    checked_ = now;
+    regions mapped;
+
+    if (!read_regions(mapped))
+        return false;
+
+    uint64_t total = 0;
+
+    for (const auto& region: mapped)
+        total += region.resident;
+
+    if (total <= budget_)
+        return false;
+
+    const auto larger = [](const region& left, const region& right)
+    {
+        return left.resident > right.resident;
+    };
+
+    std::sort(mapped.begin(), mapped.end(), larger);
+    const auto target = budget_ - budget_ / 4u;
+    auto remaining = total;
+
+    for (const auto& region: mapped)
+    {
+        if (remaining <= target)
+            break;
+
+        madvise(region.begin, region.size, MADV_PAGEOUT);
+        remaining -= region.resident;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    advise();
+    out_resident_bytes = total;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// private
+// Parse the shared mappings of files within the store directory, with the
+// resident size of each. Each mapping is a header line (as in maps) followed
+// by its attribute lines, none of which parse as a header.
+bool memory_advisor::read_regions(regions& out) const
+{
+    out.clear();
+    boost::system::error_code ec;
+    auto root = boost::filesystem::canonical(directory_, ec);
+
+    if (ec)
+        root = boost::filesystem::absolute(directory_);
+
+    const auto prefix = root.string() + "/";
+    std::ifstream smaps("/proc/self/smaps");
+
+    if (!smaps)
+        return false;
+
+    std::string line;
+    auto matched = false;
+
+    // address perms offset dev inode path
+    while (std::getline(smaps, line))
+    {
+        if (matched && boost::algorithm::starts_with(line, "Rss:"))
+        {
+            uint64_t kilobytes;
+            std::istringstream rss(line.substr(4));
+
+            if (rss >> kilobytes)
+                out.back().resident = kilobytes * kilobyte;
+
+            continue;
+        }
+
+        uintptr_t first;
+        uintptr_t last;
+        char dash;
+        std::string perms;
+        std::string offset;
+        std::string device;
+        std::string inode;
+        std::string path;
+        std::istringstream fields(line);
+        fields >> std::hex >> first >> dash >> last >> std::dec >> perms >>
+            offset >> device >> inode;
+        std::getline(fields, path);
+        boost::algorithm::trim(path);
+
+        if (fields.fail() || dash != '-' || perms.size() != 4)
+            continue;
+
+        matched = perms[3] == 's' &&
+            boost::algorithm::starts_with(path, prefix);
+
+        if (matched)
+            out.push_back({ reinterpret_cast<uint8_t*>(first),
+                static_cast<size_t>(last - first), 0 });
+    }
+
+    return true;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/publication.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace boost::filesystem;
+
+// Increment if the format changes, a mismatched file is not read.
+static constexpr uint32_t publication_version = 2;
+
+publication::publication(const path& file)
+  : file_(file)
+{
+}
+
+// The top is written to a temporary file and renamed over the publication,
+// so a reader observes either the previous or the new top, never a mix.
+bool publication::publish(const config::checkpoint& top,
+    uint64_t sequence) const
+{
+    if (file_.empty())
+        return false;
+
+    auto temporary = file_;
+    temporary += ".tmp";
+
+    {
+        bc::ofstream file(temporary.string(), std::ofstream::binary);
+
+        if (!file)
+            return false;
+
+        ostream_writer sink(file);
+        sink.write_4_bytes_little_endian(publication_version);
+        sink.write_8_bytes_little_endian(sequence);
+        sink.write_hash(top.hash());
+        sink.write_8_bytes_little_endian(top.height());
+        file.flush();
+
+        if (!sink || !file.good())
+            return false;
+    }
+
+    boost::system::error_code ec;
+    rename(temporary, file_, ec);
+    return !ec;
+}
+
+bool publication::read(config::checkpoint& out_top,
+    uint64_t& out_sequence) const
+{
+    boost::system::error_code ec;
+
+    if (file_.empty() || !exists(file_, ec))
+        return false;
+
+    bc::ifstream file(file_.string(), std::ifstream::binary);
+    istream_reader source(file);
+
+    if (!file || source.read_4_bytes_little_endian() !=
+        publication_version)
+        return false;
+
+    const auto sequence = source.read_8_bytes_little_endian();
+    const auto hash = source.read_hash();
+    const auto height = source.read_8_bytes_little_endian();
+
+    if (!source)
+        return false;
+
+    out_top = { hash, static_cast<size_t>(height) };
+    out_sequence = sequence;
+    return true;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
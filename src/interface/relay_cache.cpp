@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/relay_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// BIP152: the siphash key is the first 16 bytes of sha256(header || nonce),
+// and a short id is the low 6 bytes of the siphash of the tx hash.
+message::compact_block::short_id_list relay_cache::to_short_ids(
+    const chain::header& header, uint64_t nonce,
+    hash_list::const_iterator begin, hash_list::const_iterator end)
+{
+    auto data = header.to_data();
+    extend_data(data, to_little_endian(nonce));
+    const auto key = to_siphash_key(slice<0, half_hash_size>(
+        sha256_hash(data)));
+
+    message::compact_block::short_id_list short_ids;
+    short_ids.reserve(std::distance(begin, end));
+
+    for (auto hash = begin; hash != end; ++hash)
+    {
+        const auto id = to_little_endian(siphash(key, *hash));
+        mini_hash short_id;
+        std::copy_n(id.begin(), short_id.size(), short_id.begin());
+        short_ids.push_back(short_id);
+    }
+
+    return short_ids;
+}
+
+relay_cache::relay_cache(size_t limit)
+  : limit_(limit),
+    generation_(0)
+{
+}
+
+size_t relay_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t relay_cache::generation() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return generation_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void relay_cache::add(entry::ptr value, size_t generation)
+{
+    if (limit_ == 0)
+        return;
+
+    const auto& hash = value->hash;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // The read may precede an invalidation of the block (reorganization).
+    if (generation != generation_ || entries_.count(hash) != 0)
+        return;
+
+    order_.push_front(value);
+    entries_.emplace(hash, order_.begin());
+
+    // Evict the least recently requested blocks once the limit is exceeded.
+    while (order_.size() > limit_)
+    {
+        entries_.erase(order_.back()->hash);
+        order_.pop_back();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+relay_cache::entry::ptr relay_cache::find(const hash_digest& hash)
+{
+    if (limit_ == 0)
+        return nullptr;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    const auto it = entries_.find(hash);
+
+    if (it == entries_.end())
+        return nullptr;
+
+    order_.splice(order_.begin(), order_, it->second);
+    return *it->second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void relay_cache::pop_above(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    ++generation_;
+
+    for (auto it = order_.begin(); it != order_.end();)
+    {
+        if ((*it)->height > height)
+        {
+            entries_.erase((*it)->hash);
+            it = order_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
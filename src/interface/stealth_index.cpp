@@ -0,0 +1,281 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/interface/stealth_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+using namespace bc::wallet;
+
+static constexpr size_t empty = max_size_t;
+
+const size_t stealth_index::bucket_bits;
+
+// Filter bits are read from the little endian prefix, high bit first.
+size_t stealth_index::to_bucket(uint32_t prefix)
+{
+    const auto first = prefix & 0xffu;
+    const auto second = (prefix >> 8) & 0xffu;
+    return ((first << 8) | second) >> (16u - bucket_bits);
+}
+
+stealth_index::range stealth_index::buckets(const binary& filter)
+{
+    const auto bits = std::min(filter.size(), bucket_bits);
+    size_t first = 0;
+
+    for (size_t bit = 0; bit < bits; ++bit)
+        if (filter[bit])
+            first |= size_t(1) << (bucket_bits - bit - 1u);
+
+    return{ first, first + (size_t(1) << (bucket_bits - bits)) };
+}
+
+stealth_index::stealth_index(size_t depth)
+  : depth_(depth),
+    buckets_(depth == 0 ? 0 : size_t(1) << bucket_bits),
+    floor_(empty),
+    top_(0),
+    size_(0)
+{
+}
+
+size_t stealth_index::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Stealth outputs are paired by convention, as indexed by the store.
+void stealth_index::push(const block& block, size_t height)
+{
+    if (depth_ == 0)
+        return;
+
+    std::vector<row> rows;
+
+    for (const auto& tx: block.transactions())
+    {
+        const auto& outputs = tx.outputs();
+
+        for (size_t index = 1; index < outputs.size(); ++index)
+        {
+            const auto& ephemeral_script = outputs[index - 1u].script();
+            const auto address = payment_address::extract(
+                outputs[index].script());
+
+            uint32_t prefix;
+            hash_digest ephemeral_key;
+
+            if (address &&
+                extract_ephemeral_key(ephemeral_key, ephemeral_script) &&
+                to_stealth_prefix(prefix, ephemeral_script))
+            {
+                rows.push_back(
+                {
+                    prefix, height,
+                    stealth_compact{ ephemeral_key, address.hash(), tx.hash() }
+                });
+            }
+        }
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // A gap (e.g. deferred indexing) restarts coverage at the height.
+    if (floor_ == empty || height != top_ + 1u)
+    {
+        reset();
+        floor_ = height;
+    }
+
+    top_ = height;
+
+    for (auto& value: rows)
+        buckets_[to_bucket(value.prefix)].push_back(std::move(value));
+
+    size_ += rows.size();
+
+    if (top_ - floor_ < depth_)
+        return;
+
+    // Discard the rows below the depth, which raises the floor.
+    floor_ = top_ - depth_ + 1u;
+
+    const auto covered = [this](const row& value)
+    {
+        return value.height >= floor_;
+    };
+
+    for (auto& bucket: buckets_)
+    {
+        const auto end = std::find_if(bucket.begin(), bucket.end(), covered);
+        size_ -= std::distance(bucket.begin(), end);
+        bucket.erase(bucket.begin(), end);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void stealth_index::pop_above(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (floor_ == empty || height >= top_)
+        return;
+
+    // The fork is below the index, so no height remains covered.
+    if (height < floor_)
+    {
+        reset();
+        return;
+    }
+
+    top_ = height;
+
+    for (auto& bucket: buckets_)
+    {
+        while (!bucket.empty() && bucket.back().height > height)
+        {
+            bucket.pop_back();
+            --size_;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void stealth_index::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    reset();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool stealth_index::scan(stealth_compact::list& out, const binary& filter,
+    size_t from_height, const range& buckets) const
+{
+    if (depth_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (floor_ == empty || from_height < floor_)
+        return false;
+
+    append(out, filter, from_height, buckets);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The chunks are joined in order, so the rows remain in bucket order.
+bool stealth_index::scan(stealth_compact::list& out, const binary& filter,
+    size_t from_height, const range& buckets, dispatcher& dispatch,
+    size_t chunks) const
+{
+    if (depth_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (floor_ == empty || from_height < floor_)
+        return false;
+
+    const auto span = buckets.second - buckets.first;
+
+    if (chunks < 2)
+    {
+        append(out, filter, from_height, buckets);
+        return true;
+    }
+
+    std::vector<stealth_compact::list> results(chunks);
+    stage_pools::batches batches;
+    batches.reserve(chunks);
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+        const range part
+        {
+            buckets.first + span * chunk / chunks,
+            buckets.first + span * (chunk + 1u) / chunks
+        };
+
+        batches.push_back([&, part, chunk]()
+        {
+            append(results[chunk], filter, from_height, part);
+        });
+    }
+
+    stage_pools::concurrent(dispatch, batches);
+
+    for (const auto& result: results)
+        out.insert(out.end(), result.begin(), result.end());
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+// The caller must hold the shared (or unique) lock.
+void stealth_index::append(stealth_compact::list& out, const binary& filter,
+    size_t from_height, const range& buckets) const
+{
+    const auto last = std::min(buckets.second, buckets_.size());
+
+    for (auto index = buckets.first; index < last; ++index)
+        for (const auto& value: buckets_[index])
+            if (value.height >= from_height &&
+                filter.is_prefix_of(value.prefix))
+                out.push_back(value.value);
+}
+
+// protected
+// The caller must hold the unique lock.
+void stealth_index::reset()
+{
+    for (auto& bucket: buckets_)
+        bucket.clear();
+
+    floor_ = empty;
+    top_ = 0;
+    size_ = 0;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
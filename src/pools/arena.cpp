@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/arena.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace libbitcoin {
+namespace blockchain {
+
+arena::arena(size_t chunk_size)
+  : chunk_size_(std::max(chunk_size, size_t(1))),
+    reserved_(0),
+    position_(nullptr),
+    remaining_(0)
+{
+}
+
+void* arena::allocate(size_t size, size_t alignment)
+{
+    const auto address = reinterpret_cast<uintptr_t>(position_);
+    const auto padding = (alignment - address % alignment) % alignment;
+
+    if (position_ == nullptr || padding + size > remaining_)
+    {
+        // Allocations are aligned from the start of a (new) chunk.
+        const auto bytes = std::max(chunk_size_, size + alignment);
+        chunks_.emplace_back(new uint8_t[bytes]);
+        reserved_ += bytes;
+        position_ = chunks_.back().get();
+        remaining_ = bytes;
+        return allocate(size, alignment);
+    }
+
+    const auto result = position_ + padding;
+    position_ = result + size;
+    remaining_ -= padding + size;
+    return result;
+}
+
+size_t arena::reserved() const
+{
+    return reserved_;
+}
+
+void arena::release()
+{
+    chunks_.clear();
+    reserved_ = 0;
+    position_ = nullptr;
+    remaining_ = 0;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -27,6 +27,7 @@
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
 #include <bitcoin/blockchain/validate/validate_block.hpp>
 
@@ -45,16 +46,27 @@ using namespace std::placeholders;
 // block: { bits, version, timestamp }
 // transaction: { exists, height, output }
 
-block_organizer::block_organizer(shared_mutex& mutex, dispatcher& dispatch,
-    threadpool& thread_pool, fast_chain& chain,  const settings& settings,
-    bool relay_transactions)
+block_organizer::block_organizer(prioritized_mutex& mutex, stage_pools& pools,
+    threadpool& thread_pool, fast_chain& chain, transaction_pool& pool,
+    script_cache& cache, chain_metrics& metrics, const settings& settings)
   : fast_chain_(chain),
+    speculative_(false),
     mutex_(mutex),
     stopped_(true),
-    dispatch_(dispatch),
+    pipelined_(settings.pipeline_blocks),
+    store_dispatch_(pools.store()),
     block_pool_(settings.reorganization_limit),
-    validator_(dispatch, fast_chain_, settings, relay_transactions),
-    subscriber_(std::make_shared<reorganize_subscriber>(thread_pool, NAME))
+    orphans_(settings.orphan_block_limit, settings.orphan_block_bytes),
+    transaction_pool_(pool),
+    metrics_(metrics),
+    validator_(pools.populate(), pools.script(), fast_chain_, settings, pool,
+        cache, orphans_),
+    subscriber_(std::make_shared<reorganize_subscriber>(thread_pool, NAME)),
+    notifications_(settings.notification_limit == 0 ? nullptr :
+        std::make_shared<reorganize_queue>(thread_pool,
+            settings.notification_limit,
+            std::bind(&block_organizer::deliver_reorganize, this, _1),
+            &block_organizer::coalesce_reorganize))
 {
 }
 
@@ -73,13 +85,27 @@ bool block_organizer::start()
 {
     stopped_ = false;
     subscriber_->start();
+
+    if (notifications_)
+        notifications_->start();
+
     validator_.start();
     return true;
 }
 
+// This is called from within the critical section (block_chain::stop), which
+// guards pending_. The mutex is shared with the chain, so it is not retaken.
 bool block_organizer::stop()
 {
+    // The store write must not outlive the priority pool (lock safe).
+    if (pending_)
+        pending_->result.wait();
+
     validator_.stop();
+
+    if (notifications_)
+        notifications_->stop();
+
     subscriber_->stop();
     subscriber_->invoke(error::service_stopped, 0, {}, {});
     stopped_ = true;
@@ -92,32 +118,137 @@ bool block_organizer::stop()
 // This is called from block_chain::organize.
 void block_organizer::organize(block_const_ptr block, result_handler handler)
 {
+    const auto ec = organize_buffered(block);
+
+    // Invoke caller handler outside of critical section.
+    handler(ec);
+
+    if (is_parent(ec, block))
+        resubmit(block);
+}
+
+// private
+code block_organizer::organize_buffered(block_const_ptr block)
+{
+    // The block is organized once its parent is organized.
+    if (orphans_.exists(block->hash()))
+        return error::orphan_block;
+
+    code result;
+
+    // The handler is invoked before organize_block returns.
+    // An orphan is buffered by organize_block, within the critical section.
+    organize_block(block, [&result](const code& ec) { result = ec; });
+    return result;
+}
+
+// private
+// Organize the orphans of the organized parent, and in turn their orphans.
+// This runs on the caller's thread, outside of the critical section.
+void block_organizer::resubmit(block_const_ptr parent)
+{
+    auto pending = orphans_.remove(parent->hash());
+
+    while (!pending.empty())
+    {
+        const auto child = pending.back();
+        pending.pop_back();
+
+        if (!is_parent(organize_buffered(child), child))
+            continue;
+
+        const auto children = orphans_.remove(child->hash());
+        pending.insert(pending.end(), children.begin(), children.end());
+    }
+}
+
+// private
+// The caller must hold the critical section. The parent is organized under
+// the same section, so it either precedes this call (and the block is not an
+// orphan) or follows it and finds the orphan when it resubmits its children.
+// An orphan cannot be validated, so only one with work near that of the top
+// block is buffered, which bounds the cost of flooding the buffer with cheap
+// (e.g. minimum difficulty) blocks.
+void block_organizer::buffer_orphan(block_const_ptr block)
+{
+    size_t top;
+    uint32_t bits;
+
+    if (block->validation.simulate || !fast_chain_.get_last_height(top) ||
+        !fast_chain_.get_bits(bits, top))
+        return;
+
+    // Retargeting reduces the work of a block by at most a factor of four.
+    const auto work = chain::block::proof(block->header().bits());
+
+    if (work * 4u >= chain::block::proof(bits))
+        orphans_.add(block);
+}
+
+// private
+void block_organizer::organize_block(block_const_ptr block,
+    result_handler handler)
+{
+    const auto start_lock = asio::steady_clock::now();
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock();
-
-    // TODO: prioritize lock access: stop, block, tx.
+    // Blocks are admitted ahead of queued txs (stop is also high priority).
+    mutex_.lock_high_priority();
+    metrics_.block_lock.record(start_lock, asio::steady_clock::now());
 
     // The stop check must be guarded.
     if (stopped())
     {
-        mutex_.unlock();
+        mutex_.unlock_high_priority();
         //---------------------------------------------------------------------
         handler(error::service_stopped);
         return;
     }
 
     // Checks that are independent of chain state.
+    const auto start_check = asio::steady_clock::now();
     auto ec = validator_.check(block);
+    metrics_.check.record(start_check, asio::steady_clock::now());
 
     if (ec)
     {
-        mutex_.unlock();
+        mutex_.unlock_high_priority();
+        //---------------------------------------------------------------------
+        handler(ec);
+        return;
+    }
+
+    // A block on top of the pending commit is checked while it is written.
+    // Population reads the store, which is not read while it is written, so
+    // the write is awaited here. The pools of a speculative branch are not
+    // settled, the branch is prefixed by the pending blocks. Otherwise the
+    // pending commit must be written and settled beforehand.
+    speculative_ = extends_pending(block);
+
+    // Roll back, the branch would be based on a block that was not written.
+    if (speculative_ && pending_->result.get())
+    {
+        ec = settle_pending();
+        mutex_.unlock_high_priority();
         //---------------------------------------------------------------------
         handler(ec);
         return;
     }
 
+    if (!speculative_)
+    {
+        ec = settle_pending();
+
+        if (ec)
+        {
+            mutex_.unlock_high_priority();
+            //-----------------------------------------------------------------
+            handler(ec);
+            return;
+        }
+    }
+
     // Verify the last branch block (all others are verified).
     // Get the path through the block forest to the new block.
     const auto branch = block_pool_.get_path(block);
@@ -134,22 +265,28 @@ void block_organizer::organize(block_const_ptr block, result_handler handler)
     //*************************************************************************
     if (branch->empty() || fast_chain_.get_block_exists(block->hash()))
     {
-        mutex_.unlock();
+        mutex_.unlock_high_priority();
         //---------------------------------------------------------------------
         handler(error::duplicate_block);
         return;
     }
 
-    if (!set_branch_height(branch))
+    if (speculative_)
     {
-        mutex_.unlock();
+        prefix_pending(branch);
+    }
+    else if (!set_branch_height(branch))
+    {
+        buffer_orphan(block);
+        mutex_.unlock_high_priority();
         //---------------------------------------------------------------------
         handler(error::orphan_block);
         return;
     }
 
-    // Reset the reusable promise.
+    // Reset the reusable promise and pipelined result.
     resume_ = std::promise<code>();
+    connected_.reset();
 
     const result_handler complete =
         std::bind(&block_organizer::signal_completion,
@@ -167,7 +304,14 @@ void block_organizer::organize(block_const_ptr block, result_handler handler)
     // If we do not wait on the original thread there may be none left.
     ec = resume_.get_future().get();
 
-    mutex_.unlock();
+    // The pipelined commit releases the critical section and invokes handler.
+    if (!ec && connected_)
+    {
+        commit_branch(handler);
+        return;
+    }
+
+    mutex_.unlock_high_priority();
     ///////////////////////////////////////////////////////////////////////////
 
     // Invoke caller handler outside of critical section.
@@ -231,12 +375,24 @@ void block_organizer::handle_connect(const code& ec, branch::ptr branch,
     top->validation.error = error::success;
     top->validation.start_notify = asio::steady_clock::now();
 
+    // The stage timers of the top block are set by the validator.
+    const auto& times = top->validation;
+    metrics_.populate.record(times.start_populate, times.start_accept);
+    metrics_.accept.record(times.start_accept, times.start_connect);
+    metrics_.connect.record(times.start_connect, times.start_notify);
+    metrics_.inputs.record(top->total_inputs(false));
+    metrics_.cache_hits.record(static_cast<uint64_t>(
+        times.cache_efficiency * 100.0f));
+
     const auto first_height = branch->height() + 1u;
     const auto maximum = branch->work();
     uint256_t threshold;
 
+    // A speculative branch extends the pending commit, which extends the
+    // chain top, so there is no competing chain segment to query.
     // The chain query will stop if it reaches the maximum.
-    if (!fast_chain_.get_branch_work(threshold, maximum, first_height))
+    if (!speculative_ &&
+        !fast_chain_.get_branch_work(threshold, maximum, first_height))
     {
         handler(error::operation_failed);
         return;
@@ -257,6 +413,15 @@ void block_organizer::handle_connect(const code& ec, branch::ptr branch,
         return;
     }
 
+    // The organize thread commits the branch so that the store write does not
+    // hold the critical section (or a priority thread) through its duration.
+    if (pipelined_)
+    {
+        connected_ = branch;
+        handler(error::success);
+        return;
+    }
+
     // Get the outgoing blocks to forward to reorg handler.
     const auto out_blocks = std::make_shared<block_const_ptr_list>();
 
@@ -267,7 +432,7 @@ void block_organizer::handle_connect(const code& ec, branch::ptr branch,
     // Replace! Switch!
     //#########################################################################
     fast_chain_.reorganize(branch->fork_point(), branch->blocks(), out_blocks,
-        dispatch_, reorganized_handler);
+        store_dispatch_, reorganized_handler);
     //#########################################################################
 }
 
@@ -285,16 +450,257 @@ void block_organizer::handle_reorganized(const code& ec,
         return;
     }
 
-    block_pool_.remove(branch->blocks());
-    block_pool_.prune(branch->top_height());
-    block_pool_.add(outgoing);
+    // This is the completion of the store write, so it runs on a store (or
+    // shared populate) thread. The pools are independent, so each is a batch
+    // on the store pool. The calling thread runs any batch not yet taken, so
+    // this cannot deadlock on its own pool. Both pools must reflect the
+    // reorganization before it is announced.
+    stage_pools::concurrent(store_dispatch_,
+    {
+        // Confirmed txs leave the tx pool, outgoing txs return unvalidated.
+        [&]()
+        {
+            transaction_pool_.remove(branch->blocks());
+            transaction_pool_.restore(outgoing);
+        },
+        [&]()
+        {
+            block_pool_.remove(branch->blocks());
+            block_pool_.prune(branch->top_height());
+            block_pool_.add(outgoing);
+        }
+    });
+
+    // The store stage spans the branch work query and the write.
+    const auto start_notify = asio::steady_clock::now();
+    metrics_.store.record(branch->top()->validation.start_notify,
+        start_notify);
 
     // v3 reorg block order is reverse of v2, branch.back() is the new top.
     notify_reorganize(branch->height(), branch->blocks(), outgoing);
+    metrics_.notify.record(start_notify, asio::steady_clock::now());
 
     handler(error::success);
 }
 
+// Pipelined commit sequence.
+//-----------------------------------------------------------------------------
+
+// private
+// This is called from within the critical section, which it releases.
+void block_organizer::commit_branch(result_handler handler)
+{
+    auto connected = connected_;
+    connected_.reset();
+
+    if (speculative_)
+    {
+        const auto base = pending_;
+        const auto ec = settle_pending();
+
+        // Roll back, the branch is based on a block that was not written.
+        if (ec)
+        {
+            mutex_.unlock_high_priority();
+            //-----------------------------------------------------------------
+            handler(ec);
+            return;
+        }
+
+        // Rebase the branch onto the blocks of the settled commit.
+        const auto rebased = std::make_shared<branch>(
+            base->branch->top_height());
+        const auto& blocks = *connected->blocks();
+        const auto based = base->branch->size();
+
+        for (auto block = blocks.rbegin(); block != blocks.rend() - based;
+            ++block)
+            rebased->push_front(*block);
+
+        connected = rebased;
+    }
+
+    size_t top;
+
+    // There is no commit in progress, so the store top is stable.
+    if (!fast_chain_.get_last_height(top))
+    {
+        mutex_.unlock_high_priority();
+        //---------------------------------------------------------------------
+        handler(error::operation_failed);
+        return;
+    }
+
+    const auto promise = std::make_shared<std::promise<code>>();
+    const auto pending = std::make_shared<commit>(commit
+    {
+        connected,
+        std::make_shared<block_const_ptr_list>(),
+        promise->get_future().share(),
+        false
+    });
+
+    const auto complete = [promise](const code& ec)
+    {
+        promise->set_value(ec);
+    };
+
+    // Replace! Switch!
+    //#########################################################################
+    fast_chain_.reorganize(connected->fork_point(), connected->blocks(),
+        pending->outgoing, store_dispatch_, complete);
+    //#########################################################################
+
+    // Only a chain extension may be speculatively extended (no work query).
+    if (connected->height() != top)
+    {
+        const auto ec = pending->result.get();
+        settle(pending, ec);
+        mutex_.unlock_high_priority();
+        //---------------------------------------------------------------------
+        handler(ec);
+        return;
+    }
+
+    pending_ = pending;
+    mutex_.unlock_high_priority();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The next block may be checked on this one while it is being written.
+    const auto ec = pending->result.get();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_high_priority();
+    settle(pending, ec);
+    mutex_.unlock_high_priority();
+    ///////////////////////////////////////////////////////////////////////////
+
+    handler(ec);
+}
+
+// private
+// Wait on the pending commit (if any) and settle it into the pools.
+code block_organizer::settle_pending()
+{
+    if (!pending_)
+        return error::success;
+
+    const auto pending = pending_;
+    const auto ec = pending->result.get();
+    settle(pending, ec);
+    return ec;
+}
+
+// private
+// Pool maintenance is deferred to whichever thread next holds the lock.
+void block_organizer::settle(commit::ptr pending, const code& ec)
+{
+    if (pending_ == pending)
+        pending_.reset();
+
+    if (pending->settled)
+        return;
+
+    pending->settled = true;
+    const auto ignore = [](const code&) {};
+    handle_reorganized(ec, pending->branch, pending->outgoing, ignore);
+}
+
+// Dry-run sequence.
+//-----------------------------------------------------------------------------
+// Block population is stateless (state is on the block), so a dry run takes
+// only the shared critical section. This excludes organization and store
+// writes, other than a pending commit, which is written outside of the section
+// and is awaited here. The pools are not settled for the pending commit until
+// the next organization, so a block on a fork of the pending branch may fail.
+// The result is advisory (e.g. for block templates), as the chain may move on.
+
+void block_organizer::validate_only(block_const_ptr block,
+    result_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped);
+        return;
+    }
+
+    auto ec = validator_.check(block);
+
+    if (ec)
+    {
+        handler(ec);
+        return;
+    }
+
+    // Critical Section (shared)
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_low_priority_shared();
+
+    // The stop check must be guarded.
+    if (stopped())
+    {
+        mutex_.unlock_low_priority_shared();
+        //---------------------------------------------------------------------
+        handler(error::service_stopped);
+        return;
+    }
+
+    // Population reads the store, so the pending commit must be written. A
+    // block on top of it is prefixed by its blocks, as they are not settled.
+    const auto speculative = extends_pending(block);
+
+    if (pending_)
+        pending_->result.wait();
+
+    // The pool is read under its own lock, the block is not added to it.
+    const auto branch = block_pool_.get_path(block);
+
+    if (branch->empty() || fast_chain_.get_block_exists(block->hash()))
+    {
+        mutex_.unlock_low_priority_shared();
+        //---------------------------------------------------------------------
+        handler(error::duplicate_block);
+        return;
+    }
+
+    if (speculative)
+    {
+        prefix_pending(branch);
+    }
+    else if (!set_branch_height(branch))
+    {
+        mutex_.unlock_low_priority_shared();
+        //---------------------------------------------------------------------
+        handler(error::orphan_block);
+        return;
+    }
+
+    const auto validate = [&](void (validate_block::*stage)(
+        branch::const_ptr, validate_block::result_handler) const)
+    {
+        std::promise<code> promise;
+        const auto complete = [&promise](const code& ec)
+        {
+            promise.set_value(ec);
+        };
+
+        // Waiting here keeps the caller off of the priority threads.
+        (validator_.*stage)(branch, complete);
+        return promise.get_future().get();
+    };
+
+    ec = validate(&validate_block::accept);
+
+    if (!ec)
+        ec = validate(&validate_block::connect);
+
+    mutex_.unlock_low_priority_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    handler(ec);
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
@@ -305,9 +711,45 @@ void block_organizer::notify_reorganize(size_t branch_height,
 {
     // Using invoke slows down catch-up sync and is a deadlock risk, but
     // relay can create big backlog that can easily bring down the server.
+    // The queue invokes from its worker and bounds the backlog instead.
+    if (notifications_)
+    {
+        notifications_->push({ branch_height, branch, original });
+        return;
+    }
+
     subscriber_->invoke(error::success, branch_height, branch, original);
 }
 
+// private
+void block_organizer::deliver_reorganize(reorganization& event)
+{
+    subscriber_->invoke(error::success, event.fork_height, event.incoming,
+        event.outgoing);
+}
+
+// private
+// An undelivered reorganization is extended by a following reorganization
+// that pops no blocks and forks at its top, so catch-up sync is notified as
+// one reorganization per pass of the notification worker.
+bool block_organizer::coalesce_reorganize(reorganization& last,
+    const reorganization& next)
+{
+    if (!last.incoming || !next.incoming ||
+        (next.outgoing && !next.outgoing->empty()) ||
+        next.fork_height != last.fork_height + last.incoming->size())
+        return false;
+
+    const auto incoming = std::make_shared<block_const_ptr_list>();
+    incoming->reserve(last.incoming->size() + next.incoming->size());
+    incoming->insert(incoming->end(), last.incoming->begin(),
+        last.incoming->end());
+    incoming->insert(incoming->end(), next.incoming->begin(),
+        next.incoming->end());
+    last.incoming = incoming;
+    return true;
+}
+
 void block_organizer::subscribe_reorganize(reorganize_handler&& handler)
 {
     subscriber_->subscribe(std::move(handler),
@@ -320,13 +762,22 @@ void block_organizer::subscribe_reorganize(reorganize_handler&& handler)
 void block_organizer::filter(get_data_ptr message) const
 {
     block_pool_.filter(message);
+    orphans_.filter(message);
 }
 
 // Utility.
 //-----------------------------------------------------------------------------
 
 // private
-bool block_organizer::set_branch_height(branch::ptr branch)
+// A block that is stored or pooled may be the parent of a subsequent block.
+bool block_organizer::is_parent(const code& ec, block_const_ptr block)
+{
+    return !block->validation.simulate &&
+        (!ec || ec == error::insufficient_work);
+}
+
+// private
+bool block_organizer::set_branch_height(branch::ptr branch) const
 {
     size_t height;
 
@@ -338,5 +789,25 @@ bool block_organizer::set_branch_height(branch::ptr branch)
     return true;
 }
 
+// private
+bool block_organizer::extends_pending(block_const_ptr block) const
+{
+    return pending_ &&
+        pending_->branch->top()->hash() ==
+            block->header().previous_block_hash();
+}
+
+// private
+// Base the branch on the pending commit, which is not yet in the store.
+void block_organizer::prefix_pending(branch::ptr branch) const
+{
+    const auto& blocks = *pending_->branch->blocks();
+
+    for (auto block = blocks.rbegin(); block != blocks.rend(); ++block)
+        branch->push_front(*block);
+
+    branch->set_height(pending_->branch->height());
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
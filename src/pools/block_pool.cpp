@@ -30,8 +30,6 @@
 namespace libbitcoin {
 namespace blockchain {
 
-using namespace boost;
-
 block_pool::block_pool(size_t maximum_depth)
   : maximum_depth_(maximum_depth == 0 ? max_size_t : maximum_depth)
 {
@@ -46,30 +44,27 @@ void block_pool::add(block_const_ptr valid_block)
 {
     // The block must be successfully validated.
     ////BITCOIN_ASSERT(!block->validation.error);
-    block_entry entry{ valid_block };
-
-    ////BITCOIN_ASSERT(block->validation.state);
-    auto height = valid_block->header().validation.height;
-    const auto& left = blocks_.left;
+    const auto hash = valid_block->hash();
 
     // Caller ensure the entry does not exist by using get_path, but
-    // insert rejects the block if there is an entry of the same hash.
-    ////BITCOIN_ASSERT(left.find(entry) == left.end());
+    // the block is rejected if there is an entry of the same hash.
+    if (blocks_.find(hash) != blocks_.end())
+        return;
 
-    // Add a back pointer from the parent for clearing the path later.
-    const block_entry parent{ valid_block->header().previous_block_hash() };
-    const auto it = left.find(parent);
-
-    if (it != left.end())
-    {
-        height = 0;
-        it->first.add_child(valid_block);
-    }
+    // Link to the parent for clearing the path later, otherwise a root.
+    const auto it = blocks_.find(valid_block->header().previous_block_hash());
+    const auto parent = it == blocks_.end() ? nullptr : &it->second;
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     unique_lock lock(mutex_);
-    blocks_.insert({ std::move(entry), height });
+    auto& entry = blocks_.emplace(hash,
+        node{ valid_block, parent, {} }).first->second;
+
+    if (parent == nullptr)
+        plant(entry);
+    else
+        parent->children.push_back(&entry);
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -84,136 +79,155 @@ void block_pool::add(block_const_ptr_list_const_ptr valid_blocks)
 // or acceptance. So there is never internal removal of a node.
 void block_pool::remove(block_const_ptr_list_const_ptr accepted_blocks)
 {
+    // A child is typically the next accepted block or a single pool tip.
     hash_list child_hashes;
-    auto saver = [&](const hash_digest& hash){ child_hashes.push_back(hash); };
-    auto& left = blocks_.left;
+    child_hashes.reserve(accepted_blocks->size());
 
     for (auto block: *accepted_blocks)
     {
-        auto it = left.find(block_entry{ block->hash() });
+        const auto it = blocks_.find(block->hash());
 
-        if (it == left.end())
+        if (it == blocks_.end())
             continue;
 
         // Copy hashes of all children of nodes we delete.
-        const auto& children = it->first.children();
-        std::for_each(children.begin(), children.end(), saver);
+        for (const auto child: it->second.children)
+            child_hashes.push_back(child->block->hash());
 
         ///////////////////////////////////////////////////////////////////////
         // Critical Section
         unique_lock lock(mutex_);
-        left.erase(it);
+        erase(it);
         ///////////////////////////////////////////////////////////////////////
     }
 
-    // Move all children that we have orphaned to the root (give them height).
-    for (auto child: child_hashes)
+    // Move all children that we have orphaned to the root (in place).
+    for (const auto& child: child_hashes)
     {
-        auto it = left.find(block_entry{ child });
+        const auto it = blocks_.find(child);
 
         // Except for sub-branches all children should have been deleted above.
-        if (it == left.end())
+        if (it == blocks_.end())
             continue;
 
-        // Copy the entry so that it can be deleted and replanted with height.
-        const auto copy = it->first;
-        const auto height = copy.block()->header().validation.height;
-        BITCOIN_ASSERT(it->second == 0);
+        BITCOIN_ASSERT(it->second.parent == nullptr);
 
         // Critical Section
         ///////////////////////////////////////////////////////////////////////
         unique_lock lock(mutex_);
-        left.erase(it);
-        blocks_.insert({ copy, height });
+        plant(it->second);
         ///////////////////////////////////////////////////////////////////////
     }
 }
 
-// protected
-void block_pool::prune(const hash_list& hashes, size_t minimum_height)
+void block_pool::prune(size_t top_height)
 {
-    hash_list child_hashes;
-    auto saver = [&](const hash_digest& hash){ child_hashes.push_back(hash); };
-    auto& left = blocks_.left;
+    node_list expired;
+    const auto minimum_height = floor_subtract(top_height, maximum_depth_);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    // The lock is taken once for the batch, not once per node.
+    unique_lock lock(mutex_);
 
-    for (auto& hash: hashes)
+    // Take all root buckets with insufficient height, visiting no others.
+    while (!roots_.empty() && roots_.begin()->first < minimum_height)
     {
-        const auto it = left.find(block_entry{ hash });
-        BITCOIN_ASSERT(it != left.end());
+        const auto& bucket = roots_.begin()->second;
+        expired.insert(expired.end(), bucket.begin(), bucket.end());
+        roots_.erase(roots_.begin());
+    }
 
-        const auto height = it->first.block()->header().validation.height;
+    // Delete expired nodes, replanting unexpired children of deleted nodes.
+    while (!expired.empty())
+    {
+        const auto entry = expired.back();
+        expired.pop_back();
 
-        // Delete all roots and expired non-roots and recurse their children.
-        if (it->second != 0 || height < minimum_height)
+        for (const auto child: entry->children)
         {
-            // delete
-            const auto& children = it->first.children();
-            std::for_each(children.begin(), children.end(), saver);
-
-            ///////////////////////////////////////////////////////////////////
-            // Critical Section
-            unique_lock lock(mutex_);
-            left.erase(it);
-            ///////////////////////////////////////////////////////////////////
-
-            continue;
+            if (height(*child) < minimum_height)
+                expired.push_back(child);
+            else
+                plant(*child);
         }
 
-        // Copy the entry so that it can be deleted and replanted with height.
-        const auto copy = it->first;
-
-        // Critical Section
-        ///////////////////////////////////////////////////////////////////////
-        unique_lock lock(mutex_);
-        left.erase(it);
-        blocks_.insert({ copy, height });
-        ///////////////////////////////////////////////////////////////////////
+        blocks_.erase(entry->block->hash());
     }
-
-    // Recurse the children to span the tree.
-    if (!child_hashes.empty())
-        prune(child_hashes, minimum_height);
+    ///////////////////////////////////////////////////////////////////////////
 }
 
-void block_pool::prune(size_t top_height)
+void block_pool::filter(get_data_ptr message) const
 {
-    hash_list hashes;
-    const auto minimum_height = floor_subtract(top_height, maximum_depth_);
+    auto& inventories = message->inventories();
 
-    // Iterate over all root nodes with insufficient height.
-    for (auto it: blocks_.right)
-        if (it.first != 0 && it.first < minimum_height)
-            hashes.push_back(it.second.hash());
+    const auto pooled = [this](const bc::message::inventory_vector& inventory)
+    {
+        return inventory.is_block_type() &&
+            blocks_.find(inventory.hash()) != blocks_.end();
+    };
 
-    // Get outside of the hash table iterator before deleting.
-    if (!hashes.empty())
-        prune(hashes, minimum_height);
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    // The lock is taken once for the batch, not once per inventory.
+    shared_lock lock(mutex_);
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        pooled), inventories.end());
+    ///////////////////////////////////////////////////////////////////////////
 }
 
-void block_pool::filter(get_data_ptr message) const
+// protected
+size_t block_pool::height(const node& entry)
 {
-    auto& inventories = message->inventories();
-    const auto& left = blocks_.left;
+    return entry.block->header().validation.height;
+}
 
-    for (auto it = inventories.begin(); it != inventories.end();)
-    {
-        if (!it->is_block_type())
-        {
-            ++it;
-            continue;
-        }
+// protected
+// The caller must hold the unique lock.
+void block_pool::plant(node& entry)
+{
+    entry.parent = nullptr;
+    roots_[height(entry)].insert(&entry);
+}
 
-        const block_entry entry{ it->hash() };
+// protected
+// The caller must hold the unique lock.
+void block_pool::unplant(node& entry)
+{
+    const auto bucket = roots_.find(height(entry));
 
-        ///////////////////////////////////////////////////////////////////////
-        // Critical Section
-        mutex_.lock_shared();
-        const auto found = (left.find(entry) != left.end());
-        mutex_.unlock_shared();
-        ///////////////////////////////////////////////////////////////////////
+    // An orphaned child of an erased node is not yet planted.
+    if (bucket == roots_.end())
+        return;
+
+    bucket->second.erase(&entry);
 
-        it = found ? inventories.erase(it) : it + 1;
+    if (bucket->second.empty())
+        roots_.erase(bucket);
+}
+
+// protected
+// The caller must hold the unique lock.
+void block_pool::erase(nodes::iterator it)
+{
+    auto& entry = it->second;
+
+    // Children are orphaned in place, the caller decides whether to replant.
+    for (const auto child: entry.children)
+        child->parent = nullptr;
+
+    if (entry.parent == nullptr)
+    {
+        unplant(entry);
     }
+    else
+    {
+        auto& siblings = entry.parent->children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), &entry),
+            siblings.end());
+    }
+
+    blocks_.erase(it);
 }
 
 // protected
@@ -221,12 +235,11 @@ bool block_pool::exists(block_const_ptr candidate_block) const
 {
     // The block must not yet be successfully validated.
     ////BITCOIN_ASSERT(candidate_block->validation.error);
-    const auto& left = blocks_.left;
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     shared_lock lock(mutex_);
-    return left.find(block_entry{ candidate_block }) != left.end();
+    return blocks_.find(candidate_block->hash()) != blocks_.end();
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -234,20 +247,18 @@ bool block_pool::exists(block_const_ptr candidate_block) const
 block_const_ptr block_pool::parent(block_const_ptr block) const
 {
     // The block may be validated (pool) or not (new).
-    const block_entry parent_entry{ block->header().previous_block_hash() };
-    const auto& left = blocks_.left;
+    const auto& parent_hash = block->header().previous_block_hash();
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     shared_lock lock(mutex_);
-    const auto parent = left.find(parent_entry);
-    return parent == left.end() ? nullptr : parent->first.block();
+    const auto parent = blocks_.find(parent_hash);
+    return parent == blocks_.end() ? nullptr : parent->second.block;
     ///////////////////////////////////////////////////////////////////////////
 }
 
 branch::ptr block_pool::get_path(block_const_ptr block) const
 {
-    ////log_content();
     const auto trace = std::make_shared<branch>();
 
     if (exists(block))
@@ -262,18 +273,5 @@ branch::ptr block_pool::get_path(block_const_ptr block) const
     return trace;
 }
 
-////// private
-////void block_pool::log_content() const
-////{
-////    LOG_INFO(LOG_BLOCKCHAIN) << "pool: ";
-////
-////    // Dump in hash order with height suffix (roots have height).
-////    for (const auto& entry: blocks_.left)
-////    {
-////        LOG_INFO(LOG_BLOCKCHAIN)
-////            << entry.first << " " << entry.second;
-////    }
-////}
-
 } // namespace blockchain
 } // namespace libbitcoin
@@ -34,7 +34,12 @@ using namespace bc::config;
 
 branch::branch(size_t height)
   : height_(height),
-    blocks_(std::make_shared<block_const_ptr_list>())
+    blocks_(std::make_shared<block_const_ptr_list>()),
+    indexed_(false),
+    spends_(0, spend_index::hasher(), spend_index::key_equal(),
+        spend_index::allocator_type(arena_)),
+    transactions_(0, tx_index::hasher(), tx_index::key_equal(),
+        tx_index::allocator_type(arena_))
 {
     blocks_->reserve(1);
 }
@@ -57,6 +62,11 @@ bool branch::push_front(block_const_ptr block)
     {
         // TODO: optimize.
         blocks_->insert(blocks_->begin(), block);
+
+        // The new block is the oldest, so it is offset by the branch size.
+        if (indexed_)
+            index_block(block, size() - 1u);
+
         return true;
     }
 
@@ -166,29 +176,70 @@ uint256_t branch::work() const
 ////    tx.validation.duplicate = count > 1u;
 ////}
 
-void branch::populate_spent(const output_point& outpoint) const
+// protected
+// Blocks must be indexed from top to bottom (or pushed front thereafter).
+// The first tx of a hash is retained as it is the highest (BIP30).
+void branch::index_block(block_const_ptr block, size_t offset) const
 {
-    const auto outer = [&outpoint](size_t total, block_const_ptr block)
+    const auto& txs = block->transactions();
+
+    for (size_t position = 0; position < txs.size(); ++position)
     {
-        const auto inner = [&outpoint](size_t sum, const transaction& tx)
-        {
-            const auto points = [&outpoint](const input& input)
-            {
-                return input.previous_output() == outpoint;
-            };
-
-            const auto& ins = tx.inputs();
-            return sum + std::count_if(ins.begin(), ins.end(), points);
-        };
-
-        const auto& txs = block->transactions();
-        return total + std::accumulate(txs.begin(), txs.end(), total, inner);
-    };
+        const auto& tx = txs[position];
+        transactions_.emplace(tx.hash(), location{ offset, position });
 
-    // Counting all is easier than excluding self and terminating early.
-    const auto spent = std::accumulate(blocks_->begin(), blocks_->end(),
-        size_t(0), outer);
+        for (const auto& input: tx.inputs())
+            ++spends_[input.previous_output()];
+    }
+}
+
+// protected
+void branch::ensure_index() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (indexed_)
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return;
+    }
 
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    const auto count = size();
+    size_t txs = 0;
+    size_t inputs = 0;
+
+    for (const auto block: *blocks_)
+    {
+        txs += block->transactions().size();
+        inputs += block->total_inputs();
+    }
+
+    // Size the tables once, since rehashed buckets are not reclaimed.
+    transactions_.reserve(txs);
+    spends_.reserve(inputs);
+
+    for (size_t offset = 0; offset < count; ++offset)
+        index_block((*blocks_)[count - offset - 1u], offset);
+
+    indexed_ = true;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void branch::populate_spent(const output_point& outpoint) const
+{
+    ensure_index();
+
+    // The index is not modified after creation during population.
+    const auto it = spends_.find(outpoint);
+    const auto spent = it == spends_.end() ? size_t(0) : it->second;
+
+    // Counting all is easier than excluding self and terminating early.
     BITCOIN_ASSERT(spent > 0);
     auto& prevout = outpoint.validation;
     prevout.spent = spent > 1u;
@@ -197,39 +248,7 @@ void branch::populate_spent(const output_point& outpoint) const
 
 void branch::populate_prevout(const output_point& outpoint) const
 {
-    const auto count = size();
     auto& prevout = outpoint.validation;
-    struct result { size_t height; size_t position; output out; };
-
-    const auto get_output = [this, count, &outpoint]() -> result
-    {
-        const auto& blocks = *blocks_;
-
-        // Reverse search because of BIP30.
-        for (size_t forward = 0; forward < count; ++forward)
-        {
-            const size_t index = count - forward - 1u;
-            const auto& txs = blocks[index]->transactions();
-
-            for (size_t position = 0; position < txs.size(); ++position)
-            {
-                const auto& tx = txs[position];
-
-                if (outpoint.hash() == tx.hash() &&
-                    outpoint.index() < tx.outputs().size())
-                {
-                    return
-                    {
-                        height_at(index),
-                        position,
-                        tx.outputs()[outpoint.index()]
-                    };
-                }
-            }
-        }
-
-        return{};
-    };
 
     // In case this input is a coinbase or the prevout is spent.
     prevout.cache = chain::output{};
@@ -242,19 +261,27 @@ void branch::populate_prevout(const output_point& outpoint) const
         return;
 
     // We continue even if prevout spent and/or missing.
+    ensure_index();
+
+    // Get the script and value for the prevout (highest due to BIP30).
+    const auto it = transactions_.find(outpoint.hash());
+
+    if (it == transactions_.end())
+        return;
 
-    // Get the script and value for the prevout.
-    const auto finder = get_output();
+    const auto index = size() - it->second.first - 1u;
+    const auto position = it->second.second;
+    const auto& tx = (*blocks_)[index]->transactions()[position];
 
-    if (!finder.out.is_valid())
+    if (outpoint.index() >= tx.outputs().size())
         return;
 
     // Found the prevout at or below the indexed block.
-    prevout.cache = finder.out;
+    prevout.cache = tx.outputs()[outpoint.index()];
 
     // Set height iff the prevout is coinbase (first tx is coinbase).
-    if (finder.position == 0)
-        prevout.height = finder.height;
+    if (position == 0)
+        prevout.height = height_at(index);
 }
 
 /// The bits of the block at the given height in the branch.
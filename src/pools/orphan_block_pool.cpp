@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/orphan_block_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+orphan_block_pool::orphan_block_pool(size_t limit, size_t byte_limit)
+  : limit_(limit),
+    byte_limit_(byte_limit == 0 ? max_size_t : byte_limit),
+    bytes_(0)
+{
+}
+
+size_t orphan_block_pool::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return orphans_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t orphan_block_pool::bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool orphan_block_pool::add(block_const_ptr block)
+{
+    if (limit_ == 0)
+        return false;
+
+    const auto hash = block->hash();
+    const auto size = to_bytes(block);
+
+    if (size > byte_limit_)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!orphans_.emplace(hash, block).second)
+        return false;
+
+    children_.emplace(block->header().previous_block_hash(), hash);
+    order_.push_back(hash);
+    bytes_ += size;
+
+    // Evict the oldest orphans once either limit is exceeded.
+    while (order_.size() > limit_ || bytes_ > byte_limit_)
+    {
+        const auto oldest = order_.front();
+        erase(oldest);
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool orphan_block_pool::exists(const hash_digest& hash) const
+{
+    if (limit_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return orphans_.find(hash) != orphans_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool orphan_block_pool::is_ancestor(const hash_digest& ancestor,
+    const hash_digest& hash, size_t distance) const
+{
+    auto descendant = hash;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (; distance > 0; --distance)
+    {
+        const auto it = orphans_.find(descendant);
+
+        if (it == orphans_.end())
+            return false;
+
+        descendant = it->second->header().previous_block_hash();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return descendant == ancestor;
+}
+
+block_const_ptr_list orphan_block_pool::remove(const hash_digest& parent)
+{
+    block_const_ptr_list blocks;
+
+    if (limit_ == 0)
+        return blocks;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    const auto range = children_.equal_range(parent);
+
+    for (auto it = range.first; it != range.second; ++it)
+        blocks.push_back(orphans_[it->second]);
+
+    for (const auto block: blocks)
+        erase(block->hash());
+
+    return blocks;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void orphan_block_pool::filter(get_data_ptr message) const
+{
+    if (limit_ == 0)
+        return;
+
+    auto& inventories = message->inventories();
+
+    const auto buffered = [this](const bc::message::inventory_vector& item)
+    {
+        return item.is_block_type() &&
+            orphans_.find(item.hash()) != orphans_.end();
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        buffered), inventories.end());
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+size_t orphan_block_pool::to_bytes(block_const_ptr block)
+{
+    return block->serialized_size(message::version::level::canonical);
+}
+
+// protected
+// The caller must hold the unique lock.
+void orphan_block_pool::erase(const hash_digest& hash)
+{
+    const auto it = orphans_.find(hash);
+
+    if (it == orphans_.end())
+        return;
+
+    const auto range = children_.equal_range(
+        it->second->header().previous_block_hash());
+
+    for (auto child = range.first; child != range.second; ++child)
+    {
+        if (child->second == hash)
+        {
+            children_.erase(child);
+            break;
+        }
+    }
+
+    order_.erase(std::find(order_.begin(), order_.end(), hash));
+    bytes_ -= to_bytes(it->second);
+    orphans_.erase(it);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
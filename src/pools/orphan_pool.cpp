@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/orphan_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+
+orphan_pool::orphan_pool(size_t limit, size_t byte_limit)
+  : limit_(limit),
+    byte_limit_(byte_limit == 0 ? max_size_t : byte_limit),
+    bytes_(0)
+{
+}
+
+size_t orphan_pool::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return orphans_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t orphan_pool::bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool orphan_pool::add(transaction_const_ptr tx)
+{
+    if (limit_ == 0)
+        return false;
+
+    const auto hash = tx->hash();
+    const auto size = to_bytes(tx);
+
+    if (size > byte_limit_)
+        return false;
+
+    point::list missing;
+
+    // Validation leaves the cache of each missing prevout invalid.
+    for (const auto& input: tx->inputs())
+        if (!input.previous_output().validation.cache.is_valid())
+            missing.push_back(input.previous_output());
+
+    // Without population (e.g. missing from accept) wait on every prevout.
+    if (missing.empty())
+        for (const auto& input: tx->inputs())
+            missing.push_back(input.previous_output());
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!orphans_.emplace(hash, tx).second)
+        return false;
+
+    for (const auto& point: missing)
+        waiting_.emplace(point, hash);
+
+    order_.push_back(hash);
+    bytes_ += size;
+
+    // Evict the oldest orphans once either limit is exceeded.
+    while (order_.size() > limit_ || bytes_ > byte_limit_)
+    {
+        const auto oldest = order_.front();
+        erase(oldest);
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool orphan_pool::exists(const hash_digest& hash) const
+{
+    if (limit_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return orphans_.find(hash) != orphans_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+orphan_pool::list orphan_pool::remove(transaction_const_ptr parent)
+{
+    list children;
+
+    if (limit_ == 0)
+        return children;
+
+    const auto hash = parent->hash();
+    const auto outputs = parent->outputs().size();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (orphans_.empty())
+        return children;
+
+    for (uint32_t index = 0; index < outputs; ++index)
+    {
+        const auto range = waiting_.equal_range({ hash, index });
+
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const auto child = orphans_.find(it->second);
+
+            // A child that spends more than one output is returned only once.
+            if (child != orphans_.end() &&
+                std::find(children.begin(), children.end(), child->second) ==
+                    children.end())
+                children.push_back(child->second);
+        }
+    }
+
+    for (const auto child: children)
+        erase(child->hash());
+
+    return children;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+size_t orphan_pool::to_bytes(transaction_const_ptr tx)
+{
+    return tx->serialized_size(message::version::level::canonical);
+}
+
+// protected
+// The caller must hold the unique lock.
+void orphan_pool::erase(const hash_digest& hash)
+{
+    const auto it = orphans_.find(hash);
+
+    if (it == orphans_.end())
+        return;
+
+    for (const auto& input: it->second->inputs())
+    {
+        const auto range = waiting_.equal_range(input.previous_output());
+
+        for (auto point = range.first; point != range.second;)
+            point = point->second == hash ? waiting_.erase(point) : ++point;
+    }
+
+    order_.erase(std::find(order_.begin(), order_.end(), hash));
+    bytes_ -= to_bytes(it->second);
+    orphans_.erase(it);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/prioritized_mutex.hpp>
+
+#include <mutex>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+prioritized_mutex::prioritized_mutex()
+  : high_(0)
+{
+}
+
+// The request is counted before the lock so that low priority requests
+// arriving from here on are held at the gate until it is released.
+void prioritized_mutex::lock_high_priority()
+{
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex_);
+        ++high_;
+    }
+
+    mutex_.lock();
+}
+
+void prioritized_mutex::unlock_high_priority()
+{
+    mutex_.unlock();
+
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex_);
+        BITCOIN_ASSERT(high_ > 0);
+        --high_;
+    }
+
+    gate_.notify_all();
+}
+
+void prioritized_mutex::lock_low_priority()
+{
+    admit_low_priority();
+    mutex_.lock();
+}
+
+void prioritized_mutex::unlock_low_priority()
+{
+    mutex_.unlock();
+}
+
+void prioritized_mutex::lock_low_priority_shared()
+{
+    admit_low_priority();
+    mutex_.lock_shared();
+}
+
+void prioritized_mutex::unlock_low_priority_shared()
+{
+    mutex_.unlock_shared();
+}
+
+// private
+// A request admitted before a high priority request may still precede it.
+void prioritized_mutex::admit_low_priority()
+{
+    const auto open = [this]()
+    {
+        return high_ == 0;
+    };
+
+    std::unique_lock<std::mutex> lock(gate_mutex_);
+    gate_.wait(lock, open);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
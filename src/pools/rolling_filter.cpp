@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/rolling_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// About 29 bits and 20 probes per hash give a one in a million error rate
+// per generation.
+static constexpr size_t bits_per_hash = 29;
+static constexpr size_t probes = 20;
+static constexpr size_t word_bits = 64;
+
+// Two 64 bit values of the (uniformly distributed) hash seed the probes.
+inline uint64_t read_word(const hash_digest& hash, size_t offset)
+{
+    uint64_t value = 0;
+
+    for (size_t byte = 0; byte < sizeof(uint64_t); ++byte)
+        value |= uint64_t(hash[offset + byte]) << (byte * 8u);
+
+    return value;
+}
+
+rolling_filter::rolling_filter(size_t limit)
+  : limit_(limit),
+    size_(std::max(uint64_t(limit) * bits_per_hash, uint64_t(word_bits))),
+    salt_(pseudo_random()),
+    count_(0),
+    current_(limit == 0 ? 0 : size_ / word_bits + 1u, 0),
+    previous_(current_.size(), 0)
+{
+}
+
+void rolling_filter::add(const hash_digest& hash)
+{
+    if (limit_ == 0)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Roll the generations once the current is full.
+    if (count_ == limit_)
+    {
+        previous_.swap(current_);
+        std::fill(current_.begin(), current_.end(), 0);
+        count_ = 0;
+    }
+
+    set(current_, hash);
+    ++count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool rolling_filter::contains(const hash_digest& hash) const
+{
+    if (limit_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return test(current_, hash) || test(previous_, hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void rolling_filter::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    std::fill(current_.begin(), current_.end(), 0);
+    std::fill(previous_.begin(), previous_.end(), 0);
+    count_ = 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+// Probes are derived by double hashing, salted against crafted collisions.
+void rolling_filter::set(bits& generation, const hash_digest& hash) const
+{
+    const auto first = read_word(hash, 0) ^ salt_;
+    const auto step = read_word(hash, sizeof(uint64_t)) | 1u;
+
+    for (size_t probe = 0; probe < probes; ++probe)
+    {
+        const auto bit = (first + probe * step) % size_;
+        generation[bit / word_bits] |= uint64_t(1) << (bit % word_bits);
+    }
+}
+
+// protected
+bool rolling_filter::test(const bits& generation,
+    const hash_digest& hash) const
+{
+    const auto first = read_word(hash, 0) ^ salt_;
+    const auto step = read_word(hash, sizeof(uint64_t)) | 1u;
+
+    for (size_t probe = 0; probe < probes; ++probe)
+    {
+        const auto bit = (first + probe * step) % size_;
+        const auto mask = uint64_t(1) << (bit % word_bits);
+
+        if ((generation[bit / word_bits] & mask) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,317 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/stage_pools.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/settings.hpp>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace libbitcoin {
+namespace blockchain {
+
+#define NAME "stage_pools"
+
+static const std::string node_prefix = "node";
+
+// Cpu (and node) numbers at or above this cannot be pinned, so are invalid.
+#ifdef __linux__
+static constexpr size_t cpu_limit = CPU_SETSIZE;
+#else
+static constexpr size_t cpu_limit = 1024;
+#endif
+
+// Read the cpu list of the numa node from sysfs.
+static bool read_node(std::string& out, const std::string& node)
+{
+    std::ifstream file("/sys/devices/system/node/node" + node + "/cpulist");
+    return std::getline(file, out) && !out.empty();
+}
+
+// Parse an unsigned decimal below the cpu limit, without sign or whitespace.
+// The bound is applied per digit, so the parse cannot overflow or throw.
+static bool to_number(size_t& out, const std::string& text)
+{
+    if (text.empty())
+        return false;
+
+    out = 0;
+
+    for (const auto digit: text)
+    {
+        if (digit < '0' || digit > '9')
+            return false;
+
+        out = out * 10u + static_cast<size_t>(digit - '0');
+
+        if (out >= cpu_limit)
+            return false;
+    }
+
+    return true;
+}
+
+bool stage_pools::to_cpus(cpus& out, const std::string& text)
+{
+    out.clear();
+    auto list = boost::algorithm::trim_copy(text);
+
+    if (boost::algorithm::starts_with(list, node_prefix))
+    {
+        size_t node;
+        const auto number = list.substr(node_prefix.size());
+
+        if (!to_number(node, number) || !read_node(list, number))
+            return false;
+    }
+
+    std::vector<std::string> tokens;
+    boost::algorithm::split(tokens, list, boost::is_any_of(","));
+
+    for (const auto& token: tokens)
+    {
+        size_t first;
+        size_t last;
+        const auto dash = token.find('-');
+        const auto trimmed = boost::algorithm::trim_copy(token);
+
+        if (dash == std::string::npos)
+        {
+            if (!to_number(first, trimmed))
+                return false;
+
+            last = first;
+        }
+        else if (!to_number(first, boost::algorithm::trim_copy(
+            token.substr(0, dash))) || !to_number(last,
+                boost::algorithm::trim_copy(token.substr(dash + 1u))) ||
+            last < first)
+        {
+            return false;
+        }
+
+        for (auto cpu = first; cpu <= last; ++cpu)
+            out.push_back(cpu);
+    }
+
+    return !out.empty();
+}
+
+stage_pools::stage_pools(const settings& settings)
+  : populate_pool_(thread_ceiling(settings.cores),
+        priority(settings.priority)),
+    script_pool_(settings.script_cores == 0 ? 0 :
+        thread_ceiling(settings.script_cores), priority(settings.priority)),
+    store_pool_(settings.store_cores == 0 ? 0 :
+        thread_ceiling(settings.store_cores), priority(settings.priority)),
+    populate_(populate_pool_, NAME "_populate"),
+    script_(settings.script_cores == 0 ? populate_pool_ : script_pool_,
+        NAME "_script"),
+    store_(settings.store_cores == 0 ? populate_pool_ : store_pool_,
+        NAME "_store")
+{
+    pin(populate_pool_, populate_.size(), settings.populate_cpus, "populate");
+
+    if (settings.script_cores != 0)
+        pin(script_pool_, script_.size(), settings.script_cpus, "script");
+    else
+        ignore(settings.script_cpus, "script");
+
+    if (settings.store_cores != 0)
+        pin(store_pool_, store_.size(), settings.store_cpus, "store");
+    else
+        ignore(settings.store_cpus, "store");
+}
+
+// A batch is taken by the first thread to claim its index. Pool threads that
+// find none left return without reading the batches, which may be gone.
+void stage_pools::concurrent(dispatcher& dispatch, const batches& batches)
+{
+    struct join
+    {
+        std::atomic<size_t> next;
+        std::atomic<size_t> done;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    const auto count = batches.size();
+    const auto state = std::make_shared<join>();
+    const auto list = &batches;
+    state->next = 0;
+    state->done = 0;
+
+    const auto run = [state, list, count]()
+    {
+        for (auto index = state->next++; index < count;
+            index = state->next++)
+        {
+            (*list)[index]();
+
+            if (++state->done == count)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->condition.notify_all();
+            }
+        }
+    };
+
+    for (size_t batch = 1; batch < count; ++batch)
+        dispatch.concurrent(run);
+
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state, count]()
+    {
+        return state->done == count;
+    });
+}
+
+dispatcher& stage_pools::populate()
+{
+    return populate_;
+}
+
+dispatcher& stage_pools::script()
+{
+    return script_;
+}
+
+dispatcher& stage_pools::store()
+{
+    return store_;
+}
+
+void stage_pools::shutdown()
+{
+    populate_pool_.shutdown();
+    script_pool_.shutdown();
+    store_pool_.shutdown();
+}
+
+void stage_pools::join()
+{
+    populate_pool_.join();
+    script_pool_.join();
+    store_pool_.join();
+}
+
+// private
+void stage_pools::pin(threadpool& pool, size_t threads,
+    const std::string& text, const std::string& stage)
+{
+    cpus set;
+
+    if (text.empty())
+        return;
+
+    if (!to_cpus(set, text))
+    {
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Invalid " << stage << " cpus (" << text << "), not pinned.";
+        return;
+    }
+
+    if (!pin(pool, threads, set))
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Failed to pin " << stage << " threads to cpus (" << text
+            << ").";
+}
+
+// private
+// A stage without its own pool runs on the populate threads and their cpus.
+void stage_pools::ignore(const std::string& text, const std::string& stage)
+{
+    if (!text.empty())
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Ignoring " << stage << " cpus (" << text << "), "
+            << stage << " cores is zero so it shares the populate threads.";
+}
+
+// private
+// Each pool thread must pin itself, so one task is posted per thread and
+// each waits until all are running, which places every task on a distinct
+// thread. The pool is idle as this is called from construction.
+bool stage_pools::pin(threadpool& pool, size_t threads, const cpus& cpus)
+{
+#ifdef __linux__
+    if (threads == 0)
+        return true;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (const auto cpu: cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+
+        CPU_SET(cpu, &set);
+    }
+
+    size_t running = 0;
+    size_t failures = 0;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::promise<void>> pinned(threads);
+
+    for (size_t thread = 0; thread < threads; ++thread)
+    {
+        pool.service().post([&, thread]()
+        {
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            std::unique_lock<std::mutex> lock(mutex);
+            ++running;
+            condition.notify_all();
+            condition.wait(lock, [&]() { return running == threads; });
+
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                ++failures;
+            ///////////////////////////////////////////////////////////////////
+
+            pinned[thread].set_value();
+        });
+    }
+
+    for (auto& promise: pinned)
+        promise.get_future().wait();
+
+    return failures == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
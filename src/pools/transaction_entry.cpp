@@ -42,6 +42,21 @@ transaction_entry::transaction_entry(transaction_const_ptr tx)
    fees_(tx->fees()),
    forks_(tx->validation.state->enabled_forks()),
    hash_(tx->hash()),
+   transaction_(tx),
+   marked_(false)
+{
+}
+
+// Prevouts are not populated, so fees cannot be computed.
+transaction_entry::transaction_entry(const chain::transaction& tx,
+    uint32_t forks)
+ : size_(cap(tx.serialized_size(message::version::level::canonical))),
+   sigops_(cap(tx.signature_operations(
+       (forks & machine::rule_fork::bip16_rule) != 0))),
+   fees_(0),
+   forks_(forks),
+   hash_(tx.hash()),
+   transaction_(nullptr),
    marked_(false)
 {
 }
@@ -53,6 +68,7 @@ transaction_entry::transaction_entry(const hash_digest& hash)
    fees_(0),
    forks_(0),
    hash_(hash),
+   transaction_(nullptr),
    marked_(false)
 {
 }
@@ -86,6 +102,12 @@ size_t transaction_entry::size() const
     return size_;
 }
 
+// Null unless the entry was created from a validated transaction.
+transaction_const_ptr transaction_entry::transaction() const
+{
+    return transaction_;
+}
+
 // Not valid if the entry is a search key.
 const hash_digest& transaction_entry::hash() const
 {
@@ -126,6 +148,15 @@ void transaction_entry::add_child(ptr child)
     children_.push_back(child);
 }
 
+// This is guarded against missing entries.
+void transaction_entry::remove_parent(ptr parent)
+{
+    const auto it = find(parents_.begin(), parents_.end(), parent);
+
+    if (it != parents_.end())
+        parents_.erase(it);
+}
+
 // This is guarded against missing entries.
 void transaction_entry::remove_child(ptr child)
 {
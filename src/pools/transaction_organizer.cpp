@@ -18,15 +18,21 @@
  */
 #include <bitcoin/blockchain/pools/transaction_organizer.hpp>
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstddef>
 #include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/interface/chain_metrics.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
+#include <bitcoin/blockchain/pools/rolling_filter.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
 #include <bitcoin/blockchain/validate/validate_transaction.hpp>
 
@@ -38,17 +44,30 @@ using namespace std::placeholders;
 #define NAME "transaction_organizer"
 
 // TODO: create priority pool at blockchain level and use in both organizers. 
-transaction_organizer::transaction_organizer(shared_mutex& mutex,
-    dispatcher& dispatch, threadpool& thread_pool, fast_chain& chain,
+transaction_organizer::transaction_organizer(prioritized_mutex& mutex,
+    stage_pools& pools, threadpool& thread_pool, fast_chain& chain,
+    transaction_pool& pool, script_cache& cache, chain_metrics& metrics,
     const settings& settings)
   : fast_chain_(chain),
     mutex_(mutex),
     stopped_(true),
+    concurrent_(settings.concurrent_transactions),
     minimum_byte_fee_(settings.minimum_byte_fee_satoshis),
-    dispatch_(dispatch),
-    transaction_pool_(settings),
-    validator_(dispatch, fast_chain_, settings),
-    subscriber_(std::make_shared<transaction_subscriber>(thread_pool, NAME))
+    dispatch_(pools.store()),
+    transaction_pool_(pool),
+    metrics_(metrics),
+    validator_(pools.populate(), pools.script(), fast_chain_, pool, settings,
+        cache),
+    subscriber_(std::make_shared<transaction_subscriber>(thread_pool, NAME)),
+    notifications_(settings.notification_limit == 0 ? nullptr :
+        std::make_shared<transaction_queue>(thread_pool,
+            settings.notification_limit,
+            std::bind(&transaction_organizer::deliver_transaction,
+                this, _1))),
+    seen_(settings.seen_transaction_limit),
+    rejected_(settings.rejected_transaction_limit),
+    orphans_(settings.orphan_transaction_limit,
+        settings.orphan_transaction_bytes)
 {
 }
 
@@ -67,6 +86,10 @@ bool transaction_organizer::start()
 {
     stopped_ = false;
     subscriber_->start();
+
+    if (notifications_)
+        notifications_->start();
+
     validator_.start();
     return true;
 }
@@ -74,6 +97,10 @@ bool transaction_organizer::start()
 bool transaction_organizer::stop()
 {
     validator_.stop();
+
+    if (notifications_)
+        notifications_->stop();
+
     subscriber_->stop();
     subscriber_->invoke(error::service_stopped, {});
     stopped_ = true;
@@ -87,17 +114,58 @@ bool transaction_organizer::stop()
 void transaction_organizer::organize(transaction_const_ptr tx,
     result_handler handler)
 {
+    const auto ec = organize_one(tx);
+
+    // Invoke caller handler outside of critical section.
+    handler(ec);
+
+    if (!ec && !tx->validation.simulate)
+        resubmit(tx);
+}
+
+// private
+code transaction_organizer::organize_one(transaction_const_ptr tx)
+{
+    const auto hash = tx->hash();
+
+    // Drop re-announcements before contending for the critical section.
+    if (seen_.contains(hash))
+        return error::unspent_duplicate;
+
+    // The code of the prior rejection is not retained.
+    if (rejected_.contains(hash))
+        return error::operation_failed;
+
+    // The tx is resubmitted once its parent is stored.
+    if (orphans_.exists(hash))
+        return error::missing_previous_output;
+
+    const auto ec = concurrent_ ? organize_concurrent(tx) :
+        organize_sequential(tx);
+
+    // An orphan is pooled within the critical section (see pool_orphan).
+    if (is_rejection(ec))
+        rejected_.add(hash);
+
+    return ec;
+}
+
+// private
+code transaction_organizer::organize_sequential(transaction_const_ptr tx)
+{
+    const auto start_lock = asio::steady_clock::now();
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock();
+    mutex_.lock_low_priority();
+    metrics_.transaction_lock.record(start_lock, asio::steady_clock::now());
 
     // The stop check must be guarded.
     if (stopped())
     {
-        mutex_.unlock();
+        mutex_.unlock_low_priority();
         //---------------------------------------------------------------------
-        handler(error::service_stopped);
-        return;
+        return error::service_stopped;
     }
 
     // Checks that are independent of chain state.
@@ -105,10 +173,9 @@ void transaction_organizer::organize(transaction_const_ptr tx,
 
     if (ec)
     {
-        mutex_.unlock();
+        mutex_.unlock_low_priority();
         //---------------------------------------------------------------------
-        handler(ec);
-        return;
+        return ec;
     }
 
     // Reset the reusable promise.
@@ -130,11 +197,188 @@ void transaction_organizer::organize(transaction_const_ptr tx,
     // If we do not wait on the original thread there may be none left.
     ec = resume_.get_future().get();
 
-    mutex_.unlock();
+    if (ec == error::missing_previous_output)
+        pool_orphan(tx);
+
+    mutex_.unlock_low_priority();
     ///////////////////////////////////////////////////////////////////////////
 
-    // Invoke caller handler outside of critical section.
-    handler(ec);
+    return ec;
+}
+
+// private
+// The caller must hold the critical section (shared or unique). A parent is
+// stored only under the unique section and its orphans are resubmitted after
+// that, so an orphan pooled here cannot miss the resubmit of its parent.
+void transaction_organizer::pool_orphan(transaction_const_ptr tx)
+{
+    if (!tx->validation.simulate)
+        orphans_.add(tx);
+}
+
+// private
+// Organize the orphans waiting on outputs of the stored parent, and in turn
+// those waiting on each stored orphan. This runs on the caller's thread.
+void transaction_organizer::resubmit(transaction_const_ptr parent)
+{
+    auto pending = orphans_.remove(parent);
+
+    while (!pending.empty())
+    {
+        const auto child = pending.back();
+        pending.pop_back();
+
+        // A failed child is pooled again or rejected within organize.
+        if (organize_one(child))
+            continue;
+
+        const auto children = orphans_.remove(child);
+        pending.insert(pending.end(), children.begin(), children.end());
+    }
+}
+
+// Concurrent organize sequence.
+//-----------------------------------------------------------------------------
+// Txs are validated under the shared critical section, concurrently with each
+// other but not with blocks. Txs with a common prevout are claimed in sequence
+// and only the store push is exclusive.
+
+// private
+code transaction_organizer::organize_concurrent(transaction_const_ptr tx)
+{
+    // Checks that are independent of chain state.
+    auto ec = validator_.check(tx);
+
+    if (ec)
+        return ec;
+
+    claim(tx);
+    auto start_lock = asio::steady_clock::now();
+
+    // Critical Section (shared)
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_low_priority_shared();
+    metrics_.transaction_lock.record(start_lock, asio::steady_clock::now());
+
+    // The stop check must be guarded.
+    ec = stopped() ? error::service_stopped : validate(tx);
+    const auto state = tx->validation.state;
+
+    if (ec == error::missing_previous_output)
+        pool_orphan(tx);
+
+    mutex_.unlock_low_priority_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!ec && !tx->validation.simulate)
+    {
+        start_lock = asio::steady_clock::now();
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock_low_priority();
+        metrics_.transaction_lock.record(start_lock,
+            asio::steady_clock::now());
+
+        // A block was organized since validation, so validate again.
+        if (stopped())
+            ec = error::service_stopped;
+        else if (fast_chain_.chain_state() != state)
+            ec = validate(tx);
+
+        if (!ec)
+            ec = push(tx);
+        else if (ec == error::missing_previous_output)
+            pool_orphan(tx);
+
+        mutex_.unlock_low_priority();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    release(tx);
+    return ec;
+}
+
+// private
+// Accept and connect the tx, waiting on the result.
+code transaction_organizer::validate(transaction_const_ptr tx)
+{
+    std::promise<code> promise;
+
+    const result_handler complete = [&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    };
+
+    const auto accept_handler =
+        std::bind(&transaction_organizer::handle_accept,
+            this, _1, tx, complete);
+
+    // Waiting here keeps the caller off of the priority threads.
+    validator_.accept(tx, accept_handler);
+    return promise.get_future().get();
+}
+
+// private
+// Push the validated tx to the store and pool, waiting on the result.
+code transaction_organizer::push(transaction_const_ptr tx)
+{
+    std::promise<code> promise;
+
+    const result_handler complete = [&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    };
+
+    const auto pushed_handler =
+        std::bind(&transaction_organizer::handle_pushed,
+            this, _1, tx, complete);
+
+    //#########################################################################
+    fast_chain_.push(tx, dispatch_, pushed_handler);
+    //#########################################################################
+    return promise.get_future().get();
+}
+
+// private
+// Wait until none of the tx prevouts is claimed, then claim them all.
+void transaction_organizer::claim(transaction_const_ptr tx)
+{
+    const auto& inputs = tx->inputs();
+
+    const auto unclaimed = [this, &inputs]()
+    {
+        for (const auto& input: inputs)
+            if (claims_.find(input.previous_output()) != claims_.end())
+                return false;
+
+        return true;
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(claims_mutex_);
+    claims_condition_.wait(lock, unclaimed);
+
+    for (const auto& input: inputs)
+        claims_.insert(input.previous_output());
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void transaction_organizer::release(transaction_const_ptr tx)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(claims_mutex_);
+
+        for (const auto& input: tx->inputs())
+            claims_.erase(input.previous_output());
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    claims_condition_.notify_all();
 }
 
 // private
@@ -201,6 +445,13 @@ void transaction_organizer::handle_connect(const code& ec,
         return;
     }
 
+    // The concurrent sequence pushes within the exclusive critical section.
+    if (concurrent_)
+    {
+        handler(error::success);
+        return;
+    }
+
     const auto pushed_handler =
         std::bind(&transaction_organizer::handle_pushed,
             this, _1, tx, handler);
@@ -230,12 +481,80 @@ void transaction_organizer::handle_pushed(const code& ec,
         return;
     }
 
+    // Index the stored tx so that block population need not query the store.
+    transaction_pool_.add(tx);
+    seen_.add(tx->hash());
+
     // This gets picked up by node tx-out protocol for announcement to peers.
     notify_transaction(tx);
 
     handler(error::success);
 }
 
+// Dry-run sequence.
+//-----------------------------------------------------------------------------
+// Tx population is stateless, so a dry run takes only the shared critical
+// section, as does concurrent tx validation. This excludes block organization
+// and tx pushes. The result is advisory, as the chain may move on.
+
+void transaction_organizer::validate_only(transaction_const_ptr tx,
+    result_handler handler) const
+{
+    if (stopped())
+    {
+        handler(error::service_stopped);
+        return;
+    }
+
+    auto ec = validator_.check(tx);
+
+    if (ec)
+    {
+        handler(ec);
+        return;
+    }
+
+    // Critical Section (shared)
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_low_priority_shared();
+
+    // The stop check must be guarded.
+    if (stopped())
+    {
+        mutex_.unlock_low_priority_shared();
+        //---------------------------------------------------------------------
+        handler(error::service_stopped);
+        return;
+    }
+
+    const auto validate = [&](void (validate_transaction::*stage)(
+        transaction_const_ptr, validate_transaction::result_handler) const)
+    {
+        std::promise<code> promise;
+        const auto complete = [&promise](const code& ec)
+        {
+            promise.set_value(ec);
+        };
+
+        // Waiting here keeps the caller off of the priority threads.
+        (validator_.*stage)(tx, complete);
+        return promise.get_future().get();
+    };
+
+    ec = validate(&validate_transaction::accept);
+
+    if (!ec && tx->fees() < minimum_byte_fee_ * tx->serialized_size(true))
+        ec = error::insufficient_fee;
+
+    if (!ec)
+        ec = validate(&validate_transaction::connect);
+
+    mutex_.unlock_low_priority_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    handler(ec);
+}
+
 // Subscription.
 //-----------------------------------------------------------------------------
 
@@ -244,6 +563,21 @@ void transaction_organizer::notify_transaction(transaction_const_ptr tx)
 {
     // Using invoke slows down catch-up sync and is a deadlock risk, but
     // relay can create big backlog that can easily bring down the server.
+    // The queue invokes from its worker and bounds the backlog instead, each
+    // pass delivering the txs accepted since the last (announcement batch).
+    if (notifications_)
+    {
+        auto copy = tx;
+        notifications_->push(std::move(copy));
+        return;
+    }
+
+    subscriber_->invoke(error::success, tx);
+}
+
+// private
+void transaction_organizer::deliver_transaction(transaction_const_ptr& tx)
+{
     subscriber_->invoke(error::success, tx);
 }
 
@@ -263,13 +597,48 @@ void transaction_organizer::fetch_template(
 }
 
 void transaction_organizer::fetch_mempool(size_t maximum,
-    inventory_fetch_handler handler) const
+    uint64_t minimum_fee, inventory_fetch_handler handler) const
+{
+    transaction_pool_.fetch_mempool(maximum, minimum_fee, handler);
+}
+
+void transaction_organizer::filter(get_data_ptr message) const
 {
-    transaction_pool_.fetch_mempool(maximum, handler);
+    auto& inventories = message->inventories();
+
+    const auto known = [this](const bc::message::inventory_vector& inventory)
+    {
+        return inventory.is_transaction_type() &&
+            (seen_.contains(inventory.hash()) ||
+                rejected_.contains(inventory.hash()) ||
+                orphans_.exists(inventory.hash()));
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        known), inventories.end());
+}
+
+void transaction_organizer::confirm(block_const_ptr_list_const_ptr blocks)
+{
+    for (const auto block: *blocks)
+        for (const auto& tx: block->transactions())
+            seen_.add(tx.hash());
+
+    // A rejection may not hold under the new chain state (e.g. locktime).
+    rejected_.clear();
 }
 
 // Utility.
 //-----------------------------------------------------------------------------
 
+// private
+// Failures that may not recur (stop, orphan and store) are not recorded.
+bool transaction_organizer::is_rejection(const code& ec)
+{
+    return ec && ec != error::service_stopped &&
+        ec != error::missing_previous_output &&
+        ec != error::operation_failed;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
@@ -18,9 +18,13 @@
  */
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/pools/transaction_entry.hpp>
 #include <bitcoin/blockchain/settings.hpp>
 
 namespace libbitcoin {
@@ -32,26 +36,515 @@ namespace blockchain {
 // exmaple implementation simply tests all txs in a new block against
 // transactions in previous blocks.
 
+// No enabled forks value can match this, so the entry is never current.
+const uint32_t transaction_pool::sentinel_forks = max_uint32;
+
+// Space and sigops reserved for the coinbase of the template.
+static constexpr size_t coinbase_reserved_size = 1000;
+static constexpr size_t coinbase_reserved_sigops = 100;
+
+bool transaction_pool::rank::operator<(const rank& other) const
+{
+    return rate == other.rate ? entry->hash() < other.entry->hash() :
+        rate > other.rate;
+}
+
 transaction_pool::transaction_pool(const settings& settings)
-  ////: reject_conflicts_(settings.reject_conflicts),
+  : template_height_(max_size_t)
+  ////  reject_conflicts_(settings.reject_conflicts),
   ////  minimum_fee_(settings.minimum_fee_satoshis)
 {
 }
 
-// TODO: implement block template discovery.
+size_t transaction_pool::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The transaction must be validated, which populates its chain state.
+void transaction_pool::add(transaction_const_ptr valid_tx)
+{
+    const auto state = valid_tx->validation.state;
+    BITCOIN_ASSERT(state);
+    const auto entry = std::make_shared<transaction_entry>(valid_tx);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // The tx is validated for the next block, which is the template height.
+    template_height_ = state->height();
+    add(entry, *valid_tx);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_pool::add(const chain::transaction& tx, uint32_t forks)
+{
+    const auto entry = std::make_shared<transaction_entry>(tx, forks);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    add(entry, tx);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+void transaction_pool::add(transaction_entry::ptr entry,
+    const chain::transaction& tx)
+{
+    const auto it = entries_.find(entry->hash());
+
+    // Replace any existing entry, the store holds only one unconfirmed.
+    if (it != entries_.end())
+    {
+        const auto existing = it->second;
+        const auto children = existing->children();
+
+        for (const auto child: children)
+        {
+            child->remove_parent(existing);
+            child->add_parent(entry);
+            entry->add_child(child);
+        }
+
+        erase(existing);
+    }
+
+    chain::point::list points;
+    points.reserve(tx.inputs().size());
+
+    // Link the entry to its pooled parents (one link per parent).
+    for (const auto& input: tx.inputs())
+    {
+        // Index the spend, a conflict can be restored from reorganization.
+        const auto& prevout = input.previous_output();
+        spends_[prevout] = entry;
+        points.push_back(prevout);
+
+        const auto parent = entries_.find(prevout.hash());
+
+        if (parent == entries_.end())
+            continue;
+
+        const auto& parents = entry->parents();
+
+        if (std::find(parents.begin(), parents.end(), parent->second) !=
+            parents.end())
+            continue;
+
+        entry->add_parent(parent->second);
+        parent->second->add_child(entry);
+    }
+
+    prevouts_[entry->hash()] = std::move(points);
+    entries_.emplace(entry->hash(), entry);
+    update(entry);
+
+    // Replaced children inherit the ancestors of the new entry.
+    entry_set descendants;
+    get_descendants(entry, descendants);
+
+    for (const auto descendant: descendants)
+        update(descendant);
+}
+
+void transaction_pool::remove(block_const_ptr_list_const_ptr confirmed_blocks)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!confirmed_blocks->empty())
+    {
+        const auto& top = confirmed_blocks->back()->header();
+        template_height_ = top.validation.height + 1u;
+        template_.reset();
+    }
+
+    if (entries_.empty())
+        return;
+
+    entry_set descendants;
+    transaction_entry::list conflicts;
+
+    for (const auto block: *confirmed_blocks)
+    {
+        for (const auto& tx: block->transactions())
+        {
+            // Confirmed spends are enforced by the store, not the pool.
+            for (const auto& input: tx.inputs())
+            {
+                const auto spend = spends_.find(input.previous_output());
+
+                if (spend == spends_.end())
+                    continue;
+
+                // A different pooled spender of the outpoint is a conflict.
+                if (spend->second->hash() != tx.hash())
+                    conflicts.push_back(spend->second);
+
+                spends_.erase(spend);
+            }
+
+            const auto it = entries_.find(tx.hash());
+
+            if (it == entries_.end())
+                continue;
+
+            const auto entry = it->second;
+            get_descendants(entry, descendants);
+            erase(entry);
+        }
+    }
+
+    // Conflicts and their descendants spend outputs that no longer exist.
+    for (const auto conflict: conflicts)
+    {
+        const auto it = entries_.find(conflict->hash());
+
+        if (it == entries_.end() || it->second != conflict)
+            continue;
+
+        entry_set invalid;
+        get_descendants(conflict, invalid);
+        invalid.insert(conflict);
+
+        for (const auto entry: invalid)
+        {
+            descendants.erase(entry);
+            erase(entry);
+        }
+    }
+
+    // The remaining descendants have lost confirmed ancestors, which leaves
+    // them valid, so only their ancestor packages are recomputed.
+    for (const auto descendant: descendants)
+        if (entries_.find(descendant->hash()) != entries_.end())
+            update(descendant);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Outgoing transactions remain in the store but are no longer validated.
+void transaction_pool::restore(block_const_ptr_list_const_ptr outgoing_blocks)
+{
+    for (const auto block: *outgoing_blocks)
+    {
+        const auto& txs = block->transactions();
+
+        // The coinbase is invalid outside of its block.
+        for (auto tx = txs.begin() + 1; tx < txs.end(); ++tx)
+            add(*tx, sentinel_forks);
+    }
+}
+
+transaction_entry::ptr transaction_pool::find(const hash_digest& tx_hash) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto it = entries_.find(tx_hash);
+    return it == entries_.end() ? nullptr : it->second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+transaction_entry::list transaction_pool::get_validated() const
+{
+    transaction_entry::list out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    out.reserve(entries_.size());
+
+    for (const auto& entry: entries_)
+        if (entry.second->forks() != sentinel_forks &&
+            entry.second->transaction())
+            out.push_back(entry.second);
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+transaction_entry::ptr transaction_pool::find_spender(
+    const chain::output_point& outpoint) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto it = spends_.find(outpoint);
+    return it == spends_.end() ? nullptr : it->second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_pool::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Links must be cleared as parent/child pointers are circular.
+    while (!entries_.empty())
+        erase(entries_.begin()->second);
+
+    spends_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+void transaction_pool::erase(transaction_entry::ptr entry)
+{
+    const auto& hash = entry->hash();
+    const auto rate = rates_.find(hash);
+
+    if (rate != rates_.end())
+    {
+        ranking_.erase({ rate->second, entry });
+        rates_.erase(rate);
+    }
+
+    // Copy the lists as they are modified by unlinking.
+    const auto parents = entry->parents();
+    const auto children = entry->children();
+
+    for (const auto parent: parents)
+    {
+        parent->remove_child(entry);
+        entry->remove_parent(parent);
+    }
+
+    for (const auto child: children)
+    {
+        child->remove_parent(entry);
+        entry->remove_child(child);
+    }
+
+    const auto points = prevouts_.find(hash);
+
+    if (points != prevouts_.end())
+    {
+        // Retain spends indexed to a conflicting entry.
+        for (const auto& point: points->second)
+        {
+            const auto spend = spends_.find(point);
+
+            if (spend != spends_.end() && spend->second == entry)
+                spends_.erase(spend);
+        }
+
+        prevouts_.erase(points);
+    }
+
+    entries_.erase(hash);
+    template_.reset();
+}
+
+// protected
+// Reposition the entry in the ranking based on its current ancestry.
+void transaction_pool::update(transaction_entry::ptr entry)
+{
+    const auto& hash = entry->hash();
+    const auto rate = rates_.find(hash);
+
+    if (rate != rates_.end())
+    {
+        ranking_.erase({ rate->second, entry });
+        rates_.erase(rate);
+    }
+
+    template_.reset();
+    const auto aggregate = get_package(entry);
+
+    // Unvalidated entries (or descendants) are excluded from the template.
+    if (!aggregate.eligible)
+        return;
+
+    const auto value = aggregate.size == 0 ? 0.0 :
+        static_cast<double>(aggregate.fees) / aggregate.size;
+
+    rates_.emplace(hash, value);
+    ranking_.insert({ value, entry });
+}
+
+// protected
+transaction_pool::package transaction_pool::get_package(
+    transaction_entry::ptr entry) const
+{
+    entry_set visited;
+    transaction_entry::list ancestors;
+    get_ancestors(entry, {}, visited, ancestors);
+
+    package aggregate{ 0, 0, 0, true };
+
+    for (const auto ancestor: ancestors)
+    {
+        aggregate.fees = ceiling_add(aggregate.fees, ancestor->fees());
+        aggregate.size = ceiling_add(aggregate.size, ancestor->size());
+        aggregate.sigops = ceiling_add(aggregate.sigops, ancestor->sigops());
+        aggregate.eligible &= (ancestor->forks() != sentinel_forks);
+    }
+
+    return aggregate;
+}
+
+// static, protected
+// Post order traversal, so the list is in dependency order ending in entry.
+void transaction_pool::get_ancestors(transaction_entry::ptr entry,
+    const entry_set& excluded, entry_set& visited,
+    transaction_entry::list& out_ancestors)
+{
+    if (excluded.find(entry) != excluded.end() ||
+        !visited.insert(entry).second)
+        return;
+
+    for (const auto parent: entry->parents())
+        get_ancestors(parent, excluded, visited, out_ancestors);
+
+    out_ancestors.push_back(entry);
+}
+
+// static, protected
+void transaction_pool::get_descendants(transaction_entry::ptr entry,
+    entry_set& out_descendants)
+{
+    for (const auto child: entry->children())
+        if (out_descendants.insert(child).second)
+            get_descendants(child, out_descendants);
+}
+
+// protected
+// Greedy selection of packages in ancestor fee rate order.
+merkle_block_ptr transaction_pool::create_template() const
+{
+    static const auto maximum_size = max_block_size - coinbase_reserved_size;
+    static const auto maximum_sigops = max_block_sigops -
+        coinbase_reserved_sigops;
+
+    size_t size = 0;
+    size_t sigops = 0;
+    hash_list hashes;
+    entry_set selected;
+
+    for (const auto& ranked: ranking_)
+    {
+        if (selected.find(ranked.entry) != selected.end())
+            continue;
+
+        // The package excludes ancestors that have already been selected.
+        entry_set visited;
+        transaction_entry::list package;
+        get_ancestors(ranked.entry, selected, visited, package);
+
+        size_t package_size = 0;
+        size_t package_sigops = 0;
+
+        for (const auto entry: package)
+        {
+            package_size += entry->size();
+            package_sigops += entry->sigops();
+        }
+
+        if (size + package_size > maximum_size ||
+            sigops + package_sigops > maximum_sigops)
+            continue;
+
+        size += package_size;
+        sigops += package_sigops;
+
+        for (const auto entry: package)
+        {
+            selected.insert(entry);
+            hashes.push_back(entry->hash());
+        }
+
+        if (size == maximum_size || sigops == maximum_sigops)
+            break;
+    }
+
+    // The header is not populated, the caller is responsible for mining.
+    const auto count = hashes.size();
+    return std::make_shared<message::merkle_block>(chain::header{}, count,
+        std::move(hashes), data_chunk{});
+}
+
 void transaction_pool::fetch_template(merkle_block_fetch_handler handler) const
 {
-    const size_t height = max_size_t;
-    const auto block = std::make_shared<message::merkle_block>();
+    merkle_block_ptr block;
+    size_t height;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    block = template_;
+    height = template_height_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!block)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+
+        if (!template_)
+            template_ = create_template();
+
+        block = template_;
+        height = template_height_;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
     handler(error::success, block, height);
 }
 
-// TODO: implement mempool message payload discovery.
-void transaction_pool::fetch_mempool(size_t maximum,
+// The ranking is ordered by descending package fee rate, so the response is
+// a bounded iteration that terminates at the fee floor or the count limit.
+// Each package is emitted in dependency order (ancestors first).
+void transaction_pool::fetch_mempool(size_t maximum, uint64_t minimum_fee,
     inventory_fetch_handler handler) const
 {
-    const auto empty = std::make_shared<message::inventory>();
-    handler(error::success, empty);
+    // The floor is in satoshis per kilobyte (BIP133), rates are per byte.
+    const auto floor = minimum_fee / 1000.0;
+    const auto response = std::make_shared<message::inventory>();
+    auto& inventories = response->inventories();
+    static const auto id = message::inventory_vector::type_id::transaction;
+    entry_set selected;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    for (const auto& ranked: ranking_)
+    {
+        if (inventories.size() >= maximum || ranked.rate < floor)
+            break;
+
+        if (selected.find(ranked.entry) != selected.end())
+            continue;
+
+        // The package excludes ancestors that have already been selected.
+        entry_set visited;
+        transaction_entry::list package;
+        get_ancestors(ranked.entry, selected, visited, package);
+
+        if (inventories.size() + package.size() > maximum)
+            continue;
+
+        for (const auto entry: package)
+        {
+            selected.insert(entry);
+            inventories.emplace_back(id, entry->hash());
+        }
+    }
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    handler(error::success, response);
 }
 
 } // namespace blockchain
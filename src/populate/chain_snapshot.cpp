@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/chain_snapshot.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/filesystem.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/blockchain/populate/header_cache.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace boost::filesystem;
+using namespace boost::multiprecision;
+
+// Increment if the format changes, a mismatched file is not restored.
+static constexpr uint32_t snapshot_version = 1;
+static constexpr size_t work_size = 32;
+
+chain_snapshot::chain_snapshot(const path& file)
+  : file_(file)
+{
+}
+
+// Work is serialized as 32 little-endian bytes.
+static void write_work(writer& sink, const uint256_t& work)
+{
+    data_chunk bytes(work_size, 0x00);
+    export_bits(work, bytes.begin(), 8, false);
+    sink.write_bytes(bytes);
+}
+
+static uint256_t read_work(reader& source)
+{
+    uint256_t work;
+    const auto bytes = source.read_bytes(work_size);
+    import_bits(work, bytes.begin(), bytes.end(), 8, false);
+    return work;
+}
+
+bool chain_snapshot::save(const config::checkpoint& top,
+    const work_list& work, const header_cache& headers) const
+{
+    if (file_.empty())
+        return false;
+
+    // Only a complete work index is saved, so its size is top + 1.
+    if (work.size() != top.height() + 1u)
+        return false;
+
+    bc::ofstream file(file_.string(), std::ofstream::binary);
+
+    if (!file)
+        return false;
+
+    ostream_writer sink(file);
+    sink.write_4_bytes_little_endian(snapshot_version);
+    sink.write_hash(top.hash());
+    sink.write_8_bytes_little_endian(top.height());
+
+    // The header cache is saved from its oldest to its top (contiguous).
+    size_t last;
+    const auto count = headers.top(last) ? headers.size() : 0;
+    const auto first = count == 0 ? 0 : last - count + 1u;
+    sink.write_8_bytes_little_endian(first);
+    sink.write_variable_little_endian(count);
+
+    header_cache::record record;
+
+    for (auto height = first; height < first + count; ++height)
+    {
+        if (!headers.get(record, height))
+            record = { null_hash, 0, 0, 0 };
+
+        sink.write_hash(record.hash);
+        sink.write_4_bytes_little_endian(record.bits);
+        sink.write_4_bytes_little_endian(record.version);
+        sink.write_4_bytes_little_endian(record.timestamp);
+    }
+
+    sink.write_variable_little_endian(work.size());
+
+    for (const auto& value: work)
+        write_work(sink, value);
+
+    file.flush();
+
+    if (sink && file.good())
+        return true;
+
+    file.close();
+    boost::system::error_code ec;
+    remove(file_, ec);
+    return false;
+}
+
+bool chain_snapshot::load(const config::checkpoint& top,
+    work_list& out_work, header_cache& out_headers) const
+{
+    boost::system::error_code ec;
+
+    if (file_.empty() || !exists(file_, ec))
+        return false;
+
+    work_list work;
+    header_cache::record record;
+    bc::ifstream file(file_.string(), std::ifstream::binary);
+    istream_reader source(file);
+
+    // The snapshot is valid only for the top at which it was written.
+    auto valid = static_cast<bool>(file) &&
+        source.read_4_bytes_little_endian() == snapshot_version &&
+        source.read_hash() == top.hash() &&
+        source.read_8_bytes_little_endian() == top.height();
+
+    if (valid)
+    {
+        const auto first = source.read_8_bytes_little_endian();
+        const auto count = source.read_variable_little_endian();
+        valid = count == 0 || first + count == top.height() + 1u;
+
+        // Validate the records before modifying the cache.
+        std::vector<header_cache::record> records;
+        records.reserve(valid ? count : 0);
+
+        for (size_t index = 0; valid && index < count; ++index)
+        {
+            record.hash = source.read_hash();
+            record.bits = source.read_4_bytes_little_endian();
+            record.version = source.read_4_bytes_little_endian();
+            record.timestamp = source.read_4_bytes_little_endian();
+            records.push_back(record);
+            valid = static_cast<bool>(source);
+        }
+
+        const auto size = valid ? source.read_variable_little_endian() : 0;
+        valid = valid && size == top.height() + 1u;
+        work.reserve(valid ? size : 0);
+
+        for (size_t height = 0; valid && height < size; ++height)
+        {
+            work.push_back(read_work(source));
+            valid = static_cast<bool>(source);
+        }
+
+        if (valid)
+        {
+            out_headers.clear();
+
+            for (size_t index = 0; index < records.size(); ++index)
+                out_headers.push(records[index], first + index);
+
+            out_work.swap(work);
+        }
+    }
+
+    // Remove the snapshot so that a subsequent write cannot make it stale.
+    file.close();
+    remove(file_, ec);
+    return valid;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
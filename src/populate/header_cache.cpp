@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/header_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+header_cache::header_cache(size_t capacity)
+  : capacity_(capacity),
+    ring_(capacity),
+    top_(0),
+    count_(0)
+{
+}
+
+size_t header_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_cache::push(const chain::header& header, size_t height)
+{
+    push(record
+    {
+        header.hash(), header.bits(), header.version(), header.timestamp()
+    }, height);
+}
+
+void header_cache::push(const record& value, size_t height)
+{
+    if (capacity_ == 0)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Heights must be contiguous, a gap invalidates the cached heights.
+    if (count_ != 0 && height != top_ + 1u)
+        count_ = 0;
+
+    ring_[height % capacity_] = value;
+
+    top_ = height;
+    count_ = std::min(count_ + 1u, capacity_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_cache::pop_above(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (count_ == 0 || height >= top_)
+        return;
+
+    // The oldest cached height is top_ - count_ + 1.
+    count_ = top_ - height < count_ ? count_ - (top_ - height) : 0;
+    top_ = height;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_cache::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    count_ = 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_cache::get(record& out_record, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (count_ == 0 || height > top_ || top_ - height >= count_)
+        return false;
+
+    out_record = ring_[height % capacity_];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_cache::top(size_t& out_height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (count_ == 0)
+        return false;
+
+    out_height = top_;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/header_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+static const auto header_size = chain::header::satoshi_fixed_size();
+
+header_index::header_index(size_t capacity)
+  : capacity_(capacity),
+    headers_(capacity * header_size),
+    hashes_(capacity),
+    top_(0),
+    count_(0)
+{
+    heights_.reserve(capacity);
+}
+
+size_t header_index::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::push(const chain::header& header, size_t height)
+{
+    if (capacity_ == 0)
+        return;
+
+    const auto hash = header.hash();
+    const auto data = header.to_data();
+    const auto slot = height % capacity_;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Heights must be contiguous, a gap invalidates the indexed heights.
+    if (count_ != 0 && height != top_ + 1u)
+    {
+        heights_.clear();
+        count_ = 0;
+    }
+
+    // The slot of the oldest height is overwritten once the ring is full.
+    if (count_ == capacity_)
+        heights_.erase(hashes_[slot]);
+
+    std::copy(data.begin(), data.end(), headers_.begin() + slot * header_size);
+    hashes_[slot] = hash;
+    heights_[hash] = height;
+
+    top_ = height;
+    count_ = std::min(count_ + 1u, capacity_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::pop_above(size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (; count_ != 0 && top_ > height; --top_, --count_)
+        heights_.erase(hashes_[top_ % capacity_]);
+
+    top_ = std::min(top_, height);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    heights_.clear();
+    count_ = 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::find(size_t& out_height, const hash_digest& hash) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto it = heights_.find(hash);
+
+    if (it == heights_.end())
+        return false;
+
+    out_height = it->second;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Headers are parsed in place from the ring, so there is one copy per header.
+size_t header_index::get(message::header::list& out_headers, size_t from,
+    size_t count) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto available_count = available(from, count);
+    out_headers.reserve(out_headers.size() + available_count);
+
+    for (auto height = from; height < from + available_count; ++height)
+    {
+        const auto begin = headers_.begin() + (height % capacity_) *
+            header_size;
+
+        auto source = make_safe_deserializer(begin, begin + header_size);
+        chain::header header;
+        header.from_data(source);
+        out_headers.emplace_back(std::move(header));
+    }
+
+    return available_count;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t header_index::get(hash_list& out_hashes, size_t from,
+    size_t count) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    const auto available_count = available(from, count);
+    out_hashes.reserve(out_hashes.size() + available_count);
+
+    for (auto height = from; height < from + available_count; ++height)
+        out_hashes.push_back(hashes_[height % capacity_]);
+
+    return available_count;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// protected
+// The number of indexed heights from the height, up to count (locked).
+size_t header_index::available(size_t from, size_t count) const
+{
+    if (count_ == 0 || from > top_ || top_ - from >= count_)
+        return 0;
+
+    return std::min(count, top_ - from + 1u);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+// Each thread claims about this many chunks, allowing for rebalancing.
+static constexpr size_t chunks_per_thread = 16;
+
+// Bound the chunk so that a costly run of inputs cannot be claimed at once.
+static constexpr size_t maximum_chunk = 64;
+
+input_scheduler::input_scheduler(block_const_ptr block, size_t threads)
+  : size_(0), chunk_(1), cursor_(0), cancelled_(false)
+{
+    const auto& txs = block->transactions();
+    offsets_.reserve(txs.size());
+
+    // Must skip coinbase here as it is already accounted for.
+    for (auto tx = txs.begin() + 1; tx < txs.end(); ++tx)
+    {
+        offsets_.push_back(size_);
+        size_ += tx->inputs().size();
+    }
+
+    const auto chunks = std::max(threads, size_t(1)) * chunks_per_thread;
+    chunk_ = std::max(size_t(1), std::min(maximum_chunk, size_ / chunks));
+}
+
+size_t input_scheduler::size() const
+{
+    return size_;
+}
+
+bool input_scheduler::next(size_t& out_begin, size_t& out_end)
+{
+    if (cancelled())
+        return false;
+
+    // Relaxed is sufficient, the claim is the only shared state.
+    out_begin = cursor_.fetch_add(chunk_, std::memory_order_relaxed);
+
+    if (out_begin >= size_)
+        return false;
+
+    out_end = std::min(out_begin + chunk_, size_);
+    return true;
+}
+
+void input_scheduler::locate(size_t& out_tx, size_t& out_input,
+    size_t position) const
+{
+    BITCOIN_ASSERT(position < size_);
+
+    // The last tx with an offset at or below the position (txs may be empty).
+    const auto it = std::upper_bound(offsets_.begin(), offsets_.end(),
+        position) - 1;
+
+    // Offset by one for the coinbase.
+    out_tx = std::distance(offsets_.begin(), it) + 1u;
+    out_input = position - *it;
+}
+
+void input_scheduler::cancel()
+{
+    cancelled_.store(true, std::memory_order_relaxed);
+}
+
+// Relaxed is sufficient, a late observer only completes its current input.
+bool input_scheduler::cancelled() const
+{
+    return cancelled_.load(std::memory_order_relaxed);
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
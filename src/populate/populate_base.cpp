@@ -67,11 +67,45 @@ void populate_base::populate_pooled(const chain::transaction& tx,
     tx.validation.current = false;
 }
 
-// Unspent outputs are cached by the store. If the cache is large enough this
-// may never hit the file system. However on high RAM systems the file system
-// is faster than the cache due to reduced paging of the memory-mapped file.
+// Recent unspent outputs are cached by the chain (see utxo_cache), others are
+// read from the memory-mapped store, which may be paged by the file system.
 void populate_base::populate_prevout(size_t branch_height,
     const output_point& outpoint, bool require_confirmed) const
+{
+    reset_prevout(outpoint);
+
+    // If the input is a coinbase there is no prevout to populate.
+    if (outpoint.is_null())
+        return;
+
+    fast_chain::output_query query{ &outpoint };
+
+    // Get the script, value and spender height (if any) for the prevout.
+    query.found = fast_chain_.get_output(query.output, query.height,
+        query.coinbase, outpoint, branch_height, require_confirmed);
+
+    apply_prevout(branch_height, query);
+}
+
+// Queries are resolved together, so a remote store is read once per batch.
+// The inputs of a block are not coinbase, so a null outpoint is not expected.
+void populate_base::populate_prevouts(size_t branch_height,
+    fast_chain::output_queries& queries, bool require_confirmed) const
+{
+    if (queries.empty())
+        return;
+
+    for (const auto& query: queries)
+        reset_prevout(*query.outpoint);
+
+    fast_chain_.get_outputs(queries, branch_height, require_confirmed);
+
+    for (const auto& query: queries)
+        apply_prevout(branch_height, query);
+}
+
+// static
+void populate_base::reset_prevout(const output_point& outpoint)
 {
     // The previous output will be cached on the input's outpoint.
     auto& prevout = outpoint.validation;
@@ -80,19 +114,20 @@ void populate_base::populate_prevout(size_t branch_height,
     prevout.confirmed = false;
     prevout.cache = chain::output{};
     prevout.height = output_point::validation_type::not_specified;
+}
 
-    // If the input is a coinbase there is no prevout to populate.
-    if (outpoint.is_null())
+// static
+void populate_base::apply_prevout(size_t branch_height,
+    const fast_chain::output_query& query)
+{
+    // The output (prevout.cache) is populated only if the query is found.
+    if (!query.found)
         return;
 
-    size_t output_height;
-    bool output_coinbase;
-
-    // Get the script, value and spender height (if any) for the prevout.
-    // The output (prevout.cache) is populated only if the return is true.
-    if (!fast_chain_.get_output(prevout.cache, output_height, output_coinbase,
-        outpoint, branch_height, require_confirmed))
-        return;
+    auto& prevout = query.outpoint->validation;
+    const auto output_height = query.height;
+    const auto output_coinbase = query.coinbase;
+    prevout.cache = query.output;
 
     //*************************************************************************
     // CONSENSUS: The genesis block coinbase may not be spent. This is the
@@ -106,8 +141,8 @@ void populate_base::populate_prevout(size_t branch_height,
     if (output_coinbase)
         prevout.height = output_height;
 
-    // BUGBUG: Spends are not marked as spent by unconfirmed transactions.
-    // So tx pool transactions currently have no double spend limitation.
+    // Spends are not marked as spent by unconfirmed transactions here, the
+    // transaction validator marks those from the transaction pool index.
     // The output is spent only if by a spend at or below the branch height.
     const auto spend_height = prevout.cache.validation.spender_height;
 
@@ -24,6 +24,8 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -34,14 +36,32 @@ using namespace bc::machine;
 #define NAME "populate_block"
 
 // Database access is limited to calling populate_base.
+// Pool membership is determined from the in-memory transaction pool index.
 
 populate_block::populate_block(dispatcher& dispatch, const fast_chain& chain,
-    bool relay_transactions)
+    const transaction_pool& pool)
   : populate_base(dispatch, chain),
-    relay_transactions_(relay_transactions)
+    stopped_(true),
+    transaction_pool_(pool)
 {
 }
 
+// Start/stop sequences.
+//-----------------------------------------------------------------------------
+
+void populate_block::start()
+{
+    stopped_ = false;
+}
+
+void populate_block::stop()
+{
+    stopped_ = true;
+}
+
+// Populate.
+//-----------------------------------------------------------------------------
+
 void populate_block::populate(branch::const_ptr branch,
     result_handler&& handler) const
 {
@@ -75,9 +95,13 @@ void populate_block::populate(branch::const_ptr branch,
     const auto join_handler = synchronize(std::move(handler), buckets, NAME);
     BITCOIN_ASSERT(threads != 0);
 
+    // Inputs are claimed in chunks, so threads need not share evenly.
+    // The join is invoked on the first error, other buckets are cancelled.
+    const auto scheduler = std::make_shared<input_scheduler>(block, buckets);
+
     for (size_t bucket = 0; bucket < buckets; ++bucket)
         dispatch_.concurrent(&populate_block::populate_transactions,
-            this, branch, bucket, buckets, join_handler);
+            this, branch, bucket, buckets, scheduler, join_handler);
 }
 
 // Initialize the coinbase input for subsequent validation.
@@ -127,13 +151,13 @@ void populate_block::populate_coinbase(branch::const_ptr branch,
 ////}
 
 void populate_block::populate_transactions(branch::const_ptr branch,
-    size_t bucket, size_t buckets, result_handler handler) const
+    size_t bucket, size_t buckets, input_scheduler::ptr scheduler,
+    result_handler handler) const
 {
     BITCOIN_ASSERT(bucket < buckets);
     const auto block = branch->top();
     const auto branch_height = branch->height();
     const auto& txs = block->transactions();
-    size_t input_position = 0;
 
     const auto state = block->validation.state;
     const auto forks = state->enabled_forks();
@@ -145,18 +169,18 @@ void populate_block::populate_transactions(branch::const_ptr branch,
     for (auto position = first; position < txs.size();
         position = ceiling_add(position, buckets))
     {
+        if (stopped() || scheduler->cancelled())
+        {
+            scheduler->cancel();
+            handler(error::service_stopped);
+            return;
+        }
+
         const auto& tx = txs[position];
 
-        //---------------------------------------------------------------------
         // This prevents output validation and full tx deposit respectively.
-        // The tradeoff is a read per tx that may not be cached. This is
-        // bypassed by checkpoints. This will be optimized using the tx pool.
-        // Until that time this is a material population performance hit.
-        // However the hit is necessary in preventing store tx duplication
-        // unless tx relay is disabled. In that case duplication is unlikely.
-        //---------------------------------------------------------------------
-        if (relay_transactions_)
-            populate_base::populate_pooled(tx, forks);
+        // The pool index avoids a store read per tx, so this is always run.
+        populate_pooled(tx, forks);
 
         //*********************************************************************
         // CONSENSUS: Satoshi implemented allow collisions in Nov 2015. This is
@@ -169,25 +193,58 @@ void populate_block::populate_transactions(branch::const_ptr branch,
         }
     }
 
-    // Must skip coinbase here as it is already accounted for.
-    for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
-    {
-        const auto& inputs = tx->inputs();
+    size_t begin;
+    size_t end;
+    fast_chain::output_queries queries;
 
-        for (size_t input_index = 0; input_index < inputs.size();
-            ++input_index, ++input_position)
+    // The scheduler excludes the coinbase as it is already accounted for.
+    while (scheduler->next(begin, end))
+    {
+        if (stopped())
         {
-            if (input_position % buckets != bucket)
-                continue;
+            scheduler->cancel();
+            handler(error::service_stopped);
+            return;
+        }
+
+        size_t tx;
+        size_t input_index;
+        scheduler->locate(tx, input_index, begin);
+        queries.clear();
+        queries.reserve(end - begin);
 
-            const auto& input = inputs[input_index];
-            const auto& prevout = input.previous_output();
-            populate_base::populate_prevout(branch_height, prevout, true);
-            populate_prevout(branch, prevout);
+        for (auto position = begin; position < end; ++position, ++input_index)
+        {
+            while (input_index == txs[tx].inputs().size())
+            {
+                ++tx;
+                input_index = 0;
+            }
+
+            const auto& input = txs[tx].inputs()[input_index];
+            queries.push_back({ &input.previous_output() });
         }
+
+        // The prevouts of the chunk are read from the store as one batch.
+        populate_base::populate_prevouts(branch_height, queries, true);
+
+        // The branch overrides the store, so it is applied after the batch.
+        for (const auto& query: queries)
+            populate_prevout(branch, *query.outpoint);
     }
 
-    handler(error::success);
+    // A cancelled scheduler claims no more, so the block is incomplete.
+    handler(scheduler->cancelled() ? error::service_stopped :
+        error::success);
+}
+
+// The pool indexes all stored unconfirmed txs, so a miss is not pooled.
+void populate_block::populate_pooled(const chain::transaction& tx,
+    uint32_t forks) const
+{
+    const auto entry = transaction_pool_.find(tx.hash());
+    tx.validation.pooled = static_cast<bool>(entry);
+    tx.validation.current = entry && entry->forks() == forks;
 }
 
 void populate_block::populate_prevout(branch::const_ptr branch,
@@ -35,6 +35,10 @@ using namespace std::placeholders;
 
 #define NAME "populate_transaction"
 
+// Txs of fewer inputs per thread are populated inline, as dispatch and join
+// would dominate the reads.
+static constexpr size_t minimum_bucket_inputs = 16;
+
 // Database access is limited to calling populate_base.
 
 populate_transaction::populate_transaction(dispatcher& dispatch,
@@ -81,10 +85,19 @@ void populate_transaction::populate(transaction_const_ptr tx,
     }
 
     const auto threads = dispatch_.size();
-    const auto buckets = std::min(threads, total_inputs);
-    const auto join_handler = synchronize(std::move(handler), buckets, NAME);
+    const auto buckets = std::min(threads,
+        total_inputs / minimum_bucket_inputs);
     BITCOIN_ASSERT(threads != 0);
 
+    // Small txs, most of the pool traffic, are populated on this thread.
+    if (buckets < 2)
+    {
+        populate_inputs(tx, chain_height, 0, 1, std::move(handler));
+        return;
+    }
+
+    const auto join_handler = synchronize(std::move(handler), buckets, NAME);
+
     for (size_t bucket = 0; bucket < buckets; ++bucket)
         dispatch_.concurrent(&populate_transaction::populate_inputs,
             this, tx, chain_height, bucket, buckets, join_handler);
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/unspent_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+
+// Ten bits and seven probes per hash give a one percent false hit rate. A
+// false hit costs only the store read that the filter otherwise avoids.
+static constexpr size_t bits_per_hash = 10;
+static constexpr size_t probes = 7;
+static constexpr size_t word_bits = 64;
+
+unspent_filter::unspent_filter(size_t limit)
+  : limit_(limit),
+    size_(std::max(uint64_t(limit) * bits_per_hash, uint64_t(word_bits))),
+    salt_(pseudo_random()),
+    count_(0),
+    active_(false),
+    bits_(limit == 0 ? 0 : size_ / word_bits + 1u, 0)
+{
+}
+
+size_t unspent_filter::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool unspent_filter::authoritative() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return active_ && count_ <= limit_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool unspent_filter::saturated() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return count_ > limit_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Probes are derived by double hashing, salted against crafted collisions.
+bool unspent_filter::contains(const hash_digest& hash) const
+{
+    const auto first = from_little_endian_unsafe<uint64_t>(hash.begin()) ^
+        salt_;
+    const auto step = from_little_endian_unsafe<uint64_t>(hash.begin() +
+        sizeof(uint64_t)) | 1u;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    // The false hit rate is unbounded beyond the limit.
+    if (!active_ || count_ > limit_)
+        return true;
+
+    for (size_t probe = 0; probe < probes; ++probe)
+    {
+        const auto bit = (first + probe * step) % size_;
+        const auto mask = uint64_t(1) << (bit % word_bits);
+
+        if ((bits_[bit / word_bits] & mask) == 0)
+            return false;
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_filter::add(const hash_digest& hash)
+{
+    if (limit_ == 0)
+        return;
+
+    const auto first = from_little_endian_unsafe<uint64_t>(hash.begin()) ^
+        salt_;
+    const auto step = from_little_endian_unsafe<uint64_t>(hash.begin() +
+        sizeof(uint64_t)) | 1u;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (size_t probe = 0; probe < probes; ++probe)
+    {
+        const auto bit = (first + probe * step) % size_;
+        bits_[bit / word_bits] |= uint64_t(1) << (bit % word_bits);
+    }
+
+    ++count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_filter::add(const block& block)
+{
+    for (const auto& tx: block.transactions())
+        add(tx.hash());
+}
+
+void unspent_filter::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    std::fill(bits_.begin(), bits_.end(), 0);
+    count_ = 0;
+    active_ = false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void unspent_filter::activate()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    active_ = limit_ != 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
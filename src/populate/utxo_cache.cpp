@@ -0,0 +1,223 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/populate/utxo_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::chain;
+
+// Outpoints are distributed over independently locked shards.
+static constexpr size_t shard_count = 16;
+
+utxo_cache::utxo_cache(size_t limit)
+  : shard_limit_(limit == 0 ? 0 : (limit + shard_count - 1u) / shard_count),
+    shards_(shard_count)
+{
+}
+
+size_t utxo_cache::size() const
+{
+    size_t total = 0;
+
+    for (auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.entries.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+bool utxo_cache::get(output& out_output, size_t& out_height,
+    bool& out_coinbase, const output_point& outpoint,
+    size_t branch_height) const
+{
+    if (shard_limit_ == 0)
+        return false;
+
+    auto& shard = to_shard(outpoint);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(outpoint);
+
+    // An output above the branch height does not exist for the branch.
+    if (it == shard.entries.end() || it->second.first.height > branch_height)
+        return false;
+
+    const auto& cached = it->second.first;
+    out_output = cached.output;
+    out_output.validation.spender_height = output::validation::not_spent;
+    out_height = cached.height;
+    out_coinbase = cached.coinbase;
+
+    // Promote the hit so that it survives eviction.
+    shard.recent.splice(shard.recent.begin(), shard.recent, it->second.second);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Prevouts are discarded before the outputs of a tx are added, so outputs
+// spent within the block are not left in the cache.
+void utxo_cache::add(const block& block, size_t height)
+{
+    if (shard_limit_ == 0)
+        return;
+
+    const auto& txs = block.transactions();
+
+    for (size_t position = 0; position < txs.size(); ++position)
+    {
+        const auto& tx = txs[position];
+        const auto coinbase = position == 0;
+        const auto hash = tx.hash();
+        const auto& outputs = tx.outputs();
+
+        // The null prevout of a coinbase is never cached.
+        for (const auto& input: tx.inputs())
+            remove(input.previous_output());
+
+        for (uint32_t index = 0; index < outputs.size(); ++index)
+        {
+            const point outpoint{ hash, index };
+            auto& shard = to_shard(outpoint);
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            // A duplicate tx hash replaces the outputs of the lower (BIP30).
+            const auto it = shard.entries.find(outpoint);
+            if (it != shard.entries.end())
+            {
+                shard.recent.erase(it->second.second);
+                shard.entries.erase(it);
+            }
+
+            shard.recent.push_front(outpoint);
+            shard.entries.emplace(outpoint, entry
+            {
+                value{ outputs[index], height, coinbase },
+                shard.recent.begin()
+            });
+
+            shard.top = std::max(shard.top, height);
+
+            // Evict the least recently created or used outputs.
+            while (shard.recent.size() > shard_limit_)
+            {
+                shard.entries.erase(shard.recent.back());
+                shard.recent.pop_back();
+            }
+            ///////////////////////////////////////////////////////////////////
+        }
+    }
+}
+
+void utxo_cache::remove_spent(const block& block)
+{
+    if (shard_limit_ == 0)
+        return;
+
+    for (const auto& tx: block.transactions())
+        for (const auto& input: tx.inputs())
+            remove(input.previous_output());
+}
+
+void utxo_cache::pop_above(size_t height)
+{
+    for (auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // Typically the fork point is the top, so there is nothing to scan.
+        if (shard.top <= height)
+            continue;
+
+        for (auto it = shard.entries.begin(); it != shard.entries.end();)
+        {
+            if (it->second.first.height > height)
+            {
+                shard.recent.erase(it->second.second);
+                it = shard.entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        shard.top = height;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+void utxo_cache::clear()
+{
+    for (auto& shard: shards_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.recent.clear();
+        shard.top = 0;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+// protected
+utxo_cache::shard& utxo_cache::to_shard(const point& point) const
+{
+    return shards_[std::hash<chain::point>()(point) % shards_.size()];
+}
+
+// protected
+void utxo_cache::remove(const point& point)
+{
+    auto& shard = to_shard(point);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto it = shard.entries.find(point);
+
+    if (it == shard.entries.end())
+        return;
+
+    shard.recent.erase(it->second.second);
+    shard.entries.erase(it);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -25,11 +25,37 @@ namespace blockchain {
 
 settings::settings()
   : cores(0),
+    script_cores(0),
+    store_cores(0),
+    populate_cpus(),
+    script_cpus(),
+    store_cpus(),
     priority(true),
     use_libconsensus(false),
     reject_conflicts(true),
     minimum_byte_fee_satoshis(1),
     reorganization_limit(256),
+    script_cache_limit(100000),
+    pipeline_blocks(false),
+    seen_transaction_limit(100000),
+    rejected_transaction_limit(50000),
+    orphan_transaction_limit(1000),
+    orphan_transaction_bytes(5000000),
+    orphan_block_limit(50),
+    orphan_block_bytes(16000000),
+    concurrent_transactions(false),
+    header_index_limit(50000),
+    relay_cache_limit(16),
+    stealth_index_depth(1000),
+    utxo_cache_limit(100000),
+    unspent_filter_limit(20000000),
+    memory_budget_megabytes(0),
+    store_access("normal"),
+    prefault_megabytes(0),
+    snapshot_file(),
+    read_only(false),
+    publication_file(),
+    notification_limit(1000),
     block_version(4),
     easy_blocks(false),
     bip16(true),
@@ -37,6 +63,7 @@ settings::settings()
     bip34(true),
     bip66(true),
     bip65(true),
+    allow_collisions(false),
     bip90(true)
 {
 }
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/validate/script_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+bool script_cache::key::operator==(const key& other) const
+{
+    return index == other.index && forks == other.forks &&
+        hash == other.hash;
+}
+
+size_t script_cache::key_hash::operator()(const key& value) const
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, value.hash);
+    boost::hash_combine(seed, value.index);
+    boost::hash_combine(seed, value.forks);
+    return seed;
+}
+
+script_cache::script_cache(size_t limit)
+  : limit_(limit)
+{
+}
+
+size_t script_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return keys_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void script_cache::add(const hash_digest& tx_hash, uint32_t input_index,
+    uint32_t forks)
+{
+    if (limit_ == 0)
+        return;
+
+    const key value{ tx_hash, input_index, forks };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!keys_.insert(value).second)
+        return;
+
+    order_.push_back(value);
+
+    // Evict the oldest verifications once the limit is exceeded.
+    while (order_.size() > limit_)
+    {
+        keys_.erase(order_.front());
+        order_.pop_front();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool script_cache::exists(const hash_digest& tx_hash, uint32_t input_index,
+    uint32_t forks) const
+{
+    if (limit_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return keys_.find({ tx_hash, input_index, forks }) != keys_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
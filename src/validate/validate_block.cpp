@@ -22,11 +22,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/populate/input_scheduler.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_input.hpp>
 
 namespace libbitcoin {
@@ -38,6 +42,9 @@ using namespace std::placeholders;
 
 #define NAME "validate_block"
 
+// Blocks of fewer txs are checked inline, as dispatch would dominate.
+static constexpr size_t minimum_bucket_transactions = 64;
+
 // Database access is limited to: populator:
 // spend: { spender }
 // block: { bits, version, timestamp }
@@ -46,13 +53,19 @@ using namespace std::placeholders;
 // If the priority threadpool is shut down when this is running the handlers
 // will never be invoked, resulting in a threadpool.join indefinite hang.
 
-validate_block::validate_block(dispatcher& dispatch, const fast_chain& chain,
-    const settings& settings, bool relay_transactions)
+validate_block::validate_block(dispatcher& priority_dispatch,
+    dispatcher& script_dispatch, const fast_chain& chain,
+    const settings& settings, const transaction_pool& pool,
+    script_cache& cache, const orphan_block_pool& orphans)
   : stopped_(true),
     use_libconsensus_(settings.use_libconsensus),
+    assume_valid_(settings.assume_valid),
     fast_chain_(chain),
-    priority_dispatch_(dispatch),
-    block_populator_(dispatch, chain, relay_transactions)
+    priority_dispatch_(priority_dispatch),
+    script_dispatch_(script_dispatch),
+    script_cache_(cache),
+    orphans_(orphans),
+    block_populator_(priority_dispatch, chain, pool)
 {
 }
 
@@ -62,10 +75,12 @@ validate_block::validate_block(dispatcher& dispatch, const fast_chain& chain,
 void validate_block::start()
 {
     stopped_ = false;
+    block_populator_.start();
 }
 
 void validate_block::stop()
 {
+    block_populator_.stop();
     stopped_ = true;
 }
 
@@ -75,10 +90,111 @@ void validate_block::stop()
 
 code validate_block::check(block_const_ptr block) const
 {
+    // An invalid header (e.g. proof of work) is rejected before any tx work.
+    auto ec = block->header().check();
+
+    if (ec)
+        return ec;
+
+    // The block limits are summed from the txs without hashing, so an empty
+    // or oversized block is rejected before the tx fan-out. The size limit
+    // also bounds the tx count. These are repeated by the block check.
+    if (block->transactions().empty())
+        return error::empty_block;
+
+    if (block->serialized_size() > max_block_size)
+        return error::block_size_limit;
+
+    // Invalid txs are rejected by the first failing bucket.
+    ec = check_transactions(block);
+
+    if (ec)
+        return ec;
+
     // Run context free checks, sets time internally.
     return block->check();
 }
 
+// Only the branch leading to the configured assumed valid block is trusted,
+// so the assumed block must be the block itself or a buffered descendant of
+// it at the height difference. This is required while the store top is below
+// the assumed height (initial sync). Trusted blocks are checked (structure)
+// and their headers are accepted, but there is no prevout or duplicate
+// population, tx accept, sigop count or script verification. All other
+// blocks, including any once the top reaches the height, are fully validated.
+// Accept and connect agree: the top cannot reach the height between them, as
+// only blocks below it may be pending, and the buffered descendants of the
+// block are evicted only by an add, which is within the organizer critical
+// section, and are removed only once the block itself is organized.
+// Without headers-first sync the chain to the assumed block is not known
+// ahead of its blocks, so in order sync does not skip (orphans only).
+bool validate_block::is_assumed_valid(block_const_ptr block) const
+{
+    const auto height = block->validation.state->height();
+
+    if (assume_valid_.hash() == null_hash || height > assume_valid_.height())
+        return false;
+
+    size_t top;
+    if (!fast_chain_.get_last_height(top) || top >= assume_valid_.height())
+        return false;
+
+    return orphans_.is_ancestor(block->hash(), assume_valid_.hash(),
+        assume_valid_.height() - height);
+}
+
+// The context free tx checks and tx hashing of the block are bucketed across
+// the priority pool. Tx hashes are cached on the txs, so the merkle root of
+// the block check and all later hash() calls (pools, organizers) reuse them.
+code validate_block::check_transactions(block_const_ptr block) const
+{
+    const auto count = block->transactions().size();
+    const auto threads = std::min(priority_dispatch_.size(), count);
+
+    if (stopped() || threads < 2 || count < minimum_bucket_transactions)
+        return error::success;
+
+    std::promise<code> promise;
+    result_handler complete = [&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    };
+
+    // The join is invoked on the first error, other buckets are cancelled.
+    const auto failures = std::make_shared<atomic_counter>(0);
+    const auto join_handler = synchronize(std::move(complete), threads,
+        NAME "_check");
+
+    for (size_t bucket = 0; bucket < threads; ++bucket)
+        priority_dispatch_.concurrent(&validate_block::check_bucket,
+            this, block, bucket, failures, join_handler);
+
+    // The check runs on the caller thread, so wait for the buckets.
+    return promise.get_future().get();
+}
+
+void validate_block::check_bucket(block_const_ptr block, size_t bucket,
+    atomic_counter_ptr failures, result_handler handler) const
+{
+    code ec(error::success);
+    const auto buckets = priority_dispatch_.size();
+    const auto& txs = block->transactions();
+    const auto count = txs.size();
+
+    for (auto tx = bucket; tx < count && !ec && *failures == 0;
+        tx = ceiling_add(tx, buckets))
+    {
+        const auto& transaction = txs[tx];
+        transaction.hash();
+        ec = transaction.check(false);
+    }
+
+    if (ec)
+        ++(*failures);
+
+    handler(ec);
+}
+
 // Accept sequence.
 //-----------------------------------------------------------------------------
 // These checks require chain state, and block state if not under checkpoint.
@@ -101,6 +217,14 @@ void validate_block::accept(branch::const_ptr branch,
         return;
     }
 
+    // Txs of an assumed valid block are neither populated nor accepted.
+    if (is_assumed_valid(block))
+    {
+        block->validation.start_accept = asio::steady_clock::now();
+        handler(block->header().accept(*block->validation.state));
+        return;
+    }
+
     // Populate block state for the top block (others are valid).
     block_populator_.populate(branch,
         std::bind(&validate_block::handle_populated,
@@ -151,13 +275,17 @@ void validate_block::handle_populated(const code& ec, block_const_ptr block,
     const auto join_handler = synchronize(std::move(complete_handler), threads,
         NAME "_accept");
 
+    // The join is invoked on the first error, other buckets are cancelled.
+    const auto failures = std::make_shared<atomic_counter>(0);
+
     for (size_t bucket = 0; bucket < threads; ++bucket)
         priority_dispatch_.concurrent(&validate_block::accept_transactions,
-            this, block, bucket, sigops, bip16, join_handler);
+            this, block, bucket, sigops, failures, bip16, join_handler);
 }
 
 void validate_block::accept_transactions(block_const_ptr block, size_t bucket,
-    atomic_counter_ptr sigops, bool bip16, result_handler handler) const
+    atomic_counter_ptr sigops, atomic_counter_ptr failures, bool bip16,
+    result_handler handler) const
 {
     if (stopped())
     {
@@ -172,13 +300,17 @@ void validate_block::accept_transactions(block_const_ptr block, size_t bucket,
     const auto count = txs.size();
 
     // Run contextual tx non-script checks (not in tx order).
-    for (auto tx = bucket; tx < count && !ec; tx = ceiling_add(tx, buckets))
+    for (auto tx = bucket; tx < count && !ec && *failures == 0;
+        tx = ceiling_add(tx, buckets))
     {
         const auto& transaction = txs[tx];
         ec = transaction.accept(state, false);
         *sigops += transaction.signature_operations(bip16);
     }
 
+    if (ec)
+        ++(*failures);
+
     handler(ec);
 }
 
@@ -208,7 +340,8 @@ void validate_block::connect(branch::const_ptr branch,
     // We are reimplementing connect, so must set timer externally.
     block->validation.start_connect = asio::steady_clock::now();
 
-    if (block->validation.state->is_under_checkpoint())
+    if (block->validation.state->is_under_checkpoint() ||
+        is_assumed_valid(block))
     {
         handler(error::success);
         return;
@@ -223,103 +356,170 @@ void validate_block::connect(branch::const_ptr branch,
         return;
     }
 
-    // Reset statistics for each block (treat coinbase as cached).
-    hits_ = 0;
-    queries_ = 0;
+    // Statistics are per block, as blocks may be validated concurrently.
+    const auto stats = std::make_shared<statistics>();
+    stats->hits = 0;
+    stats->queries = 0;
+
+    // Inputs of pooled txs validated under current forks are all hits.
+    for (const auto& tx: block->transactions())
+    {
+        if (tx.validation.current)
+        {
+            stats->hits += tx.inputs().size();
+            stats->queries += tx.inputs().size();
+        }
+    }
 
     result_handler complete_handler =
         std::bind(&validate_block::handle_connected,
-            this, _1, block, handler);
+            this, _1, block, stats, handler);
 
-    const auto threads = priority_dispatch_.size();
+    const auto threads = script_dispatch_.size();
     const auto buckets = std::min(threads, non_coinbase_inputs);
     const auto join_handler = synchronize(std::move(complete_handler), buckets,
         NAME "_validate");
 
+    // Each tx is serialized once for libconsensus and shared across buckets.
+    const auto serialized = use_libconsensus_ ?
+        std::make_shared<serialization>(block->transactions().size()) :
+        nullptr;
+
+    // Inputs are claimed in chunks, so threads need not share evenly.
+    // The first failing bucket cancels the scheduler, stopping the others.
+    const auto scheduler = std::make_shared<input_scheduler>(block, buckets);
+
+    // The rules are fixed for the block, so the verifier is resolved once.
+    const auto verify = validate_input::to_verifier(
+        block->validation.state->enabled_forks(), use_libconsensus_);
+
     for (size_t bucket = 0; bucket < buckets; ++bucket)
-        priority_dispatch_.concurrent(&validate_block::connect_inputs,
-            this, block, bucket, buckets, join_handler);
+        script_dispatch_.concurrent(&validate_block::connect_inputs,
+            this, block, scheduler, serialized, verify, stats, join_handler);
 }
 
-void validate_block::connect_inputs(block_const_ptr block, size_t bucket,
-    size_t buckets, result_handler handler) const
+void validate_block::connect_inputs(block_const_ptr block,
+    input_scheduler::ptr scheduler, serialization_ptr serialized,
+    validate_input::verifier verify, statistics_ptr stats,
+    result_handler handler) const
 {
-    BITCOIN_ASSERT(bucket < buckets);
     code ec(error::success);
     const auto forks = block->validation.state->enabled_forks();
     const auto& txs = block->transactions();
-    size_t position = 0;
+    size_t begin;
+    size_t end;
 
-    // Must skip coinbase here as it is already accounted for.
-    for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
+    // The scheduler excludes the coinbase as it is already accounted for.
+    while (!ec && scheduler->next(begin, end))
     {
-        ++queries_;
-
-        // The tx is pooled with current fork state so outputs are validated.
-        if (tx->validation.current)
-        {
-            ++hits_;
-            continue;
-        }
-
+        size_t tx;
         size_t input_index;
-        const auto& inputs = tx->inputs();
+        scheduler->locate(tx, input_index, begin);
 
-        for (input_index = 0; input_index < inputs.size();
-            ++input_index, ++position)
+        for (auto position = begin; position < end; ++position, ++input_index)
         {
-            if (position % buckets != bucket)
+            while (input_index == txs[tx].inputs().size())
+            {
+                ++tx;
+                input_index = 0;
+            }
+
+            // The tx is pooled with current fork state so inputs are valid.
+            if (txs[tx].validation.current)
                 continue;
 
             if (stopped())
             {
+                scheduler->cancel();
                 handler(error::service_stopped);
                 return;
             }
 
-            const auto& prevout = inputs[input_index].previous_output();
-
-            if (!prevout.validation.cache.is_valid())
-            {
-                ec = error::missing_previous_output;
+            // Another bucket has failed and reported, abandon the range.
+            if (scheduler->cancelled())
                 break;
-            }
 
-            if ((ec = validate_input::verify_script(*tx, input_index, forks,
-                use_libconsensus_)))
+            if ((ec = connect_input(txs[tx], tx, input_index, forks,
+                serialized, verify, *stats)))
             {
+                scheduler->cancel();
+                const auto height = block->validation.state->height();
+                dump(ec, txs[tx], input_index, forks, height,
+                    use_libconsensus_);
                 break;
             }
         }
-
-        if (ec)
-        {
-            const auto height = block->validation.state->height();
-            dump(ec, *tx, input_index, forks, height, use_libconsensus_);
-            break;
-        }
     }
 
     handler(ec);
 }
 
-// The tx pool cache hit rate.
-float validate_block::hit_rate() const
+code validate_block::connect_input(const transaction& tx, size_t position,
+    uint32_t input_index, uint32_t forks, serialization_ptr serialized,
+    const validate_input::verifier& verify, statistics& stats) const
 {
-    // These values could overflow or divide by zero, but that's okay.
-    return queries_ == 0 ? 0.0f : (hits_ * 1.0f / queries_);
+    const auto& prevout = tx.inputs()[input_index].previous_output();
+
+    if (!prevout.validation.cache.is_valid())
+        return error::missing_previous_output;
+
+    ++stats.queries;
+    const auto& tx_hash = tx.hash();
+
+    // The script was verified under the same forks (tx pool or reorg).
+    if (script_cache_.exists(tx_hash, input_index, forks))
+    {
+        ++stats.hits;
+        return error::success;
+    }
+
+    static const data_chunk unserialized;
+    const auto& tx_data = serialized ? serialized->get(tx, position) :
+        unserialized;
+
+    const auto ec = verify(tx, tx_data, input_index);
+
+    if (!ec)
+        script_cache_.add(tx_hash, input_index, forks);
+
+    return ec;
+}
+
+// static
+// The input verification cache hit rate (current tx inputs are hits).
+float validate_block::hit_rate(const statistics& stats)
+{
+    const size_t queries = stats.queries;
+    return queries == 0 ? 0.0f : (stats.hits * 1.0f / queries);
 }
 
 void validate_block::handle_connected(const code& ec, block_const_ptr block,
-    result_handler handler) const
+    statistics_ptr stats, result_handler handler) const
 {
-    block->validation.cache_efficiency = hit_rate();
+    block->validation.cache_efficiency = hit_rate(*stats);
     handler(ec);
 }
 
 // Utility.
 //-----------------------------------------------------------------------------
 
+validate_block::serialization::serialization(size_t count)
+  : data(count), flags(count)
+{
+}
+
+// Thread safe, the serialization is created by the first caller only.
+const data_chunk& validate_block::serialization::get(
+    const transaction& tx, size_t position)
+{
+    std::call_once(flags[position], [&]()
+    {
+        data[position] = tx.to_data();
+    });
+
+    return data[position];
+}
+
 void validate_block::dump(const code& ec, const transaction& tx,
     uint32_t input_index, uint32_t branches, size_t height,
     bool use_libconsensus)
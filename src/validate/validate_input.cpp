@@ -31,6 +31,50 @@ namespace blockchain {
 using namespace bc::chain;
 using namespace bc::machine;
 
+// Verifier.
+//-----------------------------------------------------------------------------
+
+validate_input::verifier::verifier(kernel verify, uint32_t forks,
+    uint32_t flags)
+  : verify_(verify), forks_(forks), flags_(flags)
+{
+}
+
+code validate_input::verifier::operator()(const transaction& tx,
+    const data_chunk& tx_data, uint32_t input_index) const
+{
+    return verify_(tx, tx_data, input_index, forks_, flags_);
+}
+
+validate_input::verifier validate_input::to_verifier(uint32_t forks,
+    bool use_libconsensus)
+{
+#ifdef WITH_CONSENSUS
+    if (use_libconsensus)
+        return{ &validate_input::verify_consensus, forks,
+            convert_flags(forks) };
+#else
+    if (use_libconsensus)
+        return{ &validate_input::verify_unavailable, forks, 0 };
+#endif
+
+    return{ &validate_input::verify_native, forks, 0 };
+}
+
+// private
+code validate_input::verify_native(const transaction& tx, const data_chunk&,
+    uint32_t input_index, uint32_t forks, uint32_t)
+{
+    return script::verify(tx, input_index, forks);
+}
+
+// private
+code validate_input::verify_unavailable(const transaction&,
+    const data_chunk&, uint32_t, uint32_t, uint32_t)
+{
+    return error::operation_failed;
+}
+
 #ifdef WITH_CONSENSUS
 
 using namespace bc::consensus;
@@ -126,6 +170,16 @@ code validate_input::convert_result(verify_result_type result)
 
 code validate_input::verify_script(const transaction& tx, uint32_t input_index,
     uint32_t branches, bool use_libconsensus)
+{
+    if (!use_libconsensus)
+        return script::verify(tx, input_index, branches);
+
+    return verify_script(tx, tx.to_data(), input_index, branches, true);
+}
+
+code validate_input::verify_script(const transaction& tx,
+    const data_chunk& tx_data, uint32_t input_index, uint32_t branches,
+    bool use_libconsensus)
 {
     if (!use_libconsensus)
     {
@@ -141,17 +195,23 @@ code validate_input::verify_script(const transaction& tx, uint32_t input_index,
         return script::verify(tx, input_index, branches);
     }
 
+    return verify_consensus(tx, tx_data, input_index, branches,
+        convert_flags(branches));
+}
+
+// private
+code validate_input::verify_consensus(const transaction& tx,
+    const data_chunk& tx_data, uint32_t input_index, uint32_t,
+    uint32_t flags)
+{
     BITCOIN_ASSERT(input_index < tx.inputs().size());
     const auto& prevout = tx.inputs()[input_index].previous_output().validation;
     const auto script_data = prevout.cache.script().to_data(false);
 
-    // Wire serialization is cached in support of large numbers of inputs.
-    const auto tx_data = tx.to_data();
-
     // libconsensus
     return convert_result(consensus::verify_script(tx_data.data(),
         tx_data.size(), script_data.data(), script_data.size(), input_index,
-        convert_flags(branches)));
+        flags));
 }
 
 #else
@@ -165,6 +225,12 @@ code validate_input::verify_script(const transaction& tx,
     return script::verify(tx, input_index, branches);
 }
 
+code validate_input::verify_script(const transaction& tx, const data_chunk&,
+    uint32_t input_index, uint32_t branches, bool use_libconsensus)
+{
+    return verify_script(tx, input_index, branches, use_libconsensus);
+}
+
 #endif
 
 } // namespace blockchain
@@ -27,7 +27,9 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/branch.hpp>
+#include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_input.hpp>
 
 namespace libbitcoin {
@@ -39,17 +41,26 @@ using namespace std::placeholders;
 
 #define NAME "validate_transaction"
 
+// Txs of fewer inputs per thread are verified inline, as dispatch and join
+// would dominate the scripts (many of which are already cached).
+static constexpr size_t minimum_bucket_inputs = 4;
+
 // Database access is limited to: populator:
 // spend: { spender }
 // transaction: { exists, height, output }
+// Unconfirmed spends are obtained from the transaction pool spend index.
 
-validate_transaction::validate_transaction(dispatcher& dispatch,
-    const fast_chain& chain, const settings& settings)
+validate_transaction::validate_transaction(dispatcher& priority_dispatch,
+    dispatcher& script_dispatch, const fast_chain& chain,
+    const transaction_pool& pool, const settings& settings,
+    script_cache& cache)
   : stopped_(true),
     use_libconsensus_(settings.use_libconsensus),
-    dispatch_(dispatch),
-    transaction_populator_(dispatch, chain),
-    fast_chain_(chain)
+    fast_chain_(chain),
+    transaction_pool_(pool),
+    script_dispatch_(script_dispatch),
+    script_cache_(cache),
+    transaction_populator_(priority_dispatch, chain)
 {
 }
 
@@ -113,11 +124,37 @@ void validate_transaction::handle_populated(const code& ec,
     }
 
     BITCOIN_ASSERT(tx->validation.state);
+    populate_pool_spends(tx);
 
     // Run contextual tx checks.
     handler(tx->accept());
 }
 
+// The store marks only confirmed spends, so pooled spends are marked here.
+// This causes accept to reject the pool conflict as a double spend.
+void validate_transaction::populate_pool_spends(transaction_const_ptr tx) const
+{
+    const auto& hash = tx->hash();
+
+    for (const auto& input: tx->inputs())
+    {
+        const auto& outpoint = input.previous_output();
+        auto& prevout = outpoint.validation;
+
+        if (prevout.spent)
+            continue;
+
+        const auto spender = transaction_pool_.find_spender(outpoint);
+
+        // A resubmission of the pooled spender is not a conflict.
+        if (spender && spender->hash() != hash)
+        {
+            prevout.spent = true;
+            prevout.confirmed = false;
+        }
+    }
+}
+
 // Connect sequence.
 //-----------------------------------------------------------------------------
 // These checks require chain state, block state and perform script validation.
@@ -135,20 +172,43 @@ void validate_transaction::connect(transaction_const_ptr tx,
         return;
     }
 
-    const auto threads = dispatch_.size();
-    const auto buckets = std::min(threads, total_inputs);
-    const auto join_handler = synchronize(handler, buckets, NAME "_validate");
+    const auto threads = script_dispatch_.size();
+    const auto buckets = std::min(threads,
+        total_inputs / minimum_bucket_inputs);
     BITCOIN_ASSERT(threads != 0);
 
+    // The tx is serialized once for libconsensus and shared across buckets.
+    const auto tx_data = std::make_shared<const data_chunk>(
+        use_libconsensus_ ? tx->to_data() : data_chunk{});
+
+    // The rules are fixed for the tx, so the verifier is resolved once.
+    const auto verify = validate_input::to_verifier(
+        tx->validation.state->enabled_forks(), use_libconsensus_);
+
+    // The join is invoked on the first error, other buckets are cancelled.
+    const auto failures = std::make_shared<atomic_counter>(0);
+
+    // A tx of few inputs is verified on the calling thread, with no join.
+    if (buckets < 2)
+    {
+        connect_inputs(tx, 0, 1, tx_data, verify, failures, handler);
+        return;
+    }
+
+    const auto join_handler = synchronize(handler, buckets, NAME "_validate");
+
     // If the priority threadpool is shut down when this is called the handler
     // will never be invoked, resulting in a threadpool.join indefinite hang.
     for (size_t bucket = 0; bucket < buckets; ++bucket)
-        dispatch_.concurrent(&validate_transaction::connect_inputs,
-            this, tx, bucket, buckets, join_handler);
+        script_dispatch_.concurrent(&validate_transaction::connect_inputs,
+            this, tx, bucket, buckets, tx_data, verify, failures,
+            join_handler);
 }
 
 void validate_transaction::connect_inputs(transaction_const_ptr tx,
-    size_t bucket, size_t buckets, result_handler handler) const
+    size_t bucket, size_t buckets, data_ptr tx_data,
+    validate_input::verifier verify, atomic_counter_ptr failures,
+    result_handler handler) const
 {
     BITCOIN_ASSERT(bucket < buckets);
     code ec(error::success);
@@ -164,6 +224,10 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx,
             break;
         }
 
+        // Another bucket has failed, so the join has already been invoked.
+        if (*failures != 0)
+            break;
+
         const auto& prevout = inputs[input_index].previous_output();
 
         if (!prevout.validation.cache.is_valid())
@@ -172,13 +236,20 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx,
             break;
         }
 
-        if ((ec = validate_input::verify_script(*tx, input_index, forks,
-            use_libconsensus_)))
-        {
+        // The script was verified under the same forks (prior submission).
+        if (script_cache_.exists(tx->hash(), input_index, forks))
+            continue;
+
+        if ((ec = verify(*tx, *tx_data, input_index)))
             break;
-        }
+
+        // Fill the cache for reuse in block connection.
+        script_cache_.add(tx->hash(), input_index, forks);
     }
 
+    if (ec)
+        ++(*failures);
+
     handler(ec);
 }
 
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(arena_tests)
+
+BOOST_AUTO_TEST_CASE(arena__allocate__aligned__expected)
+{
+    arena instance(64);
+    const auto first = instance.allocate(1, 1);
+    const auto second = instance.allocate(8, 8);
+    BOOST_REQUIRE(first != nullptr);
+    BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(second) % 8u, 0u);
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 64u);
+}
+
+BOOST_AUTO_TEST_CASE(arena__allocate__over_chunk__dedicated_chunk)
+{
+    arena instance(64);
+    instance.allocate(1, 1);
+    BOOST_REQUIRE(instance.allocate(100, 4) != nullptr);
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 64u + 104u);
+}
+
+BOOST_AUTO_TEST_CASE(arena__release__allocated__none_reserved)
+{
+    arena instance(64);
+    instance.allocate(10, 1);
+    instance.release();
+    BOOST_REQUIRE_EQUAL(instance.reserved(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(arena_allocator__unordered_map__expected)
+{
+    typedef std::pair<const uint32_t, uint32_t> pair;
+    typedef std::unordered_map<uint32_t, uint32_t, std::hash<uint32_t>,
+        std::equal_to<uint32_t>, arena_allocator<pair>> map;
+
+    arena instance;
+    map values(0, map::hasher(), map::key_equal(),
+        map::allocator_type(instance));
+
+    for (uint32_t value = 0; value < 1000; ++value)
+        values.emplace(value, value * 2u);
+
+    BOOST_REQUIRE_EQUAL(values.size(), 1000u);
+    BOOST_REQUIRE_EQUAL(values.at(42), 84u);
+    BOOST_REQUIRE(instance.reserved() > 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 
 #include <future>
 #include <string>
+#include <unordered_set>
 #include <bitcoin/blockchain.hpp>
 
 using namespace bc;
@@ -67,6 +68,16 @@ using namespace boost::filesystem;
     block_chain name(pool, blockchain_settings, database_settings); \
     BOOST_REQUIRE(name.start())
 
+#define START_INDEXED_BLOCKCHAIN(name) \
+    threadpool pool; \
+    database::settings database_settings; \
+    database_settings.directory = TEST_NAME; \
+    BOOST_REQUIRE(create_database(database_settings)); \
+    database_settings.index_start_height = 0; \
+    blockchain::settings blockchain_settings; \
+    block_chain name(pool, blockchain_settings, database_settings); \
+    BOOST_REQUIRE(name.start())
+
 #define NEW_BLOCK(height) \
     std::make_shared<const message::block>(read_block(MAINNET_BLOCK##height))
 
@@ -230,6 +241,37 @@ BOOST_AUTO_TEST_CASE(block_chain__get_branch_work__unbounded__true)
     BOOST_REQUIRE_EQUAL(work, 0x0000000300030003);
 }
 
+BOOST_AUTO_TEST_CASE(block_chain__get_branch_work__above_genesis_unbounded__true)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    const auto block2 = NEW_BLOCK(2);
+    BOOST_REQUIRE(instance.insert(block1, 1));
+    BOOST_REQUIRE(instance.insert(block2, 2));
+
+    uint256_t work;
+    uint256_t maximum(max_uint64);
+
+    // This should exclude the genesis block work.
+    BOOST_REQUIRE(instance.get_branch_work(work, maximum, 1));
+    BOOST_REQUIRE_EQUAL(work, 0x0000000200020002);
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__get_branch_work__gapped__true)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block2 = NEW_BLOCK(2);
+    BOOST_REQUIRE(instance.insert(block2, 2));
+
+    uint256_t work;
+    uint256_t maximum(max_uint64);
+
+    // The gap at height one makes the walk fail (store fallback).
+    BOOST_REQUIRE(!instance.get_branch_work(work, maximum, 0));
+}
+
 BOOST_AUTO_TEST_CASE(block_chain__get_header__not_found__false)
 {
     START_BLOCKCHAIN(instance, false);
@@ -406,6 +448,30 @@ BOOST_AUTO_TEST_CASE(block_chain__get_output__above_fork__false)
     BOOST_REQUIRE(!instance.get_output(output, height, coinbase, outpoint, 1, true));
 }
 
+BOOST_AUTO_TEST_CASE(block_chain__get_outputs__mixed__expected)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    const auto block2 = NEW_BLOCK(2);
+    BOOST_REQUIRE(instance.insert(block1, 1));
+    BOOST_REQUIRE(instance.insert(block2, 2));
+
+    const chain::output_point missing{ null_hash, 42 };
+    const chain::output_point found1{ block1->transactions()[0].hash(), 0 };
+    const chain::output_point found2{ block2->transactions()[0].hash(), 0 };
+    fast_chain::output_queries queries{ { &found1 }, { &missing }, { &found2 } };
+    instance.get_outputs(queries, 2, true);
+    BOOST_REQUIRE_EQUAL(queries.size(), 3u);
+    BOOST_REQUIRE(queries[0].found);
+    BOOST_REQUIRE_EQUAL(queries[0].height, 1u);
+    BOOST_REQUIRE(queries[0].coinbase);
+    BOOST_REQUIRE(!queries[1].found);
+    BOOST_REQUIRE(queries[2].found);
+    BOOST_REQUIRE_EQUAL(queries[2].height, 2u);
+    BOOST_REQUIRE_EQUAL(queries[2].output.value(), initial_block_reward_satoshi());
+}
+
 BOOST_AUTO_TEST_CASE(block_chain__get_is_unspent_transaction__unspent_at_fork__true)
 {
     START_BLOCKCHAIN(instance, false);
@@ -559,6 +625,44 @@ BOOST_AUTO_TEST_CASE(block_chain__fetch_block2__not_exists__error_not_found)
     BOOST_REQUIRE_EQUAL(fetch_block_by_hash_result(instance, block1, 1), error::not_found);
 }
 
+static int fetch_block_data_by_hash_result(block_chain& instance,
+    block_const_ptr block, size_t height)
+{
+    std::promise<code> promise;
+    const auto handler = [=, &promise](code ec,
+        safe_chain::data_const_ptr result_data, size_t result_height)
+    {
+        if (ec)
+        {
+            promise.set_value(ec);
+            return;
+        }
+
+        const auto match = result_height == height &&
+            *result_data == block->to_data();
+        promise.set_value(match ? error::success : error::operation_failed);
+    };
+    instance.fetch_block_data(block->hash(), handler);
+    return promise.get_future().get().value();
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__fetch_block_data__exists__true)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    BOOST_REQUIRE(instance.insert(block1, 1));
+    BOOST_REQUIRE_EQUAL(fetch_block_data_by_hash_result(instance, block1, 1), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__fetch_block_data__not_exists__error_not_found)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    BOOST_REQUIRE_EQUAL(fetch_block_data_by_hash_result(instance, block1, 1), error::not_found);
+}
+
 // fetch_block_header
 
 static int fetch_block_header_by_height_result(block_chain& instance,
@@ -715,4 +819,181 @@ BOOST_AUTO_TEST_CASE(block_chain__fetch_merkle_block2__not_exists__error_not_fou
     BOOST_REQUIRE_EQUAL(fetch_merkle_block_by_hash_result(instance, block1, 1), error::not_found);
 }
 
+// validate_only
+
+static code validate_only_result(block_chain& instance, block_const_ptr block)
+{
+    std::promise<code> promise;
+    const auto handler = [&promise](code ec)
+    {
+        promise.set_value(ec);
+    };
+    instance.validate_only(block, handler);
+    return promise.get_future().get();
+}
+
+static code organize_result(block_chain& instance, block_const_ptr block)
+{
+    std::promise<code> promise;
+    const auto handler = [&promise](code ec)
+    {
+        promise.set_value(ec);
+    };
+    instance.organize(block, handler);
+    return promise.get_future().get();
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__validate_only__valid_block__store_and_pools_unchanged)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    BOOST_REQUIRE_EQUAL(validate_only_result(instance, block1).value(), error::success);
+
+    size_t top;
+    BOOST_REQUIRE(instance.get_last_height(top));
+    BOOST_REQUIRE_EQUAL(top, 0u);
+    BOOST_REQUIRE(!instance.get_block_exists(block1->hash()));
+
+    // The block was neither pooled nor buffered, so it is organized as new.
+    BOOST_REQUIRE_EQUAL(organize_result(instance, block1).value(), error::success);
+    BOOST_REQUIRE(instance.get_block_exists(block1->hash()));
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__validate_only__orphan_block__not_buffered)
+{
+    START_BLOCKCHAIN(instance, false);
+
+    const auto block1 = NEW_BLOCK(1);
+    const auto block2 = NEW_BLOCK(2);
+    BOOST_REQUIRE_EQUAL(validate_only_result(instance, block2).value(), error::orphan_block);
+
+    // A buffered orphan would be organized here as the child of block1.
+    BOOST_REQUIRE_EQUAL(organize_result(instance, block1).value(), error::success);
+    BOOST_REQUIRE(!instance.get_block_exists(block2->hash()));
+}
+
+// fetch_history (paged)
+
+static const auto history_key = base16_literal("0102030405060708090a0b0c0d0e0f1011121314");
+
+// A block with a coinbase that pays the history key once per output.
+static block_const_ptr new_history_block(size_t height, size_t outputs)
+{
+    const chain::script pay(chain::script::to_pay_key_hash_pattern(history_key));
+    chain::output::list payments(outputs, chain::output{ 1, pay });
+    chain::input::list coinbase{ { chain::output_point{ null_hash, chain::point::null_index }, chain::script{}, max_input_sequence } };
+    const auto time = static_cast<uint32_t>(height);
+    const chain::header header{ 1, null_hash, null_hash, time, 0, 0 };
+    const chain::transaction tx{ 1, time, std::move(coinbase), std::move(payments) };
+    return std::make_shared<const message::block>(chain::block{ header, { tx } });
+}
+
+static bool unique_points(const chain::history_compact::list& rows)
+{
+    std::unordered_set<chain::point> points;
+    for (const auto& row: rows)
+        if (!points.insert(row.point).second)
+            return false;
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__fetch_history__multiple_pages__all_rows_once)
+{
+    START_INDEXED_BLOCKCHAIN(instance);
+
+    BOOST_REQUIRE(instance.insert(new_history_block(1, 5), 1));
+    const wallet::payment_address address(history_key, wallet::payment_address::mainnet_p2kh);
+
+    std::vector<size_t> sizes;
+    chain::history_compact::list rows;
+    const auto handler = [&](const code& ec, const chain::history_compact::list& page, const safe_chain::history_cursor&)
+    {
+        BOOST_REQUIRE(!ec);
+        sizes.push_back(page.size());
+        rows.insert(rows.end(), page.begin(), page.end());
+        return true;
+    };
+
+    const safe_chain::history_cursor cursor{};
+    instance.fetch_history(address, 2, cursor, handler);
+    BOOST_REQUIRE_EQUAL(sizes.size(), 3u);
+    BOOST_REQUIRE_EQUAL(sizes[0], 2u);
+    BOOST_REQUIRE_EQUAL(sizes[1], 2u);
+    BOOST_REQUIRE_EQUAL(sizes[2], 1u);
+    BOOST_REQUIRE_EQUAL(rows.size(), 5u);
+    BOOST_REQUIRE(unique_points(rows));
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__fetch_history__resumed_cursor__remaining_rows)
+{
+    START_INDEXED_BLOCKCHAIN(instance);
+
+    BOOST_REQUIRE(instance.insert(new_history_block(1, 5), 1));
+    const wallet::payment_address address(history_key, wallet::payment_address::mainnet_p2kh);
+
+    safe_chain::history_cursor next;
+    chain::history_compact::list rows;
+    const auto handler = [&](const code& ec, const chain::history_compact::list& page, const safe_chain::history_cursor& cursor)
+    {
+        BOOST_REQUIRE(!ec);
+        rows.insert(rows.end(), page.begin(), page.end());
+        next = cursor;
+        return false;
+    };
+
+    instance.fetch_history(address, 2, next, handler);
+    BOOST_REQUIRE_EQUAL(rows.size(), 2u);
+    BOOST_REQUIRE_EQUAL(next.delivered, 2u);
+
+    instance.fetch_history(address, 4, next, handler);
+    BOOST_REQUIRE_EQUAL(rows.size(), 5u);
+    BOOST_REQUIRE_EQUAL(next.delivered, 5u);
+    BOOST_REQUIRE(unique_points(rows));
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__fetch_history__write_between_pages__newer_rows_skipped)
+{
+    START_INDEXED_BLOCKCHAIN(instance);
+
+    BOOST_REQUIRE(instance.insert(new_history_block(1, 5), 1));
+    const wallet::payment_address address(history_key, wallet::payment_address::mainnet_p2kh);
+
+    auto written = false;
+    safe_chain::history_cursor last;
+    chain::history_compact::list rows;
+    const auto handler = [&](const code& ec, const chain::history_compact::list& page, const safe_chain::history_cursor& cursor)
+    {
+        BOOST_REQUIRE(!ec);
+
+        // Confirm more rows for the address above the anchor.
+        if (!written)
+        {
+            BOOST_REQUIRE(instance.insert(new_history_block(2, 3), 2));
+            written = true;
+        }
+
+        rows.insert(rows.end(), page.begin(), page.end());
+        last = cursor;
+        return true;
+    };
+
+    const safe_chain::history_cursor cursor{};
+    instance.fetch_history(address, 2, cursor, handler);
+    BOOST_REQUIRE_EQUAL(rows.size(), 5u);
+    BOOST_REQUIRE(unique_points(rows));
+    BOOST_REQUIRE_EQUAL(last.anchor.height(), 1u);
+    BOOST_REQUIRE_EQUAL(last.delivered, 5u);
+
+    for (const auto& row: rows)
+        BOOST_REQUIRE_EQUAL(row.height, 1u);
+
+    // A new query anchors at the new top and includes the newer rows.
+    rows.clear();
+    instance.fetch_history(address, 2, safe_chain::history_cursor(), handler);
+    BOOST_REQUIRE_EQUAL(rows.size(), 8u);
+    BOOST_REQUIRE(unique_points(rows));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
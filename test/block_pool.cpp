@@ -56,9 +56,22 @@ public:
         return maximum_depth_;
     }
 
-    block_entries& blocks()
+    // Get any root at the given height, or nullptr if there is none.
+    block_const_ptr root(size_t height) const
     {
-        return blocks_;
+        const auto bucket = roots_.find(height);
+        return bucket == roots_.end() || bucket->second.empty() ? nullptr :
+            (*bucket->second.begin())->block;
+    }
+
+    size_t roots() const
+    {
+        size_t count = 0;
+
+        for (const auto& bucket: roots_)
+            count += bucket.second.size();
+
+        return count;
     }
 };
 
@@ -111,10 +124,7 @@ BOOST_AUTO_TEST_CASE(block_pool__add1__one__single)
     instance.add(block1);
     BOOST_REQUIRE_EQUAL(instance.size(), 1u);
 
-    const auto entry = instance.blocks().right.find(height);
-    BOOST_REQUIRE(entry != instance.blocks().right.end());
-    BOOST_REQUIRE(entry->second.block() == block1);
-    BOOST_REQUIRE_EQUAL(entry->first, height);
+    BOOST_REQUIRE(instance.root(height) == block1);
 }
 
 BOOST_AUTO_TEST_CASE(block_pool__add1__twice__single)
@@ -141,9 +151,7 @@ BOOST_AUTO_TEST_CASE(block_pool__add1__two_different_blocks_with_same_hash__firs
     instance.add(block1b);
     BOOST_REQUIRE_EQUAL(instance.size(), 1u);
 
-    const auto entry = instance.blocks().right.find(height1a);
-    BOOST_REQUIRE(entry != instance.blocks().right.end());
-    BOOST_REQUIRE(entry->second.block() == block1a);
+    BOOST_REQUIRE(instance.root(height1a) == block1a);
 }
 
 BOOST_AUTO_TEST_CASE(block_pool__add1__two_distinct_hash__two)
@@ -161,13 +169,9 @@ BOOST_AUTO_TEST_CASE(block_pool__add1__two_distinct_hash__two)
     instance.add(block2);
     BOOST_REQUIRE_EQUAL(instance.size(), 2u);
 
-    const auto& entry1 = instance.blocks().right.find(height1);
-    BOOST_REQUIRE(entry1 != instance.blocks().right.end());
-    BOOST_REQUIRE(entry1->second.block() == block1);
+    BOOST_REQUIRE(instance.root(height1) == block1);
 
-    const auto& entry2 = instance.blocks().right.find(height2);
-    BOOST_REQUIRE(entry2 != instance.blocks().right.end());
-    BOOST_REQUIRE(entry2->second.block() == block2);
+    BOOST_REQUIRE(instance.root(height2) == block2);
 }
 
 // add2
@@ -192,13 +196,9 @@ BOOST_AUTO_TEST_CASE(block_pool__add2__distinct__expected)
     instance.add(std::make_shared<const block_const_ptr_list>(std::move(blocks)));
     BOOST_REQUIRE_EQUAL(instance.size(), 2u);
 
-    const auto entry1 = instance.blocks().right.find(42);
-    BOOST_REQUIRE(entry1 != instance.blocks().right.end());
-    BOOST_REQUIRE(entry1->second.block() == block1);
+    BOOST_REQUIRE(instance.root(42) == block1);
 
-    const auto& entry2 = instance.blocks().right.find(43);
-    BOOST_REQUIRE(entry2 != instance.blocks().right.end());
-    BOOST_REQUIRE(entry2->second.block() == block2);
+    BOOST_REQUIRE(instance.root(43) == block2);
 }
 
 // remove
@@ -269,14 +269,11 @@ BOOST_AUTO_TEST_CASE(block_pool__remove__subtree__reorganized)
     instance.remove(std::make_shared<const block_const_ptr_list>(std::move(path)));
     BOOST_REQUIRE_EQUAL(instance.size(), 3u);
 
-    // Entry3 is the new root block (non-zero height).
-    const auto entry3 = instance.blocks().right.find(44);
-    BOOST_REQUIRE(entry3 != instance.blocks().right.end());
-    BOOST_REQUIRE(entry3->second.block() == block3);
+    // Entry3 is the new root block.
+    BOOST_REQUIRE(instance.root(44) == block3);
 
-    // Remaining entries are children (zero height).
-    const auto children = instance.blocks().right.find(0);
-    BOOST_REQUIRE(children != instance.blocks().right.end());
+    // Remaining entries are children (not roots).
+    BOOST_REQUIRE_EQUAL(instance.roots(), 1u);
 }
 
 // prune
@@ -400,12 +397,43 @@ BOOST_AUTO_TEST_CASE(block_pool__prune__partial_branch_expired__partial_branch_d
     BOOST_REQUIRE_EQUAL(instance.size(), 6u);
 
     // There are four blocks at height 46, make sure at least one exists.
-    const auto entry = instance.blocks().right.find(46);
-    BOOST_REQUIRE(entry != instance.blocks().right.end());
+    BOOST_REQUIRE(instance.root(46));
 
     // There are two blocks at 47 but neither is a root (not replanted).
-    const auto entry8 = instance.blocks().right.find(47);
-    BOOST_REQUIRE(entry8 == instance.blocks().right.end());
+    BOOST_REQUIRE(!instance.root(47));
+}
+
+BOOST_AUTO_TEST_CASE(block_pool__prune__replanted_root__children_linked)
+{
+    block_pool_fixture instance(10);
+    const auto block1 = make_block(1, 45);
+    const auto block2 = make_block(2, 46, block1);
+    const auto block3 = make_block(3, 47, block2);
+    const auto block4 = make_block(4, 48, block3);
+
+    instance.add(block1);
+    instance.add(block2);
+    instance.add(block3);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    // Block1 expires and block2 is replanted as the only root.
+    instance.prune(56);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.roots(), 1u);
+    BOOST_REQUIRE(instance.root(46) == block2);
+
+    const auto path = instance.get_path(block4);
+    BOOST_REQUIRE_EQUAL(path->size(), 3u);
+    BOOST_REQUIRE((*path->blocks())[0] == block2);
+    BOOST_REQUIRE((*path->blocks())[1] == block3);
+    BOOST_REQUIRE((*path->blocks())[2] == block4);
+
+    // Accepting the replanted root promotes its child in place.
+    block_const_ptr_list accepted{ block2 };
+    instance.remove(std::make_shared<const block_const_ptr_list>(std::move(accepted)));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.roots(), 1u);
+    BOOST_REQUIRE(instance.root(47) == block3);
 }
 
 // filter
@@ -20,10 +20,12 @@
 
 #include <memory>
 #include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
 
 using namespace bc;
 using namespace bc::message;
 using namespace bc::blockchain;
+using namespace bc::blockchain::test;
 
 BOOST_AUTO_TEST_SUITE(branch_tests)
 
@@ -315,4 +317,73 @@ BOOST_AUTO_TEST_CASE(branch__work__two_blocks__expected)
     BOOST_REQUIRE(instance.work() == 0);
 }
 
+// populate_spent
+
+BOOST_AUTO_TEST_CASE(branch__populate_spent__one_spend__not_spent)
+{
+    branch instance;
+    const chain::output_point outpoint{ null_hash, 42 };
+    DECLARE_BLOCK(block, 0);
+    block0->set_transactions({ make_spender(outpoint) });
+    BOOST_REQUIRE(instance.push_front(block0));
+
+    instance.populate_spent(outpoint);
+    BOOST_REQUIRE(!outpoint.validation.spent);
+    BOOST_REQUIRE(!outpoint.validation.confirmed);
+}
+
+BOOST_AUTO_TEST_CASE(branch__populate_spent__two_spends_pushed_after_index__spent)
+{
+    branch instance;
+    const chain::output_point outpoint{ null_hash, 42 };
+    DECLARE_BLOCK(block, 0);
+    DECLARE_BLOCK(block, 1);
+    block0->set_transactions({ make_spender(outpoint) });
+    block1->set_transactions({ make_spender(outpoint) });
+    block1->header().set_previous_block_hash(block0->hash());
+    BOOST_REQUIRE(instance.push_front(block1));
+
+    // Index the branch before the second block is pushed.
+    instance.populate_spent(outpoint);
+    BOOST_REQUIRE(!outpoint.validation.spent);
+
+    BOOST_REQUIRE(instance.push_front(block0));
+    instance.populate_spent(outpoint);
+    BOOST_REQUIRE(outpoint.validation.spent);
+    BOOST_REQUIRE(outpoint.validation.confirmed);
+}
+
+// populate_prevout
+
+BOOST_AUTO_TEST_CASE(branch__populate_prevout__coinbase_in_branch__expected)
+{
+    branch instance;
+    DECLARE_BLOCK(block, 0);
+    DECLARE_BLOCK(block, 1);
+    const auto funding = make_funding();
+    const chain::output_point outpoint{ funding.hash(), 0 };
+    block0->set_transactions({ funding });
+    block1->set_transactions({ make_spender(outpoint) });
+    block1->header().set_previous_block_hash(block0->hash());
+    BOOST_REQUIRE(instance.push_front(block1));
+    BOOST_REQUIRE(instance.push_front(block0));
+
+    instance.populate_prevout(outpoint);
+    BOOST_REQUIRE(outpoint.validation.cache.is_valid());
+    BOOST_REQUIRE_EQUAL(outpoint.validation.cache.value(), 10u);
+    BOOST_REQUIRE_EQUAL(outpoint.validation.height, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(branch__populate_prevout__missing__invalid)
+{
+    branch instance;
+    const chain::output_point outpoint{ null_hash, 42 };
+    DECLARE_BLOCK(block, 0);
+    block0->set_transactions({ make_spender(outpoint) });
+    BOOST_REQUIRE(instance.push_front(block0));
+
+    instance.populate_prevout(outpoint);
+    BOOST_REQUIRE(!outpoint.validation.cache.is_valid());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
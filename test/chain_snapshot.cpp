@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::blockchain::test;
+using namespace boost::filesystem;
+
+struct snapshot_fixture
+{
+    snapshot_fixture()
+      : file(temp_directory_path() / unique_path("chain_snapshot_%%%%%%%%"))
+    {
+    }
+
+    ~snapshot_fixture()
+    {
+        boost::system::error_code ec;
+        remove(file, ec);
+    }
+
+    const path file;
+};
+
+BOOST_FIXTURE_TEST_SUITE(chain_snapshot_tests, snapshot_fixture)
+
+static const config::checkpoint top{ null_hash, 2 };
+
+BOOST_AUTO_TEST_CASE(chain_snapshot__load__missing__false)
+{
+    const chain_snapshot instance(file);
+    chain_snapshot::work_list work;
+    header_cache headers(10);
+    BOOST_REQUIRE(!instance.load(top, work, headers));
+}
+
+BOOST_AUTO_TEST_CASE(chain_snapshot__save__empty_path__false)
+{
+    const chain_snapshot instance(path{});
+    const chain_snapshot::work_list work{ 1, 2, 3 };
+    const header_cache headers(10);
+    BOOST_REQUIRE(!instance.save(top, work, headers));
+}
+
+BOOST_AUTO_TEST_CASE(chain_snapshot__save__incomplete_work__false)
+{
+    const chain_snapshot instance(file);
+    const chain_snapshot::work_list work{ 1, 2 };
+    const header_cache headers(10);
+    BOOST_REQUIRE(!instance.save(top, work, headers));
+}
+
+BOOST_AUTO_TEST_CASE(chain_snapshot__load__saved__round_trip)
+{
+    const chain_snapshot instance(file);
+    const chain_snapshot::work_list work{ 1, 2, uint256_t(1) << 200 };
+    header_cache headers(10);
+    headers.push(make_header(1), 1);
+    headers.push(make_header(2), 2);
+    BOOST_REQUIRE(instance.save(top, work, headers));
+
+    chain_snapshot::work_list out_work;
+    header_cache out_headers(10);
+    BOOST_REQUIRE(instance.load(top, out_work, out_headers));
+    BOOST_REQUIRE(out_work == work);
+    BOOST_REQUIRE_EQUAL(out_headers.size(), 2u);
+
+    header_cache::record record;
+    BOOST_REQUIRE(out_headers.get(record, 2));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 2u);
+    BOOST_REQUIRE(record.hash == make_header(2).hash());
+}
+
+BOOST_AUTO_TEST_CASE(chain_snapshot__load__other_top__false_and_removed)
+{
+    const chain_snapshot instance(file);
+    const chain_snapshot::work_list work{ 1, 2, 3 };
+    const header_cache headers(10);
+    BOOST_REQUIRE(instance.save(top, work, headers));
+
+    chain_snapshot::work_list out_work;
+    header_cache out_headers(10);
+    const config::checkpoint other{ null_hash, 3 };
+    BOOST_REQUIRE(!instance.load(other, out_work, out_headers));
+    BOOST_REQUIRE(out_work.empty());
+    BOOST_REQUIRE(!instance.load(top, out_work, out_headers));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::blockchain::test;
+
+BOOST_AUTO_TEST_SUITE(header_cache_tests)
+
+BOOST_AUTO_TEST_CASE(header_cache__get__empty__false)
+{
+    const header_cache instance(10);
+    header_cache::record record;
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.get(record, 0));
+}
+
+BOOST_AUTO_TEST_CASE(header_cache__push__contiguous__expected)
+{
+    header_cache instance(10);
+    const auto header1 = make_header(1);
+    instance.push(header1, 5);
+    instance.push(make_header(2), 6);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+
+    header_cache::record record;
+    BOOST_REQUIRE(instance.get(record, 5));
+    BOOST_REQUIRE(record.hash == header1.hash());
+    BOOST_REQUIRE_EQUAL(record.timestamp, 1u);
+    BOOST_REQUIRE_EQUAL(record.bits, 42u);
+    BOOST_REQUIRE_EQUAL(record.version, 1u);
+    BOOST_REQUIRE(instance.get(record, 6));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 2u);
+    BOOST_REQUIRE(!instance.get(record, 4));
+    BOOST_REQUIRE(!instance.get(record, 7));
+}
+
+BOOST_AUTO_TEST_CASE(header_cache__push__gap__reset)
+{
+    header_cache instance(10);
+    instance.push(make_header(1), 5);
+    instance.push(make_header(2), 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    header_cache::record record;
+    BOOST_REQUIRE(!instance.get(record, 5));
+    BOOST_REQUIRE(instance.get(record, 7));
+}
+
+BOOST_AUTO_TEST_CASE(header_cache__push__over_capacity__oldest_evicted)
+{
+    header_cache instance(2);
+    instance.push(make_header(1), 0);
+    instance.push(make_header(2), 1);
+    instance.push(make_header(3), 2);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+
+    header_cache::record record;
+    BOOST_REQUIRE(!instance.get(record, 0));
+    BOOST_REQUIRE(instance.get(record, 1));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 2u);
+    BOOST_REQUIRE(instance.get(record, 2));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(header_cache__pop_above__reorganization__expected)
+{
+    header_cache instance(10);
+    instance.push(make_header(1), 0);
+    instance.push(make_header(2), 1);
+    instance.push(make_header(3), 2);
+    instance.pop_above(0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    header_cache::record record;
+    BOOST_REQUIRE(!instance.get(record, 1));
+
+    instance.push(make_header(4), 1);
+    BOOST_REQUIRE(instance.get(record, 1));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 4u);
+    BOOST_REQUIRE(instance.get(record, 0));
+    BOOST_REQUIRE_EQUAL(record.timestamp, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(header_cache__push__zero_capacity__disabled)
+{
+    header_cache instance(0);
+    instance.push(make_header(1), 0);
+    header_cache::record record;
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.get(record, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::blockchain::test;
+
+BOOST_AUTO_TEST_SUITE(header_index_tests)
+
+BOOST_AUTO_TEST_CASE(header_index__find__empty__false)
+{
+    const header_index instance(10);
+    size_t height;
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(height, make_header(1).hash()));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__contiguous__expected)
+{
+    header_index instance(10);
+    const auto header1 = make_header(1);
+    const auto header2 = make_header(2);
+    instance.push(header1, 5);
+    instance.push(header2, 6);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+
+    size_t height;
+    BOOST_REQUIRE(instance.find(height, header2.hash()));
+    BOOST_REQUIRE_EQUAL(height, 6u);
+
+    message::header::list headers;
+    BOOST_REQUIRE_EQUAL(instance.get(headers, 5, 10), 2u);
+    BOOST_REQUIRE_EQUAL(headers.size(), 2u);
+    BOOST_REQUIRE(headers[0].hash() == header1.hash());
+    BOOST_REQUIRE(headers[1].hash() == header2.hash());
+
+    hash_list hashes;
+    BOOST_REQUIRE_EQUAL(instance.get(hashes, 6, 10), 1u);
+    BOOST_REQUIRE(hashes.front() == header2.hash());
+    BOOST_REQUIRE_EQUAL(instance.get(hashes, 4, 10), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__gap__reset)
+{
+    header_index instance(10);
+    const auto header1 = make_header(1);
+    instance.push(header1, 5);
+    instance.push(make_header(2), 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    size_t height;
+    BOOST_REQUIRE(!instance.find(height, header1.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__over_capacity__oldest_evicted)
+{
+    header_index instance(2);
+    const auto header1 = make_header(1);
+    instance.push(header1, 0);
+    instance.push(make_header(2), 1);
+    instance.push(make_header(3), 2);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+
+    size_t height;
+    BOOST_REQUIRE(!instance.find(height, header1.hash()));
+
+    message::header::list headers;
+    BOOST_REQUIRE_EQUAL(instance.get(headers, 1, 10), 2u);
+    BOOST_REQUIRE_EQUAL(headers[1].timestamp(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__pop_above__reorganization__popped)
+{
+    header_index instance(10);
+    const auto header3 = make_header(3);
+    instance.push(make_header(1), 1);
+    instance.push(make_header(2), 2);
+    instance.push(header3, 3);
+    instance.pop_above(1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    size_t height;
+    BOOST_REQUIRE(!instance.find(height, header3.hash()));
+
+    // The index resumes contiguously above the fork point.
+    instance.push(header3, 2);
+    BOOST_REQUIRE(instance.find(height, header3.hash()));
+    BOOST_REQUIRE_EQUAL(height, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__zero_capacity__disabled)
+{
+    header_index instance(0);
+    instance.push(make_header(1), 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(histogram_tests)
+
+BOOST_AUTO_TEST_CASE(histogram__get__empty__zeros)
+{
+    const histogram instance;
+    const auto values = instance.get();
+    BOOST_REQUIRE_EQUAL(values.count, 0u);
+    BOOST_REQUIRE_EQUAL(values.sum, 0u);
+    BOOST_REQUIRE_EQUAL(values.maximum, 0u);
+    BOOST_REQUIRE_EQUAL(values.percentile(0.5), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__record__values__expected_buckets)
+{
+    histogram instance;
+    instance.record(0);
+    instance.record(1);
+    instance.record(2);
+    instance.record(3);
+    instance.record(4);
+
+    const auto values = instance.get();
+    BOOST_REQUIRE_EQUAL(values.count, 5u);
+    BOOST_REQUIRE_EQUAL(values.sum, 10u);
+    BOOST_REQUIRE_EQUAL(values.maximum, 4u);
+    BOOST_REQUIRE_EQUAL(values.distribution[0], 1u);
+    BOOST_REQUIRE_EQUAL(values.distribution[1], 1u);
+    BOOST_REQUIRE_EQUAL(values.distribution[2], 2u);
+    BOOST_REQUIRE_EQUAL(values.distribution[3], 1u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__record__maximum_value__last_bucket)
+{
+    histogram instance;
+    instance.record(max_uint64);
+
+    const auto values = instance.get();
+    BOOST_REQUIRE_EQUAL(values.distribution[histogram::buckets - 1u], 1u);
+    BOOST_REQUIRE_EQUAL(values.percentile(1.0), max_uint64);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__percentile__skewed__bucket_upper_bound)
+{
+    histogram instance;
+
+    for (size_t index = 0; index < 99; ++index)
+        instance.record(10);
+
+    instance.record(1000);
+
+    const auto values = instance.get();
+    BOOST_REQUIRE_EQUAL(values.percentile(0.5), 15u);
+    BOOST_REQUIRE_EQUAL(values.percentile(0.995), 1023u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__reset__recorded__zeros)
+{
+    histogram instance;
+    instance.record(42);
+    instance.reset();
+    BOOST_REQUIRE_EQUAL(instance.get().count, 0u);
+    BOOST_REQUIRE_EQUAL(instance.get().maximum, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
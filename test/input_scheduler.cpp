@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(input_scheduler_tests)
+
+static transaction make_tx(size_t inputs)
+{
+    return{ 1, 0, input::list(inputs), output::list{} };
+}
+
+// The coinbase (one input) is excluded from scheduling.
+static block_const_ptr make_block()
+{
+    return std::make_shared<const message::block>(header{},
+        transaction::list{ make_tx(1), make_tx(2), make_tx(0), make_tx(3) });
+}
+
+BOOST_AUTO_TEST_CASE(input_scheduler__size__coinbase_only__zero)
+{
+    const auto block = std::make_shared<const message::block>(header{},
+        transaction::list{ make_tx(1) });
+
+    input_scheduler instance(block, 4);
+    size_t begin;
+    size_t end;
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.next(begin, end));
+}
+
+BOOST_AUTO_TEST_CASE(input_scheduler__next__all__contiguous_and_complete)
+{
+    input_scheduler instance(make_block(), 4);
+    BOOST_REQUIRE_EQUAL(instance.size(), 5u);
+
+    size_t begin;
+    size_t end;
+    size_t expected = 0;
+
+    while (instance.next(begin, end))
+    {
+        BOOST_REQUIRE_EQUAL(begin, expected);
+        BOOST_REQUIRE_GT(end, begin);
+        expected = end;
+    }
+
+    BOOST_REQUIRE_EQUAL(expected, 5u);
+}
+
+BOOST_AUTO_TEST_CASE(input_scheduler__locate__positions__expected)
+{
+    const input_scheduler instance(make_block(), 1);
+    size_t tx;
+    size_t input;
+
+    instance.locate(tx, input, 0);
+    BOOST_REQUIRE_EQUAL(tx, 1u);
+    BOOST_REQUIRE_EQUAL(input, 0u);
+
+    instance.locate(tx, input, 1);
+    BOOST_REQUIRE_EQUAL(tx, 1u);
+    BOOST_REQUIRE_EQUAL(input, 1u);
+
+    // The input-less tx (position 2) is skipped.
+    instance.locate(tx, input, 2);
+    BOOST_REQUIRE_EQUAL(tx, 3u);
+    BOOST_REQUIRE_EQUAL(input, 0u);
+
+    instance.locate(tx, input, 4);
+    BOOST_REQUIRE_EQUAL(tx, 3u);
+    BOOST_REQUIRE_EQUAL(input, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(input_scheduler__next__cancelled__false)
+{
+    input_scheduler instance(make_block(), 4);
+    size_t begin;
+    size_t end;
+    BOOST_REQUIRE(!instance.cancelled());
+    BOOST_REQUIRE(instance.next(begin, end));
+
+    instance.cancel();
+    BOOST_REQUIRE(instance.cancelled());
+    BOOST_REQUIRE(!instance.next(begin, end));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/blockchain.hpp>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(memory_advisor_tests)
+
+// to_access
+
+BOOST_AUTO_TEST_CASE(memory_advisor__to_access__valid__expected)
+{
+    memory_advisor::access access;
+    BOOST_REQUIRE(memory_advisor::to_access(access, "normal"));
+    BOOST_REQUIRE(access == memory_advisor::access::normal);
+    BOOST_REQUIRE(memory_advisor::to_access(access, " random "));
+    BOOST_REQUIRE(access == memory_advisor::access::random);
+    BOOST_REQUIRE(memory_advisor::to_access(access, "sequential"));
+    BOOST_REQUIRE(access == memory_advisor::access::sequential);
+}
+
+BOOST_AUTO_TEST_CASE(memory_advisor__to_access__invalid__false)
+{
+    memory_advisor::access access;
+    BOOST_REQUIRE(!memory_advisor::to_access(access, ""));
+    BOOST_REQUIRE(!memory_advisor::to_access(access, "willneed"));
+}
+
+// advise
+
+BOOST_AUTO_TEST_CASE(memory_advisor__advise__normal__false)
+{
+    const settings configuration;
+    const memory_advisor instance("memory_advisor", configuration);
+    BOOST_REQUIRE(!instance.advise());
+}
+
+// prefault
+
+BOOST_AUTO_TEST_CASE(memory_advisor__prefault__disabled__false)
+{
+    const settings configuration;
+    const memory_advisor instance("memory_advisor", configuration);
+    BOOST_REQUIRE(!instance.prefault());
+}
+
+BOOST_AUTO_TEST_CASE(memory_advisor__prefault__missing_store__false)
+{
+    settings configuration;
+    configuration.prefault_megabytes = 1;
+    const memory_advisor instance("memory_advisor_missing", configuration);
+    BOOST_REQUIRE(!instance.prefault());
+}
+
+// enforce
+
+BOOST_AUTO_TEST_CASE(memory_advisor__enforce__no_budget__false)
+{
+    const settings configuration;
+    const memory_advisor instance("memory_advisor", configuration);
+    uint64_t resident;
+    BOOST_REQUIRE(!instance.enforce(resident));
+}
+
+BOOST_AUTO_TEST_CASE(memory_advisor__enforce__within_budget__false)
+{
+    settings configuration;
+    configuration.memory_budget_megabytes = 1;
+    const memory_advisor instance("memory_advisor", configuration);
+    uint64_t resident;
+    BOOST_REQUIRE(!instance.enforce(resident));
+}
+
+#if defined(__linux__) && defined(MADV_PAGEOUT)
+
+static constexpr size_t mapped_size = 4u * 1024u * 1024u;
+
+// Map a file of the directory shared and touch every page (as the store).
+static uint8_t* map_store(const boost::filesystem::path& directory)
+{
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(directory, ec);
+    BOOST_REQUIRE(boost::filesystem::create_directories(directory, ec));
+
+    const auto path = (directory / "test_table").string();
+    const auto file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    BOOST_REQUIRE(file != -1);
+    BOOST_REQUIRE_EQUAL(ftruncate(file, mapped_size), 0);
+
+    const auto map = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED, file, 0);
+    close(file);
+    BOOST_REQUIRE(map != MAP_FAILED);
+
+    const auto data = static_cast<uint8_t*>(map);
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    for (size_t offset = 0; offset < mapped_size; offset += page)
+        data[offset] = 42;
+
+    return data;
+}
+
+BOOST_AUTO_TEST_CASE(memory_advisor__enforce__store_exceeds_budget__paged_out_once_per_interval)
+{
+    const boost::filesystem::path directory("memory_advisor_mapped");
+    const auto data = map_store(directory);
+
+    settings configuration;
+    configuration.memory_budget_megabytes = 1;
+    const memory_advisor instance(directory, configuration);
+
+    uint64_t before;
+    BOOST_REQUIRE(instance.resident(before));
+    BOOST_REQUIRE_GE(before, mapped_size);
+
+    uint64_t resident = 0;
+    BOOST_REQUIRE(instance.enforce(resident));
+    BOOST_REQUIRE_GE(resident, mapped_size);
+
+    // The budget is not checked again within the interval.
+    BOOST_REQUIRE(!instance.enforce(resident));
+    munmap(data, mapped_size);
+}
+
+#endif
+
+// resident
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(memory_advisor__resident__unmapped_store__zero)
+{
+    const settings configuration;
+    const memory_advisor instance("memory_advisor_unmapped", configuration);
+    uint64_t resident = 42;
+    BOOST_REQUIRE(instance.resident(resident));
+    BOOST_REQUIRE_EQUAL(resident, 0u);
+}
+#endif
+
+// sample
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(memory_advisor__sample__linux__resident)
+{
+    memory_advisor::usage usage;
+    BOOST_REQUIRE(memory_advisor::sample(usage));
+    BOOST_REQUIRE_GT(usage.resident_bytes, 0u);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(notification_queue_tests)
+
+typedef notification_queue<size_t> queue;
+
+struct recorder
+{
+    void deliver(size_t& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        values.push_back(value);
+        condition.notify_all();
+    }
+
+    void wait(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return values.size() >= count; });
+    }
+
+    std::vector<size_t> values;
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+static bool sum(size_t& last, const size_t& next)
+{
+    last += next;
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(notification_queue__push__not_started__false)
+{
+    threadpool pool(1);
+    recorder record;
+    const auto instance = std::make_shared<queue>(pool, 10,
+        [&](size_t& value) { record.deliver(value); });
+
+    BOOST_REQUIRE(!instance->push(42));
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(notification_queue__push__started__delivered_in_order)
+{
+    threadpool pool(2);
+    recorder record;
+    const auto instance = std::make_shared<queue>(pool, 4,
+        [&](size_t& value) { record.deliver(value); });
+
+    instance->start();
+
+    for (size_t value = 0; value < 16; ++value)
+        BOOST_REQUIRE(instance->push(size_t(value)));
+
+    record.wait(16);
+    instance->stop();
+    pool.shutdown();
+    pool.join();
+
+    BOOST_REQUIRE_EQUAL(record.values.size(), 16u);
+
+    for (size_t value = 0; value < 16; ++value)
+        BOOST_REQUIRE_EQUAL(record.values[value], value);
+}
+
+BOOST_AUTO_TEST_CASE(notification_queue__push__worker_busy__coalesced)
+{
+    threadpool pool(1);
+    recorder record;
+    const auto instance = std::make_shared<queue>(pool, 10,
+        [&](size_t& value) { record.deliver(value); }, &sum);
+
+    // Occupy the only thread so that the events are queued together.
+    std::promise<void> release;
+    const auto released = release.get_future().share();
+    pool.service().post([released]() { released.wait(); });
+
+    instance->start();
+    BOOST_REQUIRE(instance->push(1));
+    BOOST_REQUIRE(instance->push(2));
+    BOOST_REQUIRE(instance->push(3));
+    release.set_value();
+
+    record.wait(1);
+    instance->stop();
+    pool.shutdown();
+    pool.join();
+
+    BOOST_REQUIRE_EQUAL(record.values.size(), 1u);
+    BOOST_REQUIRE_EQUAL(record.values.front(), 6u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(orphan_block_pool_tests)
+
+static block_const_ptr make_block(uint32_t id, const hash_digest& parent)
+{
+    return std::make_shared<const message::block>(message::block
+    {
+        chain::header{ id, parent, null_hash, 0, 0, 0 }, {}
+    });
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__exists__empty__false)
+{
+    const orphan_block_pool instance(10, 0);
+    BOOST_REQUIRE(!instance.exists(null_hash));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__add__disabled__false)
+{
+    orphan_block_pool instance(0, 0);
+    const auto block = make_block(1, null_hash);
+    BOOST_REQUIRE(!instance.add(block));
+    BOOST_REQUIRE(!instance.exists(block->hash()));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__add__duplicate__false)
+{
+    orphan_block_pool instance(10, 0);
+    const auto block = make_block(1, null_hash);
+    BOOST_REQUIRE(instance.add(block));
+    BOOST_REQUIRE(!instance.add(block));
+    BOOST_REQUIRE(instance.exists(block->hash()));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__add__limit_exceeded__oldest_evicted)
+{
+    orphan_block_pool instance(2, 0);
+    const auto block1 = make_block(1, null_hash);
+    const auto block2 = make_block(2, null_hash);
+    const auto block3 = make_block(3, null_hash);
+    BOOST_REQUIRE(instance.add(block1));
+    BOOST_REQUIRE(instance.add(block2));
+    BOOST_REQUIRE(instance.add(block3));
+    BOOST_REQUIRE(!instance.exists(block1->hash()));
+    BOOST_REQUIRE(instance.exists(block2->hash()));
+    BOOST_REQUIRE(instance.exists(block3->hash()));
+    BOOST_REQUIRE_EQUAL(instance.remove(null_hash).size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__add__byte_limit_exceeded__oldest_evicted)
+{
+    const auto block1 = make_block(1, null_hash);
+    const auto block2 = make_block(2, null_hash);
+    const auto block3 = make_block(3, null_hash);
+    const auto size = block1->serialized_size(message::version::level::canonical);
+
+    // Room for two blocks by size, though not by count.
+    orphan_block_pool instance(10, 2 * size);
+    BOOST_REQUIRE(instance.add(block1));
+    BOOST_REQUIRE(instance.add(block2));
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 2 * size);
+    BOOST_REQUIRE(instance.add(block3));
+    BOOST_REQUIRE(!instance.exists(block1->hash()));
+    BOOST_REQUIRE(instance.exists(block2->hash()));
+    BOOST_REQUIRE(instance.exists(block3->hash()));
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 2 * size);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__add__block_exceeds_byte_limit__false)
+{
+    const auto block = make_block(1, null_hash);
+    const auto size = block->serialized_size(message::version::level::canonical);
+    orphan_block_pool instance(10, size - 1u);
+    BOOST_REQUIRE(!instance.add(block));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__is_ancestor__zero_distance__same_hash)
+{
+    const orphan_block_pool instance(10, 0);
+    const auto block = make_block(1, null_hash);
+    BOOST_REQUIRE(instance.is_ancestor(block->hash(), block->hash(), 0));
+    BOOST_REQUIRE(!instance.is_ancestor(null_hash, block->hash(), 0));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__is_ancestor__buffered_descendants__true)
+{
+    orphan_block_pool instance(10, 0);
+    const auto ancestor = make_block(1, null_hash);
+    const auto child = make_block(2, ancestor->hash());
+    const auto grandchild = make_block(3, child->hash());
+    BOOST_REQUIRE(instance.add(child));
+    BOOST_REQUIRE(instance.add(grandchild));
+    BOOST_REQUIRE(instance.is_ancestor(ancestor->hash(), child->hash(), 1));
+    BOOST_REQUIRE(instance.is_ancestor(ancestor->hash(), grandchild->hash(), 2));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__is_ancestor__wrong_distance__false)
+{
+    orphan_block_pool instance(10, 0);
+    const auto ancestor = make_block(1, null_hash);
+    const auto child = make_block(2, ancestor->hash());
+    const auto grandchild = make_block(3, child->hash());
+    BOOST_REQUIRE(instance.add(child));
+    BOOST_REQUIRE(instance.add(grandchild));
+    BOOST_REQUIRE(!instance.is_ancestor(ancestor->hash(), grandchild->hash(), 1));
+    BOOST_REQUIRE(!instance.is_ancestor(ancestor->hash(), grandchild->hash(), 3));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__is_ancestor__unbuffered_link__false)
+{
+    orphan_block_pool instance(10, 0);
+    const auto ancestor = make_block(1, null_hash);
+    const auto child = make_block(2, ancestor->hash());
+    const auto grandchild = make_block(3, child->hash());
+    BOOST_REQUIRE(instance.add(grandchild));
+    BOOST_REQUIRE(!instance.is_ancestor(ancestor->hash(), grandchild->hash(), 2));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__is_ancestor__sibling_branch__false)
+{
+    orphan_block_pool instance(10, 0);
+    const auto ancestor = make_block(1, null_hash);
+    const auto sibling = make_block(2, null_hash);
+    const auto child = make_block(3, ancestor->hash());
+    const auto nephew = make_block(4, sibling->hash());
+    BOOST_REQUIRE(instance.add(child));
+    BOOST_REQUIRE(instance.add(nephew));
+    BOOST_REQUIRE(!instance.is_ancestor(ancestor->hash(), nephew->hash(), 1));
+    BOOST_REQUIRE(!instance.is_ancestor(sibling->hash(), child->hash(), 1));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__remove__parent__children_removed)
+{
+    orphan_block_pool instance(10, 0);
+    const auto parent = make_block(1, null_hash);
+    const auto child1 = make_block(2, parent->hash());
+    const auto child2 = make_block(3, parent->hash());
+    const auto grandchild = make_block(4, child1->hash());
+    BOOST_REQUIRE(instance.add(child1));
+    BOOST_REQUIRE(instance.add(child2));
+    BOOST_REQUIRE(instance.add(grandchild));
+
+    const auto children = instance.remove(parent->hash());
+    BOOST_REQUIRE_EQUAL(children.size(), 2u);
+    BOOST_REQUIRE(!instance.exists(child1->hash()));
+    BOOST_REQUIRE(!instance.exists(child2->hash()));
+    BOOST_REQUIRE(instance.exists(grandchild->hash()));
+    BOOST_REQUIRE(instance.remove(parent->hash()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(orphan_block_pool__filter__buffered__removed)
+{
+    orphan_block_pool instance(10, 0);
+    const auto block1 = make_block(1, null_hash);
+    const auto block2 = make_block(2, null_hash);
+    BOOST_REQUIRE(instance.add(block1));
+
+    const message::inventory_vector expected{ message::inventory::type_id::block, block2->hash() };
+    message::get_data data
+    {
+        { message::inventory::type_id::block, block1->hash() },
+        expected
+    };
+    const auto message = std::make_shared<message::get_data>(std::move(data));
+    instance.filter(message);
+    BOOST_REQUIRE_EQUAL(message->inventories().size(), 1u);
+    BOOST_REQUIRE(message->inventories()[0] == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(orphan_pool_tests)
+
+static const auto hash1 = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+
+// The locktime distinguishes otherwise identical txs.
+static transaction_const_ptr make_tx(const hash_digest& previous,
+    uint32_t index, uint32_t locktime)
+{
+    input::list inputs{ { output_point{ previous, index }, script{}, 0 } };
+    output::list outputs{ { 42, script{} }, { 24, script{} } };
+    return std::make_shared<const message::transaction>(
+        transaction{ 1, locktime, std::move(inputs), std::move(outputs) });
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__exists__empty__false)
+{
+    const orphan_pool instance(10, 0);
+    BOOST_REQUIRE(!instance.exists(hash1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__disabled__false)
+{
+    orphan_pool instance(0, 0);
+    const auto tx = make_tx(hash1, 0, 0);
+    BOOST_REQUIRE(!instance.add(tx));
+    BOOST_REQUIRE(!instance.exists(tx->hash()));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__exists__true)
+{
+    orphan_pool instance(10, 0);
+    const auto tx = make_tx(hash1, 0, 0);
+    BOOST_REQUIRE(instance.add(tx));
+    BOOST_REQUIRE(instance.exists(tx->hash()));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__duplicate__false)
+{
+    orphan_pool instance(10, 0);
+    const auto tx = make_tx(hash1, 0, 0);
+    BOOST_REQUIRE(instance.add(tx));
+    BOOST_REQUIRE(!instance.add(tx));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__limit_exceeded__oldest_evicted)
+{
+    orphan_pool instance(2, 0);
+    const auto tx1 = make_tx(hash1, 0, 1);
+    const auto tx2 = make_tx(hash1, 0, 2);
+    const auto tx3 = make_tx(hash1, 0, 3);
+    BOOST_REQUIRE(instance.add(tx1));
+    BOOST_REQUIRE(instance.add(tx2));
+    BOOST_REQUIRE(instance.add(tx3));
+    BOOST_REQUIRE(!instance.exists(tx1->hash()));
+    BOOST_REQUIRE(instance.exists(tx2->hash()));
+    BOOST_REQUIRE(instance.exists(tx3->hash()));
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__byte_limit_exceeded__oldest_evicted)
+{
+    const auto tx1 = make_tx(hash1, 0, 1);
+    const auto tx2 = make_tx(hash1, 0, 2);
+    const auto tx3 = make_tx(hash1, 0, 3);
+    const auto size = tx1->serialized_size(message::version::level::canonical);
+
+    // Room for two txs by size, though not by count.
+    orphan_pool instance(10, 2 * size);
+    BOOST_REQUIRE(instance.add(tx1));
+    BOOST_REQUIRE(instance.add(tx2));
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 2 * size);
+    BOOST_REQUIRE(instance.add(tx3));
+    BOOST_REQUIRE(!instance.exists(tx1->hash()));
+    BOOST_REQUIRE(instance.exists(tx2->hash()));
+    BOOST_REQUIRE(instance.exists(tx3->hash()));
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 2 * size);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__add__tx_exceeds_byte_limit__false)
+{
+    const auto tx = make_tx(hash1, 0, 0);
+    const auto size = tx->serialized_size(message::version::level::canonical);
+    orphan_pool instance(10, size - 1u);
+    BOOST_REQUIRE(!instance.add(tx));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__remove__unrelated_parent__empty)
+{
+    orphan_pool instance(10, 0);
+    const auto parent = make_tx(hash1, 0, 0);
+    const auto child = make_tx(hash1, 1, 0);
+    BOOST_REQUIRE(instance.add(child));
+    BOOST_REQUIRE(instance.remove(parent).empty());
+    BOOST_REQUIRE(instance.exists(child->hash()));
+}
+
+BOOST_AUTO_TEST_CASE(orphan_pool__remove__parent__children_removed)
+{
+    orphan_pool instance(10, 0);
+    const auto parent = make_tx(hash1, 0, 0);
+    const auto child1 = make_tx(parent->hash(), 0, 1);
+    const auto child2 = make_tx(parent->hash(), 1, 2);
+    const auto other = make_tx(hash1, 1, 3);
+    BOOST_REQUIRE(instance.add(child1));
+    BOOST_REQUIRE(instance.add(child2));
+    BOOST_REQUIRE(instance.add(other));
+
+    const auto children = instance.remove(parent);
+    BOOST_REQUIRE_EQUAL(children.size(), 2u);
+    BOOST_REQUIRE(!instance.exists(child1->hash()));
+    BOOST_REQUIRE(!instance.exists(child2->hash()));
+    BOOST_REQUIRE(instance.exists(other->hash()));
+    BOOST_REQUIRE(instance.remove(parent).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(prioritized_mutex_tests)
+
+static const auto settle = std::chrono::milliseconds(50);
+
+BOOST_AUTO_TEST_CASE(prioritized_mutex__lock_low_priority__high_held__waits)
+{
+    prioritized_mutex instance;
+    std::atomic<bool> locked(false);
+    instance.lock_high_priority();
+
+    std::thread low([&]()
+    {
+        instance.lock_low_priority();
+        locked = true;
+        instance.unlock_low_priority();
+    });
+
+    std::this_thread::sleep_for(settle);
+    BOOST_REQUIRE(!locked);
+
+    instance.unlock_high_priority();
+    low.join();
+    BOOST_REQUIRE(locked);
+}
+
+BOOST_AUTO_TEST_CASE(prioritized_mutex__lock_low_priority_shared__high_requested__waits)
+{
+    prioritized_mutex instance;
+    std::atomic<bool> high_locked(false);
+    std::atomic<bool> low_locked(false);
+    std::atomic<bool> low_first(false);
+
+    // A shared holder delays the high request, which then holds the gate.
+    instance.lock_low_priority_shared();
+
+    std::thread high([&]()
+    {
+        instance.lock_high_priority();
+        high_locked = true;
+        low_first = low_locked.load();
+        instance.unlock_high_priority();
+    });
+
+    std::this_thread::sleep_for(settle);
+
+    std::thread low([&]()
+    {
+        instance.lock_low_priority_shared();
+        low_locked = true;
+        instance.unlock_low_priority_shared();
+    });
+
+    std::this_thread::sleep_for(settle);
+    BOOST_REQUIRE(!high_locked);
+    BOOST_REQUIRE(!low_locked);
+
+    instance.unlock_low_priority_shared();
+    high.join();
+    low.join();
+    BOOST_REQUIRE(high_locked);
+    BOOST_REQUIRE(low_locked);
+    BOOST_REQUIRE(!low_first);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
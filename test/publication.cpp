@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <boost/filesystem.hpp>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace boost::filesystem;
+
+struct publication_fixture
+{
+    publication_fixture()
+      : file(temp_directory_path() / unique_path("publication_%%%%%%%%"))
+    {
+    }
+
+    ~publication_fixture()
+    {
+        boost::system::error_code ec;
+        remove(file, ec);
+    }
+
+    const path file;
+};
+
+BOOST_FIXTURE_TEST_SUITE(publication_tests, publication_fixture)
+
+BOOST_AUTO_TEST_CASE(publication__read__missing__false)
+{
+    const publication instance(file);
+    config::checkpoint top;
+    uint64_t sequence;
+    BOOST_REQUIRE(!instance.read(top, sequence));
+}
+
+BOOST_AUTO_TEST_CASE(publication__publish__empty_path__false)
+{
+    const publication instance(path{});
+    BOOST_REQUIRE(!instance.publish({ null_hash, 42 }, 0));
+}
+
+BOOST_AUTO_TEST_CASE(publication__read__published__round_trip)
+{
+    const publication instance(file);
+    const config::checkpoint expected{ hash_literal(
+        "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f"), 42 };
+    BOOST_REQUIRE(instance.publish(expected, 2));
+
+    config::checkpoint top;
+    uint64_t sequence;
+    BOOST_REQUIRE(instance.read(top, sequence));
+    BOOST_REQUIRE(top == expected);
+    BOOST_REQUIRE_EQUAL(sequence, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(publication__read__republished__latest)
+{
+    const publication instance(file);
+    BOOST_REQUIRE(instance.publish({ null_hash, 1 }, 2));
+    BOOST_REQUIRE(instance.publish({ null_hash, 2 }, 4));
+
+    config::checkpoint top;
+    uint64_t sequence;
+    BOOST_REQUIRE(instance.read(top, sequence));
+    BOOST_REQUIRE_EQUAL(top.height(), 2u);
+    BOOST_REQUIRE_EQUAL(sequence, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(publication__read__writing__odd_sequence)
+{
+    const publication instance(file);
+    BOOST_REQUIRE(instance.publish({ null_hash, 2 }, 2));
+    BOOST_REQUIRE(instance.publish({ null_hash, 1 }, 3));
+
+    config::checkpoint top;
+    uint64_t sequence;
+    BOOST_REQUIRE(instance.read(top, sequence));
+    BOOST_REQUIRE_EQUAL(top.height(), 1u);
+    BOOST_REQUIRE_EQUAL(sequence, 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(relay_cache_tests)
+
+static relay_cache::entry::ptr make_entry(uint32_t timestamp, size_t height)
+{
+    const chain::header header{ 1, null_hash, null_hash, timestamp, 42, 0 };
+    return std::make_shared<const relay_cache::entry>(relay_cache::entry
+    {
+        header, header.hash(), height, {}, 0, {}, {}
+    });
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__find__empty__null)
+{
+    relay_cache instance(10);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__add__zero_limit__disabled)
+{
+    relay_cache instance(0);
+    const auto entry = make_entry(1, 1);
+    instance.add(entry, instance.generation());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(entry->hash));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__add__over_limit__least_recent_evicted)
+{
+    relay_cache instance(2);
+    const auto entry1 = make_entry(1, 1);
+    const auto entry2 = make_entry(2, 2);
+    const auto entry3 = make_entry(3, 3);
+    instance.add(entry1, instance.generation());
+    instance.add(entry2, instance.generation());
+
+    // Promote the first entry so that the second is least recent.
+    BOOST_REQUIRE(instance.find(entry1->hash) == entry1);
+    instance.add(entry3, instance.generation());
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(instance.find(entry1->hash) == entry1);
+    BOOST_REQUIRE(!instance.find(entry2->hash));
+    BOOST_REQUIRE(instance.find(entry3->hash) == entry3);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__pop_above__reorganization__popped)
+{
+    relay_cache instance(10);
+    const auto entry1 = make_entry(1, 1);
+    const auto entry2 = make_entry(2, 2);
+    instance.add(entry1, instance.generation());
+    instance.add(entry2, instance.generation());
+    instance.pop_above(1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.find(entry1->hash) == entry1);
+    BOOST_REQUIRE(!instance.find(entry2->hash));
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__add__stale_generation__rejected)
+{
+    relay_cache instance(10);
+    const auto generation = instance.generation();
+    instance.pop_above(0);
+    instance.add(make_entry(1, 1), generation);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__pop_above__added_during_write__popped)
+{
+    relay_cache instance(10);
+    instance.pop_above(0);
+    const auto generation = instance.generation();
+    const auto entry = make_entry(1, 1);
+    instance.add(entry, generation);
+    BOOST_REQUIRE(instance.find(entry->hash) == entry);
+
+    instance.pop_above(0);
+    BOOST_REQUIRE(!instance.find(entry->hash));
+    instance.add(entry, generation);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(relay_cache__to_short_ids__nonce__keyed)
+{
+    const chain::header header{ 1, null_hash, null_hash, 1, 42, 0 };
+    const hash_list hashes{ null_hash, hash_digest{ { 1 } } };
+    const auto ids1 = relay_cache::to_short_ids(header, 1, hashes.begin(),
+        hashes.end());
+    const auto ids2 = relay_cache::to_short_ids(header, 2, hashes.begin(),
+        hashes.end());
+
+    BOOST_REQUIRE_EQUAL(ids1.size(), 2u);
+    BOOST_REQUIRE(ids1[0] != ids1[1]);
+    BOOST_REQUIRE(ids1 != ids2);
+    BOOST_REQUIRE(ids1 == relay_cache::to_short_ids(header, 1,
+        hashes.begin(), hashes.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(rolling_filter_tests)
+
+static const auto hash1 = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+static const auto hash2 = hash_literal("f702453dd03b0f055e5437d76128141803984fb10acb85fc3b2184fae2f3fa78");
+static const auto hash3 = hash_literal("0e3e2357e806b6cdb1f70b54c3a3a17b6714ee1f0e68bebb44a74b1efd512098");
+
+BOOST_AUTO_TEST_CASE(rolling_filter__contains__empty__false)
+{
+    const rolling_filter instance(10);
+    BOOST_REQUIRE(!instance.contains(hash1));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_filter__add__contains__true)
+{
+    rolling_filter instance(10);
+    instance.add(hash1);
+    BOOST_REQUIRE(instance.contains(hash1));
+    BOOST_REQUIRE(!instance.contains(hash2));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_filter__add__limit_exceeded__previous_generation_retained)
+{
+    rolling_filter instance(1);
+    instance.add(hash1);
+    instance.add(hash2);
+    BOOST_REQUIRE(instance.contains(hash1));
+    BOOST_REQUIRE(instance.contains(hash2));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_filter__add__limit_exceeded_twice__oldest_expired)
+{
+    rolling_filter instance(1);
+    instance.add(hash1);
+    instance.add(hash2);
+    instance.add(hash3);
+    BOOST_REQUIRE(!instance.contains(hash1));
+    BOOST_REQUIRE(instance.contains(hash2));
+    BOOST_REQUIRE(instance.contains(hash3));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_filter__clear__added__false)
+{
+    rolling_filter instance(10);
+    instance.add(hash1);
+    instance.clear();
+    BOOST_REQUIRE(!instance.contains(hash1));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_filter__add__zero_limit__disabled)
+{
+    rolling_filter instance(0);
+    instance.add(hash1);
+    BOOST_REQUIRE(!instance.contains(hash1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(script_cache_tests)
+
+static const auto hash1 = hash_literal("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+static const auto hash2 = hash_literal("f702453dd03b0f055e5437d76128141803984fb10acb85fc3b2184fae2f3fa78");
+
+BOOST_AUTO_TEST_CASE(script_cache__exists__empty__false)
+{
+    const script_cache instance(10);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.exists(hash1, 0, 0));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__exists__true)
+{
+    script_cache instance(10);
+    instance.add(hash1, 1, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.exists(hash1, 1, 42));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__different_key__false)
+{
+    script_cache instance(10);
+    instance.add(hash1, 1, 42);
+    BOOST_REQUIRE(!instance.exists(hash2, 1, 42));
+    BOOST_REQUIRE(!instance.exists(hash1, 0, 42));
+    BOOST_REQUIRE(!instance.exists(hash1, 1, 0));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__duplicate__one)
+{
+    script_cache instance(10);
+    instance.add(hash1, 1, 42);
+    instance.add(hash1, 1, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__over_limit__oldest_evicted)
+{
+    script_cache instance(2);
+    instance.add(hash1, 0, 0);
+    instance.add(hash1, 1, 0);
+    instance.add(hash1, 2, 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(!instance.exists(hash1, 0, 0));
+    BOOST_REQUIRE(instance.exists(hash1, 1, 0));
+    BOOST_REQUIRE(instance.exists(hash1, 2, 0));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__zero_limit__disabled)
+{
+    script_cache instance(0);
+    instance.add(hash1, 0, 0);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.exists(hash1, 0, 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(stage_pools_tests)
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__empty__false)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, ""));
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__single__expected)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(stage_pools::to_cpus(cpus, "3"));
+    BOOST_REQUIRE_EQUAL(cpus.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cpus[0], 3u);
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__ranges__expected)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(stage_pools::to_cpus(cpus, "0-2, 8,10-11"));
+    const stage_pools::cpus expected{ 0, 1, 2, 8, 10, 11 };
+    BOOST_REQUIRE(cpus == expected);
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__reversed_range__false)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "4-2"));
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__invalid__false)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "1,x"));
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "-1"));
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "nodex"));
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__to_cpus__out_of_range__false)
+{
+    stage_pools::cpus cpus;
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "0-4000000000"));
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "99999999999999999999999"));
+    BOOST_REQUIRE(!stage_pools::to_cpus(cpus, "node99999999999999999999"));
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__construct__shared_stages__populate_dispatcher)
+{
+    blockchain::settings configuration;
+    configuration.cores = 2;
+    stage_pools instance(configuration);
+    BOOST_REQUIRE_EQUAL(instance.populate().size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.script().size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.store().size(), 2u);
+    instance.shutdown();
+    instance.join();
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__construct__script_cores__own_dispatcher)
+{
+    blockchain::settings configuration;
+    configuration.cores = 1;
+    configuration.script_cores = 3;
+    stage_pools instance(configuration);
+    BOOST_REQUIRE_EQUAL(instance.populate().size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.script().size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.store().size(), 1u);
+    instance.shutdown();
+    instance.join();
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__concurrent__batches__all_run)
+{
+    blockchain::settings configuration;
+    configuration.cores = 2;
+    stage_pools instance(configuration);
+    std::atomic<size_t> runs(0);
+    const auto run = [&runs]() { ++runs; };
+    stage_pools::concurrent(instance.store(), { run, run, run, run });
+    BOOST_REQUIRE_EQUAL(runs.load(), 4u);
+    instance.shutdown();
+    instance.join();
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__concurrent__from_only_pool_thread__all_run)
+{
+    blockchain::settings configuration;
+    configuration.cores = 1;
+    stage_pools instance(configuration);
+    std::atomic<size_t> runs(0);
+    std::promise<void> complete;
+    const auto run = [&runs]() { ++runs; };
+
+    instance.store().concurrent([&]()
+    {
+        stage_pools::concurrent(instance.store(), { run, run, run });
+        complete.set_value();
+    });
+
+    complete.get_future().wait();
+    BOOST_REQUIRE_EQUAL(runs.load(), 3u);
+    instance.shutdown();
+    instance.join();
+}
+
+BOOST_AUTO_TEST_CASE(stage_pools__concurrent__stopped__all_run)
+{
+    blockchain::settings configuration;
+    configuration.cores = 1;
+    stage_pools instance(configuration);
+    instance.shutdown();
+    instance.join();
+
+    std::atomic<size_t> runs(0);
+    const auto run = [&runs]() { ++runs; };
+    stage_pools::concurrent(instance.store(), { run, run });
+    BOOST_REQUIRE_EQUAL(runs.load(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
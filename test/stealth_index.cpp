@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+
+BOOST_AUTO_TEST_SUITE(stealth_index_tests)
+
+static const chain::block empty_block{};
+static const binary all{};
+
+static bool covered(const stealth_index& instance, size_t height)
+{
+    chain::stealth_compact::list rows;
+    return instance.scan(rows, all, height, stealth_index::buckets(all));
+}
+
+// A null data ephemeral key output paired with a pay to key hash output.
+static const chain::script ephemeral_script
+{
+    machine::operation::list
+    {
+        { machine::opcode::return_ },
+        { data_chunk(hash_size, 0x42) }
+    }
+};
+
+static const short_hash payment_hash{ { 0x01, 0x02, 0x03 } };
+
+static chain::block make_stealth_block()
+{
+    const chain::transaction tx
+    {
+        1, 0, {},
+        {
+            { 0, ephemeral_script },
+            { 10, chain::script(
+                chain::script::to_pay_key_hash_pattern(payment_hash)) }
+        }
+    };
+
+    chain::block block;
+    block.set_transactions({ tx });
+    return block;
+}
+
+// The little endian prefix of the ephemeral script, as a filter of the bits.
+static binary to_filter(size_t bits, bool match)
+{
+    uint32_t prefix;
+    BOOST_REQUIRE(to_stealth_prefix(prefix, ephemeral_script));
+    auto bytes = to_little_endian(prefix);
+
+    if (!match)
+        bytes[0] ^= 0x80;
+
+    return binary(bits, bytes);
+}
+
+static chain::stealth_compact::list scan(const stealth_index& instance,
+    const binary& filter)
+{
+    chain::stealth_compact::list rows;
+    BOOST_REQUIRE(instance.scan(rows, filter, 1,
+        stealth_index::buckets(filter)));
+    return rows;
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__buckets__empty_filter__all)
+{
+    const auto buckets = stealth_index::buckets(all);
+    BOOST_REQUIRE_EQUAL(buckets.first, 0u);
+    BOOST_REQUIRE_EQUAL(buckets.second, 1u << stealth_index::bucket_bits);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__buckets__short_filter__range)
+{
+    const binary filter{ 4, data_chunk{ 0xa0 } };
+    const auto buckets = stealth_index::buckets(filter);
+    BOOST_REQUIRE_EQUAL(buckets.first, 0xa00u);
+    BOOST_REQUIRE_EQUAL(buckets.second, 0xb00u);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__buckets__long_filter__single)
+{
+    const binary filter{ 16, data_chunk{ 0xff, 0x0f } };
+    const auto buckets = stealth_index::buckets(filter);
+    BOOST_REQUIRE_EQUAL(buckets.first, 0xff0u);
+    BOOST_REQUIRE_EQUAL(buckets.second, 0xff1u);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__disabled__false)
+{
+    stealth_index instance(0);
+    instance.push(empty_block, 1);
+    BOOST_REQUIRE(!covered(instance, 1));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__empty__false)
+{
+    const stealth_index instance(10);
+    BOOST_REQUIRE(!covered(instance, 0));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__push__scan__covered_from_floor)
+{
+    stealth_index instance(10);
+    instance.push(empty_block, 5);
+    instance.push(empty_block, 6);
+    BOOST_REQUIRE(!covered(instance, 4));
+    BOOST_REQUIRE(covered(instance, 5));
+    BOOST_REQUIRE(covered(instance, 7));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__push__gap__floor_restarted)
+{
+    stealth_index instance(10);
+    instance.push(empty_block, 5);
+    instance.push(empty_block, 7);
+    BOOST_REQUIRE(!covered(instance, 5));
+    BOOST_REQUIRE(covered(instance, 7));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__push__depth_exceeded__floor_raised)
+{
+    stealth_index instance(2);
+    instance.push(empty_block, 1);
+    instance.push(empty_block, 2);
+    instance.push(empty_block, 3);
+    BOOST_REQUIRE(!covered(instance, 1));
+    BOOST_REQUIRE(covered(instance, 2));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__pop_above__below_floor__not_covered)
+{
+    stealth_index instance(10);
+    instance.push(empty_block, 5);
+    instance.push(empty_block, 6);
+    instance.pop_above(4);
+    BOOST_REQUIRE(!covered(instance, 5));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__pop_above__above_floor__extended_from_fork)
+{
+    stealth_index instance(10);
+    instance.push(empty_block, 5);
+    instance.push(empty_block, 6);
+    instance.pop_above(5);
+    instance.push(empty_block, 6);
+    BOOST_REQUIRE(covered(instance, 5));
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__matching_filter__row)
+{
+    stealth_index instance(10);
+    const auto block = make_stealth_block();
+    instance.push(block, 1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    const auto rows = scan(instance, to_filter(16, true));
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].public_key_hash == payment_hash);
+
+    hash_digest ephemeral_key;
+    ephemeral_key.fill(0x42);
+    BOOST_REQUIRE(rows[0].ephemeral_public_key_hash == ephemeral_key);
+    BOOST_REQUIRE(rows[0].transaction_hash ==
+        block.transactions()[0].hash());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__short_matching_filter__row)
+{
+    stealth_index instance(10);
+    instance.push(make_stealth_block(), 1);
+    BOOST_REQUIRE_EQUAL(scan(instance, to_filter(4, true)).size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__non_matching_filter__empty)
+{
+    stealth_index instance(10);
+    instance.push(make_stealth_block(), 1);
+    BOOST_REQUIRE(scan(instance, to_filter(16, false)).empty());
+    BOOST_REQUIRE(scan(instance, to_filter(4, false)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__scan__chunked__row)
+{
+    threadpool pool(2);
+    dispatcher dispatch(pool, "stealth_index_test");
+    stealth_index instance(10);
+    instance.push(make_stealth_block(), 1);
+
+    chain::stealth_compact::list rows;
+    BOOST_REQUIRE(instance.scan(rows, all, 1, stealth_index::buckets(all),
+        dispatch, 4));
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].public_key_hash == payment_hash);
+
+    rows.clear();
+    const auto other = to_filter(4, false);
+    BOOST_REQUIRE(instance.scan(rows, other, 1,
+        stealth_index::buckets(other), dispatch, 4));
+    BOOST_REQUIRE(rows.empty());
+
+    pool.shutdown();
+    pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(stealth_index__clear__not_covered)
+{
+    stealth_index instance(10);
+    instance.push(empty_block, 5);
+    instance.clear();
+    BOOST_REQUIRE(!covered(instance, 5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
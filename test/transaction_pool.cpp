@@ -21,6 +21,7 @@
 #include <bitcoin/blockchain.hpp>
 
 using namespace bc;
+using namespace bc::chain;
 using namespace bc::blockchain;
 
 #ifdef WITH_BLOCKCHAIN_REPLIER
@@ -67,4 +68,257 @@ BOOST_AUTO_TEST_CASE(transaction_pool__construct__foo__bar)
     // TODO
 }
 
+static const auto default_tx_hash = hash_literal("f702453dd03b0f055e5437d76128141803984fb10acb85fc3b2184fae2f3fa78");
+
+// find
+
+BOOST_AUTO_TEST_CASE(transaction_pool__find__empty__nullptr)
+{
+    const blockchain::settings configuration;
+    const transaction_pool instance(configuration);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(default_tx_hash));
+}
+
+// add
+
+BOOST_AUTO_TEST_CASE(transaction_pool__add__default_tx__found_with_forks)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction tx;
+    instance.add(tx, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    const auto entry = instance.find(default_tx_hash);
+    BOOST_REQUIRE(entry);
+    BOOST_REQUIRE_EQUAL(entry->forks(), 42u);
+    BOOST_REQUIRE_EQUAL(entry->size(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__add__duplicate__replaced)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction tx;
+    instance.add(tx, 42);
+    instance.add(tx, transaction_pool::sentinel_forks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.find(default_tx_hash)->forks(),
+        transaction_pool::sentinel_forks);
+}
+
+// remove
+
+BOOST_AUTO_TEST_CASE(transaction_pool__remove__confirmed__not_found)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction tx;
+    instance.add(tx, 42);
+
+    const auto block = std::make_shared<const message::block>(header{},
+        transaction::list{ tx });
+    const auto blocks = std::make_shared<const block_const_ptr_list>(
+        block_const_ptr_list{ block });
+
+    instance.remove(blocks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(default_tx_hash));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__remove__conflict__conflict_and_descendant_removed)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction conflict{ 1, 0, { { { default_tx_hash, 0 }, {}, 0 } }, {} };
+    const transaction child{ 1, 0, { { { conflict.hash(), 0 }, {}, 0 } }, {} };
+    const transaction confirmed{ 2, 0, { { { default_tx_hash, 0 }, {}, 0 } }, {} };
+    instance.add(conflict, 42);
+    instance.add(child, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+
+    const auto block = std::make_shared<const message::block>(header{},
+        transaction::list{ confirmed });
+    const auto blocks = std::make_shared<const block_const_ptr_list>(
+        block_const_ptr_list{ block });
+
+    instance.remove(blocks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(conflict.hash()));
+    BOOST_REQUIRE(!instance.find(child.hash()));
+}
+
+// get_validated
+
+BOOST_AUTO_TEST_CASE(transaction_pool__get_validated__unvalidated__empty)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+    BOOST_REQUIRE(instance.get_validated().empty());
+}
+
+// find_spender
+
+BOOST_AUTO_TEST_CASE(transaction_pool__find_spender__unspent__nullptr)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+    BOOST_REQUIRE(!instance.find_spender({ default_tx_hash, 0 }));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__find_spender__spent__spender)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction tx{ 1, 0, { { { default_tx_hash, 0 }, {}, 0 } }, {} };
+    instance.add(tx, 42);
+
+    const auto spender = instance.find_spender({ default_tx_hash, 0 });
+    BOOST_REQUIRE(spender);
+    BOOST_REQUIRE(spender->hash() == tx.hash());
+    BOOST_REQUIRE(!instance.find_spender({ default_tx_hash, 1 }));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__find_spender__confirmed__nullptr)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    const transaction tx{ 1, 0, { { { default_tx_hash, 0 }, {}, 0 } }, {} };
+    instance.add(tx, 42);
+
+    const auto block = std::make_shared<const message::block>(header{},
+        transaction::list{ tx });
+    const auto blocks = std::make_shared<const block_const_ptr_list>(
+        block_const_ptr_list{ block });
+
+    instance.remove(blocks);
+    BOOST_REQUIRE(!instance.find_spender({ default_tx_hash, 0 }));
+}
+
+// clear
+
+BOOST_AUTO_TEST_CASE(transaction_pool__clear__one__empty)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+    instance.clear();
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+// fetch_template
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_template__empty__no_hashes)
+{
+    const blockchain::settings configuration;
+    const transaction_pool instance(configuration);
+
+    const auto handler = [](const code& ec, merkle_block_ptr block, size_t)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(block);
+        BOOST_REQUIRE(block->hashes().empty());
+    };
+
+    instance.fetch_template(handler);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_template__sentinel__excluded)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, transaction_pool::sentinel_forks);
+
+    const auto handler = [](const code& ec, merkle_block_ptr block, size_t)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(block->hashes().empty());
+    };
+
+    instance.fetch_template(handler);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_template__one__included)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+
+    const auto handler = [](const code& ec, merkle_block_ptr block, size_t)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(block->hashes().size(), 1u);
+        BOOST_REQUIRE(block->hashes().front() == default_tx_hash);
+    };
+
+    instance.fetch_template(handler);
+}
+
+// fetch_mempool
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_mempool__sentinel__excluded)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, transaction_pool::sentinel_forks);
+
+    const auto handler = [](const code& ec, inventory_ptr inventory)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(inventory->inventories().empty());
+    };
+
+    instance.fetch_mempool(10, 0, handler);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_mempool__one__included)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+
+    const auto handler = [](const code& ec, inventory_ptr inventory)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(inventory->inventories().size(), 1u);
+        BOOST_REQUIRE(inventory->inventories().front().hash() ==
+            default_tx_hash);
+    };
+
+    instance.fetch_mempool(10, 0, handler);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_mempool__below_minimum_fee__excluded)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+
+    const auto handler = [](const code& ec, inventory_ptr inventory)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(inventory->inventories().empty());
+    };
+
+    instance.fetch_mempool(10, 1000, handler);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_pool__fetch_mempool__zero_maximum__empty)
+{
+    const blockchain::settings configuration;
+    transaction_pool instance(configuration);
+    instance.add(transaction{}, 42);
+
+    const auto handler = [](const code& ec, inventory_ptr inventory)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(inventory->inventories().empty());
+    };
+
+    instance.fetch_mempool(0, 0, handler);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::blockchain::test;
+
+BOOST_AUTO_TEST_SUITE(unspent_filter_tests)
+
+static const auto funding = make_funding();
+
+BOOST_AUTO_TEST_CASE(unspent_filter__contains__inactive__true)
+{
+    const unspent_filter instance(10);
+    BOOST_REQUIRE(!instance.authoritative());
+    BOOST_REQUIRE(instance.contains(null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__activate__zero_limit__inactive)
+{
+    unspent_filter instance(0);
+    instance.add(funding.hash());
+    instance.activate();
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.authoritative());
+    BOOST_REQUIRE(instance.contains(null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__contains__activated_empty__false)
+{
+    unspent_filter instance(10);
+    instance.activate();
+    BOOST_REQUIRE(instance.authoritative());
+    BOOST_REQUIRE(!instance.contains(null_hash));
+    BOOST_REQUIRE(!instance.contains(funding.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__contains__added__true)
+{
+    unspent_filter instance(10);
+    instance.add(funding.hash());
+    instance.activate();
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.contains(funding.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__add__block__transactions_contained)
+{
+    unspent_filter instance(10);
+    const chain::transaction other{ 2, 0, {}, { { 20, {} } } };
+    instance.activate();
+    instance.add(make_block({ funding, other }));
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(instance.contains(funding.hash()));
+    BOOST_REQUIRE(instance.contains(other.hash()));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__add__beyond_limit__inactive)
+{
+    unspent_filter instance(1);
+    const chain::transaction other{ 2, 0, {}, { { 20, {} } } };
+    instance.activate();
+    instance.add(funding.hash());
+    BOOST_REQUIRE(instance.authoritative());
+
+    instance.add(other.hash());
+    BOOST_REQUIRE(!instance.authoritative());
+    BOOST_REQUIRE(instance.contains(null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__saturated__beyond_limit__true)
+{
+    unspent_filter instance(1);
+    const chain::transaction other{ 2, 0, {}, { { 20, {} } } };
+    instance.add(funding.hash());
+    BOOST_REQUIRE(!instance.saturated());
+
+    instance.add(other.hash());
+    BOOST_REQUIRE(instance.saturated());
+}
+
+BOOST_AUTO_TEST_CASE(unspent_filter__clear__activated__inactive_empty)
+{
+    unspent_filter instance(10);
+    instance.add(funding.hash());
+    instance.activate();
+    instance.clear();
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.authoritative());
+
+    instance.activate();
+    BOOST_REQUIRE(!instance.contains(funding.hash()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_TEST_UTILITY_HPP
+#define LIBBITCOIN_BLOCKCHAIN_TEST_UTILITY_HPP
+
+#include <cstdint>
+#include <bitcoin/blockchain.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+namespace test {
+
+// Distinct headers of a common shape, differing only by timestamp.
+inline chain::header make_header(uint32_t timestamp)
+{
+    return chain::header{ 1, null_hash, null_hash, timestamp, 42, 0 };
+}
+
+// A tx without inputs that funds output 0 of its hash with 10 satoshis.
+inline chain::transaction make_funding()
+{
+    return{ 1, 0, {}, { { 10, {} } } };
+}
+
+// A tx spending the outpoint to a single 5 satoshi output.
+inline chain::transaction make_spender(const chain::output_point& outpoint)
+{
+    return{ 1, 0, { { outpoint, {}, 0 } }, { { 5, {} } } };
+}
+
+// A block of the txs with a default header.
+inline chain::block make_block(const chain::transaction::list& txs)
+{
+    chain::block block;
+    block.set_transactions(txs);
+    return block;
+}
+
+} // namespace test
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
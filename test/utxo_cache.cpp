@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+#include "utility.hpp"
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::blockchain::test;
+
+BOOST_AUTO_TEST_SUITE(utxo_cache_tests)
+
+static const auto funding = make_funding();
+
+BOOST_AUTO_TEST_CASE(utxo_cache__get__empty__false)
+{
+    const utxo_cache instance(10);
+    chain::output output;
+    size_t height;
+    bool coinbase;
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.get(output, height, coinbase,
+        { funding.hash(), 0 }, 100));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__block__outputs_cached)
+{
+    utxo_cache instance(10);
+    instance.add(make_block({ funding }), 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    chain::output output;
+    size_t height;
+    bool coinbase;
+    BOOST_REQUIRE(instance.get(output, height, coinbase,
+        { funding.hash(), 0 }, 42));
+    BOOST_REQUIRE_EQUAL(output.value(), 10u);
+    BOOST_REQUIRE_EQUAL(output.validation.spender_height,
+        chain::output::validation::not_spent);
+    BOOST_REQUIRE_EQUAL(height, 42u);
+    BOOST_REQUIRE(coinbase);
+
+    // The output does not exist below its height.
+    BOOST_REQUIRE(!instance.get(output, height, coinbase,
+        { funding.hash(), 0 }, 41));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__spent_in_block__removed)
+{
+    utxo_cache instance(10);
+    const chain::output_point outpoint{ funding.hash(), 0 };
+    const auto spender = make_spender(outpoint);
+    instance.add(make_block({ funding, spender }), 1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    chain::output output;
+    size_t height;
+    bool coinbase;
+    BOOST_REQUIRE(!instance.get(output, height, coinbase, outpoint, 1));
+    BOOST_REQUIRE(instance.get(output, height, coinbase,
+        { spender.hash(), 0 }, 1));
+    BOOST_REQUIRE(!coinbase);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__remove_spent__spender__removed)
+{
+    utxo_cache instance(10);
+    const chain::output_point outpoint{ funding.hash(), 0 };
+    instance.add(make_block({ funding }), 1);
+    instance.remove_spent(make_block({ funding, make_spender(outpoint) }));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__pop_above__reorganization__popped)
+{
+    utxo_cache instance(10);
+    const auto spender = make_spender({ null_hash, 42 });
+    instance.add(make_block({ funding }), 1);
+    instance.add(make_block({ spender }), 2);
+    instance.pop_above(1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    chain::output output;
+    size_t height;
+    bool coinbase;
+    BOOST_REQUIRE(!instance.get(output, height, coinbase,
+        { spender.hash(), 0 }, 2));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__zero_limit__disabled)
+{
+    utxo_cache instance(0);
+    instance.add(make_block({ funding }), 1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
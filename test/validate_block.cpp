@@ -17,12 +17,36 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <string>
 #include <bitcoin/blockchain.hpp>
 
 using namespace bc;
 using namespace bc::chain;
 using namespace bc::blockchain;
 using namespace bc::machine;
+using namespace boost::system;
+using namespace boost::filesystem;
+
+#define MAINNET_BLOCK1 \
+"010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982" \
+"051fd1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff00" \
+"1d01e3629901010000000100000000000000000000000000000000000000000000000000000" \
+"00000000000ffffffff0704ffff001d0104ffffffff0100f2052a0100000043410496b538e8" \
+"53519c726a2c91e61ec11600ae1390813a627c66fb8be7947be63c52da7589379515d4e0a60" \
+"4f8141781e62294721166bf621e73a82cbf2342c858eeac00000000"
+
+#define MAINNET_BLOCK2 \
+"010000004860eb18bf1b1620e37e9490fc8a427514416fd75159ab86688e9a8300000000d5f" \
+"dcc541e25de1c7a5addedf24858b8bb665c9f36ef744ee42c316022c90f9bb0bc6649ffff00" \
+"1d08d2bd6101010000000100000000000000000000000000000000000000000000000000000" \
+"00000000000ffffffff0704ffff001d010bffffffff0100f2052a010000004341047211a824" \
+"f55b505228e4c3d5194c1fcfaa15a456abdf37f9b9d97a4040afc073dee6c89064984f03385" \
+"237d92167c13e236446b417ab79a0fcae412ae3316b77ac00000000"
+
+#define TEST_NAME \
+    std::string(boost::unit_test::framework::current_test_case().p_name)
 
 BOOST_AUTO_TEST_SUITE(validate_block_tests)
 
@@ -32,6 +56,93 @@ BOOST_AUTO_TEST_SUITE(validate_block_tests)
     static const auto libconsensus = false;
 #endif
 
+static block_const_ptr read_block(const std::string& hex)
+{
+    data_chunk data;
+    BOOST_REQUIRE(decode_base16(data, hex));
+    const auto block = std::make_shared<message::block>();
+    BOOST_REQUIRE(block->from_data(message::version::level::canonical, data));
+    return block;
+}
+
+static bool create_store(database::settings& out_database)
+{
+    out_database.directory = TEST_NAME;
+    out_database.index_start_height = max_uint32;
+    out_database.file_growth_rate = 42;
+    out_database.block_table_buckets = 42;
+    out_database.transaction_table_buckets = 42;
+    out_database.spend_table_buckets = 42;
+    out_database.history_table_buckets = 42;
+
+    error_code ec;
+    remove_all(out_database.directory, ec);
+    database::data_base database(out_database);
+    return create_directories(out_database.directory, ec) &&
+        database.create(chain::block::genesis_mainnet());
+}
+
+// Accept block1 on the genesis store with block2 assumed valid, returning
+// whether the coinbase of block1 was populated (i.e. fully validated).
+static code accept_block1(bool buffer_assumed, bool& out_populated)
+{
+    const auto block1 = read_block(MAINNET_BLOCK1);
+    const auto block2 = read_block(MAINNET_BLOCK2);
+
+    threadpool pool(1);
+    dispatcher dispatch(pool, "validate_block_tests");
+    database::settings database_settings;
+    BOOST_REQUIRE(create_store(database_settings));
+
+    blockchain::settings settings;
+    settings.checkpoints.clear();
+    settings.assume_valid = config::checkpoint(block2->hash(), 2);
+    block_chain blocks(pool, settings, database_settings);
+    BOOST_REQUIRE(blocks.start());
+
+    transaction_pool transactions(settings);
+    script_cache cache(0);
+    orphan_block_pool orphans(10, 0);
+
+    if (buffer_assumed)
+        BOOST_REQUIRE(orphans.add(block2));
+
+    validate_block instance(dispatch, dispatch, blocks, settings, transactions,
+        cache, orphans);
+    instance.start();
+
+    const auto fork = std::make_shared<blockchain::branch>(0);
+    BOOST_REQUIRE(fork->push_front(block1));
+
+    std::promise<code> promise;
+    const auto handler = [&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    };
+
+    instance.accept(fork, handler);
+    const auto ec = promise.get_future().get();
+    const auto& coinbase = block1->transactions().front().inputs().front();
+    out_populated = coinbase.previous_output().validation.confirmed;
+
+    instance.stop();
+    return ec;
+}
+
+BOOST_AUTO_TEST_CASE(validate_block__accept__assumed_descendant_buffered__not_populated)
+{
+    auto populated = true;
+    BOOST_REQUIRE_EQUAL(accept_block1(true, populated).value(), error::success);
+    BOOST_REQUIRE(!populated);
+}
+
+BOOST_AUTO_TEST_CASE(validate_block__accept__assumed_descendant_unknown__populated)
+{
+    auto populated = false;
+    BOOST_REQUIRE_EQUAL(accept_block1(false, populated).value(), error::success);
+    BOOST_REQUIRE(populated);
+}
+
 BOOST_AUTO_TEST_CASE(validate_block__native__block_438513_tx__valid)
 {
     ////06:21:05.532171 DEBUG [blockchain] Input validation failed (stack false)
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_BENCH_USAGE \
+    "Usage: bitprim-blockchain-bench <mode> [options]\n" \
+    "  record <store> <from> <to> <file>  Write blocks of a store to a file.\n" \
+    "  blocks <store> <file> [--pipeline]  Replay file blocks via organize.\n" \
+    "  transactions <store> <file> <threads> [--concurrent] " \
+    "[--independent]\n" \
+    "      Flood the non-coinbase txs of file blocks via organize.\n" \
+    "  queries <store> <threads,...> <count> [file]\n" \
+    "      Time count fetches per thread, organizing file blocks meanwhile.\n"
+#define BS_BENCH_FILE_FAIL \
+    "Failed to open the file %1%.\n"
+#define BS_BENCH_PARSE_FAIL \
+    "Failed to parse block %1% of the file.\n"
+#define BS_BENCH_HISTOGRAM \
+    "%1$-14s count %2$10d mean %3$10.1f p50 %4$10d p99 %5$10d max %6$10d\n"
+
+namespace libbitcoin {
+namespace bench {
+
+using namespace bc::blockchain;
+using boost::format;
+
+environment::environment(const boost::filesystem::path& directory)
+  : chain_settings(config::settings::mainnet),
+    database_settings(config::settings::mainnet)
+{
+    database_settings.directory = directory;
+}
+
+double seconds(const asio::time_point& start, const asio::time_point& end)
+{
+    using namespace std::chrono;
+    return duration_cast<duration<double>>(end - start).count();
+}
+
+bool read_blocks(const std::string& file, block_const_ptr_list& out_blocks)
+{
+    bc::ifstream in(file, std::ifstream::binary);
+
+    if (!in)
+    {
+        std::cerr << format(BS_BENCH_FILE_FAIL) % file;
+        return false;
+    }
+
+    istream_reader source(in);
+
+    while (true)
+    {
+        const auto size = source.read_4_bytes_little_endian();
+
+        if (!source)
+            return true;
+
+        chain::block block;
+
+        if (!block.from_data(source.read_bytes(size)))
+        {
+            std::cerr << format(BS_BENCH_PARSE_FAIL) % out_blocks.size();
+            return false;
+        }
+
+        out_blocks.push_back(std::make_shared<const message::block>(
+            std::move(block)));
+    }
+}
+
+void report(std::ostream& out, const std::string& name,
+    const histogram& values)
+{
+    const auto copy = values.get();
+    const auto mean = copy.count == 0 ? 0.0 :
+        static_cast<double>(copy.sum) / copy.count;
+
+    out << format(BS_BENCH_HISTOGRAM) % name % copy.count % mean %
+        copy.percentile(0.5) % copy.percentile(0.99) % copy.maximum;
+}
+
+void report(std::ostream& out, const chain_metrics& metrics)
+{
+    out << "Stage latency (microseconds):\n";
+    report(out, "check", metrics.check);
+    report(out, "populate", metrics.populate);
+    report(out, "accept", metrics.accept);
+    report(out, "connect", metrics.connect);
+    report(out, "store", metrics.store);
+    report(out, "notify", metrics.notify);
+    out << "Per block:\n";
+    report(out, "inputs", metrics.inputs);
+    report(out, "cache hits %", metrics.cache_hits);
+    out << "Per read:\n";
+    report(out, "read attempts", metrics.read_attempts);
+    out << "Per organizer lock:\n";
+    report(out, "block wait", metrics.block_lock);
+    report(out, "tx wait", metrics.transaction_lock);
+}
+
+} // namespace bench
+} // namespace libbitcoin
+
+using namespace bc;
+
+int main(int argc, char** argv)
+{
+    const bench::arguments args(argv + std::min(argc, 2), argv + argc);
+    const std::string mode(argc > 1 ? argv[1] : "");
+
+    if (mode == "record")
+        return bench::record(args);
+
+    if (mode == "blocks")
+        return bench::blocks(args);
+
+    if (mode == "transactions")
+        return bench::transactions(args);
+
+    if (mode == "queries")
+        return bench::queries(args);
+
+    std::cerr << BS_BENCH_USAGE;
+    return -1;
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_BENCH_HPP
+#define LIBBITCOIN_BLOCKCHAIN_BENCH_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/database.hpp>
+
+namespace libbitcoin {
+namespace bench {
+
+typedef std::vector<std::string> arguments;
+
+/// The settings for a mainnet chain with its store at the directory.
+struct environment
+{
+    environment(const boost::filesystem::path& directory);
+
+    blockchain::settings chain_settings;
+    database::settings database_settings;
+};
+
+/// The seconds elapsed from start to end.
+double seconds(const asio::time_point& start, const asio::time_point& end);
+
+/// Read the blocks of a file written by record (a sequence of blocks, each a
+/// 4 byte size and wire serialization).
+bool read_blocks(const std::string& file, block_const_ptr_list& out_blocks);
+
+/// Write the count, mean, p50, p99 and maximum of the histogram.
+void report(std::ostream& out, const std::string& name,
+    const blockchain::histogram& values);
+
+/// Write the stage histograms of the chain metrics.
+void report(std::ostream& out, const blockchain::chain_metrics& metrics);
+
+/// Write a recorded range of blocks from a store to a file.
+int record(const arguments& args);
+
+/// Replay a recorded range of blocks into a store through organize.
+int blocks(const arguments& args);
+
+/// Flood recorded transactions into a store through organize from threads.
+int transactions(const arguments& args);
+
+/// Sweep mixed fetch queries over thread counts, optionally under writes.
+int queries(const arguments& args);
+
+} // namespace bench
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bench.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_BENCH_OPEN_FAIL \
+    "Failed to start the store at %1%.\n"
+#define BS_BENCH_FILE_FAIL \
+    "Failed to open the file %1%.\n"
+#define BS_BENCH_FETCH_FAIL \
+    "Failed to fetch block %1% with error, '%2%'.\n"
+#define BS_BENCH_ORGANIZE_FAIL \
+    "Failed to organize block %1% with error, '%2%'.\n"
+#define BS_BENCH_RECORDED \
+    "Recorded %1% blocks to %2%.\n"
+#define BS_BENCH_REPLAYED \
+    "Replayed %1% blocks (%2% inputs) in %3$.3f seconds, " \
+    "%4$.1f blocks/s, %5$.1f inputs/s.\n"
+
+namespace libbitcoin {
+namespace bench {
+
+using namespace bc::blockchain;
+using boost::format;
+
+// The file is a sequence of blocks, each a 4 byte size and wire serialization.
+// A range recorded from a synchronized store is replayed into a store that is
+// synchronized to below the first recorded block (e.g. a copy of the same).
+
+int record(const arguments& args)
+{
+    if (args.size() != 4)
+        return -1;
+
+    const auto& store = args[0];
+    const auto from = boost::lexical_cast<size_t>(args[1]);
+    const auto to = boost::lexical_cast<size_t>(args[2]);
+    const auto& file = args[3];
+
+    threadpool pool(1);
+    const environment settings(store);
+    block_chain chain(pool, settings.chain_settings,
+        settings.database_settings);
+
+    if (!chain.start())
+    {
+        std::cerr << format(BS_BENCH_OPEN_FAIL) % store;
+        return -1;
+    }
+
+    bc::ofstream out(file, std::ofstream::binary);
+
+    if (!out)
+    {
+        std::cerr << format(BS_BENCH_FILE_FAIL) % file;
+        return -1;
+    }
+
+    ostream_writer sink(out);
+
+    for (auto height = from; height <= to; ++height)
+    {
+        std::promise<block_const_ptr> promise;
+
+        const auto handler = [&](const code& ec, block_const_ptr block, size_t)
+        {
+            if (ec)
+                std::cerr << format(BS_BENCH_FETCH_FAIL) % height %
+                    ec.message();
+
+            promise.set_value(ec ? nullptr : block);
+        };
+
+        chain.fetch_block(height, handler);
+        const auto block = promise.get_future().get();
+
+        if (!block)
+            return -1;
+
+        const auto data = block->to_data();
+        sink.write_4_bytes_little_endian(static_cast<uint32_t>(data.size()));
+        sink.write_bytes(data);
+    }
+
+    std::cout << format(BS_BENCH_RECORDED) % (to - from + 1u) % file;
+    return chain.close() ? 0 : -1;
+}
+
+int blocks(const arguments& args)
+{
+    if (args.size() < 2 || args.size() > 3)
+        return -1;
+
+    const auto& store = args[0];
+    const auto& file = args[1];
+
+    threadpool pool(1);
+    environment settings(store);
+    settings.chain_settings.pipeline_blocks = args.size() == 3 &&
+        args[2] == "--pipeline";
+
+    block_chain chain(pool, settings.chain_settings,
+        settings.database_settings);
+
+    if (!chain.start())
+    {
+        std::cerr << format(BS_BENCH_OPEN_FAIL) % store;
+        return -1;
+    }
+
+    // Parse before timing, so that only organization is measured.
+    block_const_ptr_list blocks;
+
+    if (!read_blocks(file, blocks))
+        return -1;
+
+    size_t count = 0;
+    size_t inputs = 0;
+
+    for (const auto block: blocks)
+        inputs += block->total_inputs();
+
+    chain.metrics().reset();
+    const auto start = asio::steady_clock::now();
+
+    for (const auto block: blocks)
+    {
+        std::promise<code> promise;
+
+        const auto handler = [&promise](const code& ec)
+        {
+            promise.set_value(ec);
+        };
+
+        chain.organize(block, handler);
+        const auto ec = promise.get_future().get();
+
+        if (ec)
+        {
+            std::cerr << format(BS_BENCH_ORGANIZE_FAIL) % count %
+                ec.message();
+            return -1;
+        }
+
+        ++count;
+    }
+
+    // Closing settles any pipelined commit, so it is included in the time.
+    const auto closed = chain.close();
+    const auto elapsed = seconds(start, asio::steady_clock::now());
+    const auto rate = [elapsed](size_t value)
+    {
+        return elapsed == 0.0 ? 0.0 : value / elapsed;
+    };
+
+    std::cout << format(BS_BENCH_REPLAYED) % count % inputs % elapsed %
+        rate(count) % rate(inputs);
+
+    report(std::cout, chain.metrics());
+    return closed ? 0 : -1;
+}
+
+} // namespace bench
+} // namespace libbitcoin
@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_BENCH_OPEN_FAIL \
+    "Failed to start the store at %1%.\n"
+#define BS_BENCH_SAMPLE_FAIL \
+    "Failed to sample the store with error, '%1%'.\n"
+#define BS_BENCH_SWEPT \
+    "Threads %1%, %2% queries in %3$.3f seconds, %4$.1f queries/s, " \
+    "%5% blocks written.\n"
+#define BS_BENCH_THROUGHPUT \
+    "%1$-14s %2$10.1f queries/s\n"
+
+namespace libbitcoin {
+namespace bench {
+
+using namespace bc::blockchain;
+using boost::format;
+
+// The workload is a round robin of the wallet backend queries, each against a
+// random sample of the populated store. A block file written by record may be
+// organized concurrently, so that reads collide with writes and exercise the
+// read_serial retry path. The file is written once, spanning the sweeps.
+
+enum query
+{
+    history,
+    transaction,
+    header,
+    locator,
+    spend,
+    queries_count
+};
+
+static const std::string query_names[queries_count] =
+{
+    "history",
+    "transaction",
+    "header",
+    "locator",
+    "spend"
+};
+
+struct sample
+{
+    size_t height;
+    hash_digest block_hash;
+    hash_digest tx_hash;
+    wallet::payment_address address;
+};
+
+static const size_t sample_count = 1024;
+static const size_t history_limit = 100;
+static const size_t locator_limit = 2000;
+
+static code get_samples(const block_chain& chain,
+    std::vector<sample>& out_samples)
+{
+    size_t top;
+
+    if (!chain.get_last_height(top) || top == 0)
+        return error::not_found;
+
+    std::mt19937 random;
+    out_samples.reserve(sample_count);
+
+    for (size_t index = 0; index < sample_count; ++index)
+    {
+        const auto height = 1u + random() % top;
+        std::promise<code> promise;
+        block_const_ptr block;
+
+        const auto handler = [&](const code& ec, block_ptr result, size_t)
+        {
+            block = result;
+            promise.set_value(ec);
+        };
+
+        chain.fetch_block(height, handler);
+        const auto ec = promise.get_future().get();
+
+        if (ec)
+            return ec;
+
+        const auto& txs = block->transactions();
+        const auto& tx = txs[random() % txs.size()];
+        const auto& outputs = tx.outputs();
+        const auto address = outputs.empty() ? wallet::payment_address{} :
+            wallet::payment_address::extract(outputs.front().script());
+
+        out_samples.push_back({ height, block->hash(), tx.hash(), address });
+    }
+
+    return error::success;
+}
+
+// Each query blocks until its handler is invoked.
+static void execute(const block_chain& chain, query api, const sample& item)
+{
+    std::promise<void> promise;
+
+    switch (api)
+    {
+        case query::history:
+        {
+            chain.fetch_history(item.address, history_limit, 0,
+                [&](const code&, const chain::history_compact::list&)
+                {
+                    promise.set_value();
+                });
+            break;
+        }
+        case query::transaction:
+        {
+            chain.fetch_transaction(item.tx_hash, true,
+                [&](const code&, transaction_ptr, size_t, size_t)
+                {
+                    promise.set_value();
+                });
+            break;
+        }
+        case query::header:
+        {
+            chain.fetch_block_header(item.height,
+                [&](const code&, header_ptr, size_t)
+                {
+                    promise.set_value();
+                });
+            break;
+        }
+        case query::locator:
+        {
+            const auto locator = std::make_shared<const message::get_headers>(
+                hash_list{ item.block_hash }, null_hash);
+
+            chain.fetch_locator_block_headers(locator, null_hash,
+                locator_limit, [&](const code&, headers_ptr)
+                {
+                    promise.set_value();
+                });
+            break;
+        }
+        case query::spend:
+        {
+            chain.fetch_spend({ item.tx_hash, 0 },
+                [&](const code&, const chain::input_point&)
+                {
+                    promise.set_value();
+                });
+            break;
+        }
+        default:
+        {
+            promise.set_value();
+        }
+    }
+
+    promise.get_future().wait();
+}
+
+static void sweep(const block_chain& chain, const std::vector<sample>& items,
+    size_t threads, size_t count, const std::atomic<size_t>& written)
+{
+    histogram latencies[queries_count];
+    std::vector<std::thread> readers;
+
+    const auto read = [&](size_t seed)
+    {
+        std::mt19937 random(static_cast<uint32_t>(seed));
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto api = static_cast<query>(index % queries_count);
+            const auto& item = items[random() % items.size()];
+            const auto start = asio::steady_clock::now();
+            execute(chain, api, item);
+            latencies[api].record(start, asio::steady_clock::now());
+        }
+    };
+
+    chain.metrics().read_attempts.reset();
+    const size_t written_start = written;
+    const auto start = asio::steady_clock::now();
+
+    for (size_t thread = 0; thread < threads; ++thread)
+        readers.emplace_back(read, thread);
+
+    for (auto& reader: readers)
+        reader.join();
+
+    const auto elapsed = seconds(start, asio::steady_clock::now());
+    const auto rate = [elapsed](uint64_t value)
+    {
+        return elapsed == 0.0 ? 0.0 : value / elapsed;
+    };
+
+    const auto total = threads * count;
+    std::cout << format(BS_BENCH_SWEPT) % threads % total % elapsed %
+        rate(total) % (written - written_start);
+
+    std::cout << "Query latency (microseconds):\n";
+
+    for (size_t api = 0; api < queries_count; ++api)
+        report(std::cout, query_names[api], latencies[api]);
+
+    for (size_t api = 0; api < queries_count; ++api)
+        std::cout << format(BS_BENCH_THROUGHPUT) % query_names[api] %
+            rate(latencies[api].get().count);
+
+    report(std::cout, "read attempts", chain.metrics().read_attempts);
+}
+
+int queries(const arguments& args)
+{
+    if (args.size() < 3 || args.size() > 4)
+        return -1;
+
+    const auto& store = args[0];
+    arguments counts;
+    boost::split(counts, args[1], boost::is_any_of(","));
+    const auto count = boost::lexical_cast<size_t>(args[2]);
+
+    // Parse before sweeping, so that the writer is not paced by parsing.
+    block_const_ptr_list blocks;
+
+    if (args.size() == 4 && !read_blocks(args[3], blocks))
+        return -1;
+
+    threadpool pool(1);
+    const environment settings(store);
+    block_chain chain(pool, settings.chain_settings,
+        settings.database_settings);
+
+    if (!chain.start())
+    {
+        std::cerr << format(BS_BENCH_OPEN_FAIL) % store;
+        return -1;
+    }
+
+    std::vector<sample> samples;
+    const auto ec = get_samples(chain, samples);
+
+    if (ec)
+    {
+        std::cerr << format(BS_BENCH_SAMPLE_FAIL) % ec.message();
+        return -1;
+    }
+
+    std::atomic<bool> finished(false);
+    std::atomic<size_t> written(0);
+
+    // Organize in order until the file is exhausted or the sweeps finish.
+    std::thread writer([&]()
+    {
+        for (const auto block: blocks)
+        {
+            if (finished)
+                break;
+
+            std::promise<code> promise;
+
+            const auto handler = [&promise](const code& ec)
+            {
+                promise.set_value(ec);
+            };
+
+            chain.organize(block, handler);
+
+            if (promise.get_future().get())
+                break;
+
+            ++written;
+        }
+    });
+
+    for (const auto& threads: counts)
+        sweep(chain, samples, boost::lexical_cast<size_t>(threads), count,
+            written);
+
+    finished = true;
+    writer.join();
+    return chain.close() ? 0 : -1;
+}
+
+} // namespace bench
+} // namespace libbitcoin
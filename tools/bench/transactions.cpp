@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/database.hpp>
+
+#define BS_BENCH_OPEN_FAIL \
+    "Failed to start the store at %1%.\n"
+#define BS_BENCH_FLOODED \
+    "Accepted %1% of %2% transactions (%3% dependent) on %4% threads " \
+    "in %5$.3f seconds, %6$.1f accepted/s.\n"
+
+namespace libbitcoin {
+namespace bench {
+
+using namespace bc::blockchain;
+using boost::format;
+
+typedef std::vector<transaction_const_ptr> lane;
+
+// The load is the non-coinbase txs of a file written by record, submitted to
+// a store that is synchronized to below the first recorded block. So the txs
+// are unconfirmed and spend either store outputs (independent) or outputs of
+// prior txs of the file (dependent). A dependent tx is queued on the lane of
+// its first recorded parent, so that in-lane order satisfies that parent. A tx
+// with parents on more than one lane may race them and be rejected as orphan.
+
+static bool load(const std::string& file, std::vector<lane>& lanes,
+    bool independent, size_t& dependent)
+{
+    block_const_ptr_list blocks;
+
+    if (!read_blocks(file, blocks))
+        return false;
+
+    std::unordered_map<hash_digest, size_t> lane_of;
+    size_t next = 0;
+    dependent = 0;
+
+    for (const auto block: blocks)
+    {
+        const auto& txs = block->transactions();
+
+        if (txs.empty())
+            continue;
+
+        for (auto tx = txs.begin() + 1; tx != txs.end(); ++tx)
+        {
+            auto index = lanes.size();
+
+            for (const auto& input: tx->inputs())
+            {
+                const auto it = lane_of.find(input.previous_output().hash());
+
+                if (it != lane_of.end())
+                {
+                    index = it->second;
+                    break;
+                }
+            }
+
+            const auto parented = index != lanes.size();
+
+            // A dropped tx is recorded so that its descendants are dropped.
+            if (parented && independent)
+            {
+                lane_of.emplace(tx->hash(), index);
+                continue;
+            }
+
+            if (parented)
+                ++dependent;
+            else
+                index = next++ % lanes.size();
+
+            lane_of.emplace(tx->hash(), index);
+            lanes[index].push_back(
+                std::make_shared<const message::transaction>(*tx));
+        }
+    }
+
+    return true;
+}
+
+int transactions(const arguments& args)
+{
+    if (args.size() < 3 || args.size() > 5)
+        return -1;
+
+    const auto& store = args[0];
+    const auto& file = args[1];
+    const auto threads = boost::lexical_cast<size_t>(args[2]);
+    const arguments options(args.begin() + 3, args.end());
+    const auto option = [&options](const std::string& name)
+    {
+        return std::find(options.begin(), options.end(), name) !=
+            options.end();
+    };
+
+    if (threads == 0)
+        return -1;
+
+    std::vector<lane> lanes(threads);
+    size_t dependent;
+
+    // Parse before timing, so that only organization is measured.
+    if (!load(file, lanes, option("--independent"), dependent))
+        return -1;
+
+    threadpool pool(1);
+    environment settings(store);
+    settings.chain_settings.concurrent_transactions = option("--concurrent");
+
+    block_chain chain(pool, settings.chain_settings,
+        settings.database_settings);
+
+    if (!chain.start())
+    {
+        std::cerr << format(BS_BENCH_OPEN_FAIL) % store;
+        return -1;
+    }
+
+    histogram latency;
+    std::atomic<size_t> accepted(0);
+    std::vector<std::thread> floods;
+
+    const auto flood = [&](const lane& txs)
+    {
+        for (const auto tx: txs)
+        {
+            std::promise<code> promise;
+
+            const auto handler = [&promise](const code& ec)
+            {
+                promise.set_value(ec);
+            };
+
+            const auto start = asio::steady_clock::now();
+            chain.organize(tx, handler);
+            const auto ec = promise.get_future().get();
+            latency.record(start, asio::steady_clock::now());
+
+            if (!ec)
+                ++accepted;
+        }
+    };
+
+    chain.metrics().reset();
+    const auto start = asio::steady_clock::now();
+
+    for (const auto& txs: lanes)
+        floods.emplace_back(flood, std::cref(txs));
+
+    for (auto& thread: floods)
+        thread.join();
+
+    const auto elapsed = seconds(start, asio::steady_clock::now());
+    const auto total = latency.get().count;
+    const size_t count = accepted;
+    const auto rate = elapsed == 0.0 ? 0.0 : count / elapsed;
+
+    std::cout << format(BS_BENCH_FLOODED) % count % total % dependent %
+        threads % elapsed % rate;
+
+    std::cout << "Transaction latency (microseconds):\n";
+    report(std::cout, "organize", latency);
+    report(std::cout, "lock wait", chain.metrics().transaction_lock);
+    return chain.close() ? 0 : -1;
+}
+
+} // namespace bench
+} // namespace libbitcoin